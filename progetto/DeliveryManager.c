@@ -1,55 +1,86 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L     // pthread_rwlock_t
+#endif
+
 #include "DeliveryManager.h"
-#include "dynamic_array.h"
+#include "typed_array.h"
 #include "weighted_directed_graph.h"
+#include "versioned_graph.h"
+#include "route_coalescer.h"
+#include "hash_index.h"
+#include "string_pool.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 
+#define ITERAZIONI_BILANCIAMENTO 30 // Iterazioni massime dell'assegnazione del traffico
+
+// Array specializzati per le entità gestite, con accesso diretto agli elementi
+DA_DEFINE(Missione)
+DA_DEFINE(Carico)
+DA_DEFINE(Veicolo)
+DA_DEFINE(ZonaLogistica)
+DA_DEFINE(CentroSmistamento)
+
+// Voce dell'indice dei nomi: lo stesso nome può indicare un punto di consegna, un centro di smistamento o entrambi
+struct Luogo {
+    const char* nome;               // Nome internato, usato come chiave dell'indice
+    PuntoConsegna punto;
+    CentroSmistamento centro;
+};
+typedef struct Luogo* Luogo;
+DA_DEFINE(Luogo)
+
+// Entità che occupa un nodo del grafo
+typedef enum {
+    NODO_SCONOSCIUTO = 0,
+    NODO_PUNTO_CONSEGNA,
+    NODO_CENTRO_SMISTAMENTO
+} TipoNodo;
+
+typedef struct {
+    TipoNodo tipo;
+    union {
+        PuntoConsegna punto;
+        CentroSmistamento centro;
+    };
+    int indice_zona;                // Posizione della zona logistica del punto (-1 per i centri)
+} EntitaNodo;
+DA_DEFINE(EntitaNodo)
+
 // Struttura interna del DeliveryManager
 struct DeliveryManager {
-    weighted_direct_graph area_metropolitana;
-    dynamic_array missioni;      
-    dynamic_array carichi;        
-    dynamic_array veicoli;         
-    dynamic_array zone_logistiche; 
-    dynamic_array centri_smistamento; 
+    versioned_graph area_metropolitana; // Rete stradale: i lettori usano versioni pubblicate, le modifiche passano da una bozza
+    weighted_direct_graph bozza_rete;   // Bozza del blocco di modifiche aperto con apriModificheRete (NULL se nessuno)
+    pthread_rwlock_t indici_lock;       // Protegge indici dei nomi e dei nodi: letture dei percorsi contro modifiche alla rete
+    route_coalescer percorsi_in_corso;  // Unisce le richieste contemporanee dello stesso percorso
+    Missione_array missioni;        // Ordinate per id: gli id crescono a ogni inserimento
+    Carico_array carichi;           // Ordinati per id, come le missioni
+    Veicolo_array veicoli;         
+    ZonaLogistica_array zone_logistiche; 
+    CentroSmistamento_array centri_smistamento; 
+    Missione_array missioni_per_id; // Tabella diretta: posizione id - 1, NULL se l'id non è (più) in uso
+    Carico_array carichi_per_id;    // Come missioni_per_id, per i carichi
+    hash_index veicoli_per_targa;   // Targa -> veicolo, per ricerche e controllo dei duplicati in tempo costante
+    hash_index luoghi_per_nome;     // Nome -> Luogo, per punti di consegna e centri di smistamento
+    Luogo_array luoghi;             // Voci dell'indice dei nomi, possedute dal manager
+    Luogo_array luoghi_ordinati;    // Luoghi con un punto o un centro, in ordine di nome: ricerca per prefisso
+    EntitaNodo_array entita_per_nodo; // Indice inverso: posizione = id del nodo del grafo
+    string_pool stringhe;           // Nomi, targhe e note internati: stringhe uguali hanno lo stesso indirizzo
     int next_carico_id;
     int next_missione_id;
+    double durata_totale_missioni;  // Somma delle durate delle missioni concluse (per le stime di attesa)
+    int num_missioni_concluse;
 };
 
 // Funzioni di supporto per confronti
-static int compare_veicoli_by_targa(const void* a, const void* b) {
-    Veicolo v1 = *(Veicolo*)a;
-    Veicolo v2 = *(Veicolo*)b;
-    return strcmp(veicolo_get_targa(v1), veicolo_get_targa(v2));
-}
-
-static int compare_carichi_by_id(const void* a, const void* b) {
-    Carico c1 = *(Carico*)a;
-    Carico c2 = *(Carico*)b;
-    int id1 = carico_get_id(c1);
-    int id2 = carico_get_id(c2);
-    return (id1 > id2) - (id1 < id2);
-}
-
-static int compare_missioni_by_id(const void* a, const void* b) {
-    Missione m1 = *(Missione*)a;
-    Missione m2 = *(Missione*)b;
-    int id1 = missione_get_id(m1);
-    int id2 = missione_get_id(m2);
-    return (id1 > id2) - (id1 < id2);
-}
-
-static int compare_zone_by_nome(const void* a, const void* b) {
-    ZonaLogistica z1 = *(ZonaLogistica*)a;
-    ZonaLogistica z2 = *(ZonaLogistica*)b;
-    return strcmp(zona_logistica_get_nome(z1), zona_logistica_get_nome(z2));
+static int compare_nomi(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
 }
 
-static int compare_centri_by_nome(const void* a, const void* b) {
-    CentroSmistamento c1 = *(CentroSmistamento*)a;
-    CentroSmistamento c2 = *(CentroSmistamento*)b;
-    return strcmp(centro_smistamento_get_nome(c1), centro_smistamento_get_nome(c2));
+static int compare_luoghi_by_nome(const void* a, const void* b) {
+    return strcmp((*(const Luogo*)a)->nome, (*(const Luogo*)b)->nome);
 }
 
 // F0. Creare un nuovo gestore della rete logistica
@@ -57,18 +88,34 @@ DeliveryManager createManager() {
     DeliveryManager manager = malloc(sizeof(struct DeliveryManager));
     if (!manager) return NULL;
     
-    manager->area_metropolitana = weighted_direct_graph_create();
-    manager->missioni = dynamic_array_create(10, sizeof(Missione));
-    manager->carichi = dynamic_array_create(20, sizeof(Carico));
-    manager->veicoli = dynamic_array_create(10, sizeof(Veicolo));
-    manager->zone_logistiche = dynamic_array_create(5, sizeof(ZonaLogistica));
-    manager->centri_smistamento = dynamic_array_create(5, sizeof(CentroSmistamento));
+    if (pthread_rwlock_init(&manager->indici_lock, NULL) != 0) {
+        free(manager);
+        return NULL;
+    }
+    manager->bozza_rete = NULL;
+    manager->area_metropolitana = versioned_graph_create(weighted_direct_graph_create());
+    manager->percorsi_in_corso = route_coalescer_create(manager->area_metropolitana);
+    int esito_array = Missione_array_init(&manager->missioni, 10);
+    esito_array |= Carico_array_init(&manager->carichi, 20);
+    esito_array |= Veicolo_array_init(&manager->veicoli, 10);
+    esito_array |= ZonaLogistica_array_init(&manager->zone_logistiche, 5);
+    esito_array |= CentroSmistamento_array_init(&manager->centri_smistamento, 5);
+    esito_array |= Missione_array_init(&manager->missioni_per_id, 10);
+    esito_array |= Carico_array_init(&manager->carichi_per_id, 20);
+    esito_array |= Luogo_array_init(&manager->luoghi, 10);
+    esito_array |= Luogo_array_init(&manager->luoghi_ordinati, 10);
+    esito_array |= EntitaNodo_array_init(&manager->entita_per_nodo, 16);
+    manager->veicoli_per_targa = hash_index_create(10);
+    manager->luoghi_per_nome = hash_index_create(10);
+    manager->stringhe = string_pool_create(64);
     manager->next_carico_id = 1;
     manager->next_missione_id = 1;
+    manager->durata_totale_missioni = 0;
+    manager->num_missioni_concluse = 0;
     
     // Verifica che tutte le allocazioni siano riuscite
-    if (!manager->area_metropolitana || !manager->missioni || !manager->carichi || 
-        !manager->veicoli || !manager->zone_logistiche || !manager->centri_smistamento) {
+    if (!manager->area_metropolitana || !manager->percorsi_in_corso || esito_array != DYN_ARRAY_SUCCESS ||
+        !manager->veicoli_per_targa || !manager->luoghi_per_nome || !manager->stringhe) {
         destroyManager(&manager);
         return NULL;
     }
@@ -82,74 +129,183 @@ void destroyManager(DeliveryManager* _manager) {
     
     DeliveryManager manager = *_manager;
     
-    // Libera gli array dinamici
-    if (manager->veicoli) {
-        for (int i = 0; i < dynamic_array_size(manager->veicoli); i++) {
-            Veicolo* v = (Veicolo*)dynamic_array_get_at(manager->veicoli, i);
-            if (v && *v) veicolo_destroy(v);
-        }
-        dynamic_array_destroy(&manager->veicoli, NULL);
+    // Libera gli array delle entità
+    DA_FOR_EACH(Veicolo, v, &manager->veicoli) {
+        if (v && *v) veicolo_destroy(v);
     }
+    Veicolo_array_release(&manager->veicoli);
+    hash_index_destroy(&manager->veicoli_per_targa);
     
-    if (manager->carichi) {
-        for (int i = 0; i < dynamic_array_size(manager->carichi); i++) {
-            Carico* c = (Carico*)dynamic_array_get_at(manager->carichi, i);
-            if (c && *c) carico_destroy(c);
-        }
-        dynamic_array_destroy(&manager->carichi, NULL);
+    DA_FOR_EACH(Carico, c, &manager->carichi) {
+        if (c && *c) carico_destroy(c);
     }
+    Carico_array_release(&manager->carichi);
+    Carico_array_release(&manager->carichi_per_id);
     
-    if (manager->missioni) {
-        for (int i = 0; i < dynamic_array_size(manager->missioni); i++) {
-            Missione* m = (Missione*)dynamic_array_get_at(manager->missioni, i);
-            if (m && *m) missione_destroy(m);
-        }
-        dynamic_array_destroy(&manager->missioni, NULL);
+    DA_FOR_EACH(Missione, m, &manager->missioni) {
+        if (m && *m) missione_destroy(m);
     }
+    Missione_array_release(&manager->missioni);
+    Missione_array_release(&manager->missioni_per_id);
     
-    if (manager->zone_logistiche) {
-        for (int i = 0; i < dynamic_array_size(manager->zone_logistiche); i++) {
-            ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
-            if (z && *z) zona_logistica_destroy(z);
-        }
-        dynamic_array_destroy(&manager->zone_logistiche, NULL);
+    DA_FOR_EACH(ZonaLogistica, z, &manager->zone_logistiche) {
+        if (z && *z) zona_logistica_destroy(z);
     }
+    ZonaLogistica_array_release(&manager->zone_logistiche);
     
-    if (manager->centri_smistamento) {
-        for (int i = 0; i < dynamic_array_size(manager->centri_smistamento); i++) {
-            CentroSmistamento* c = (CentroSmistamento*)dynamic_array_get_at(manager->centri_smistamento, i);
-            if (c && *c) centro_smistamento_destroy(c);
-        }
-        dynamic_array_destroy(&manager->centri_smistamento, NULL);
+    DA_FOR_EACH(CentroSmistamento, c, &manager->centri_smistamento) {
+        if (c && *c) centro_smistamento_destroy(c);
     }
+    CentroSmistamento_array_release(&manager->centri_smistamento);
     
+    hash_index_destroy(&manager->luoghi_per_nome);
+    DA_FOR_EACH(Luogo, l, &manager->luoghi) {
+        free(*l);
+    }
+    Luogo_array_release(&manager->luoghi);
+    Luogo_array_release(&manager->luoghi_ordinati);
+    EntitaNodo_array_release(&manager->entita_per_nodo);
+    
+    // Le entità non possiedono i propri nomi: il pool si libera dopo di esse
+    string_pool_destroy(&manager->stringhe);
+    
+    route_coalescer_destroy(&manager->percorsi_in_corso);
     if (manager->area_metropolitana) {
-        weighted_direct_graph_destroy(&manager->area_metropolitana);
+        versioned_graph_destroy(&manager->area_metropolitana);
     }
+    pthread_rwlock_destroy(&manager->indici_lock);
     
     free(manager);
     *_manager = NULL;
 }
 
+// Funzione di utilità per trovare la voce di un nome nell'indice, creandola vuota se non esiste
+static Luogo luogo_per_nome(DeliveryManager manager, const char* nome) {
+    const char* nome_interno = string_pool_intern(manager->stringhe, nome);
+    if (!nome_interno) return NULL;
+    
+    Luogo luogo = (Luogo)hash_index_get(manager->luoghi_per_nome, nome_interno);
+    if (luogo) return luogo;
+    
+    luogo = malloc(sizeof(struct Luogo));
+    if (!luogo) return NULL;
+    
+    luogo->nome = nome_interno;
+    luogo->punto = NULL;
+    luogo->centro = NULL;
+    if (Luogo_array_append(&manager->luoghi, luogo) != DYN_ARRAY_SUCCESS) {
+        free(luogo);
+        return NULL;
+    }
+    
+    if (hash_index_put(manager->luoghi_per_nome, luogo->nome, luogo) != HASH_INDEX_SUCCESS) {
+        Luogo_array_remove_at(&manager->luoghi, Luogo_array_size(&manager->luoghi) - 1);
+        free(luogo);
+        return NULL;
+    }
+    
+    return luogo;
+}
+
+// Funzione di utilità per trovare la prima posizione dell'indice ordinato con nome non minore di _nome
+static int posizione_nome(DeliveryManager manager, const char* nome) {
+    int low = 0;
+    int high = Luogo_array_size(&manager->luoghi_ordinati);
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (strcmp(DA_AT(&manager->luoghi_ordinati, mid)->nome, nome) < 0) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+// Funzione di utilità per inserire nell'indice ordinato un luogo che sta per ricevere il primo punto o centro
+// (lo spazio va riservato prima di creare l'entità, così l'inserimento non può fallire)
+static void indicizza_luogo(DeliveryManager manager, Luogo luogo) {
+    if (luogo->punto || luogo->centro) return; // Nome già indicizzato
+    Luogo_array_insert_at(&manager->luoghi_ordinati, posizione_nome(manager, luogo->nome), luogo);
+}
+
+// Funzione di utilità per inserire nell'indice ordinato un gruppo di luoghi nuovi: vengono ordinati
+// tra loro e fusi con l'indice partendo dal fondo (lo spazio va riservato, come per indicizza_luogo)
+static void indicizza_luoghi(DeliveryManager manager, Luogo* nuovi, int num_nuovi) {
+    if (num_nuovi <= 0) return;
+    qsort(nuovi, num_nuovi, sizeof(Luogo), compare_luoghi_by_nome);
+    
+    int i = Luogo_array_size(&manager->luoghi_ordinati) - 1;
+    int j = num_nuovi - 1;
+    Luogo_array_resize(&manager->luoghi_ordinati, i + 1 + num_nuovi, NULL);
+    
+    Luogo* ordinati = manager->luoghi_ordinati.data;
+    for (int k = i + j + 1; j >= 0; k--) {
+        if (i >= 0 && strcmp(ordinati[i]->nome, nuovi[j]->nome) > 0) ordinati[k] = ordinati[i--];
+        else ordinati[k] = nuovi[j--];
+    }
+}
+
+// Funzione di utilità per garantire una posizione nell'indice inverso ai nodi fino a _num_nodi escluso
+static int riserva_entita_nodi(DeliveryManager manager, int num_nodi) {
+    if (num_nodi <= EntitaNodo_array_size(&manager->entita_per_nodo)) return 0;
+    
+    EntitaNodo vuota = { .tipo = NODO_SCONOSCIUTO, .punto = NULL, .indice_zona = -1 };
+    return EntitaNodo_array_resize(&manager->entita_per_nodo, num_nodi, vuota) == DYN_ARRAY_SUCCESS ? 0 : 1;
+}
+
+// Funzione di utilità per trovare l'entità associata a un nodo (NULL se il nodo non ne ha)
+static const EntitaNodo* entita_by_nodo(DeliveryManager manager, weighted_direct_graph_node_id nodo_id) {
+    if (nodo_id < 0 || nodo_id >= EntitaNodo_array_size(&manager->entita_per_nodo)) return NULL;
+    
+    const EntitaNodo* entita = &DA_AT(&manager->entita_per_nodo, nodo_id);
+    return (entita->tipo != NODO_SCONOSCIUTO) ? entita : NULL;
+}
+
+// Indica alla contrazione della rete i nodi da mantenere: tutti quelli di un punto di consegna o di un centro
+static bool is_nodo_terminale(weighted_direct_graph_node_id nodo_id, void* context) {
+    return entita_by_nodo((DeliveryManager)context, nodo_id) != NULL;
+}
+
+// Funzione di utilità per ottenere il grafo su cui applicare una modifica alla rete: la bozza
+// del blocco aperto con apriModificheRete oppure una nuova bozza, chiusa da termina_modifica
+static weighted_direct_graph inizia_modifica(DeliveryManager manager) {
+    if (manager->bozza_rete) return manager->bozza_rete;
+    return versioned_graph_begin_write(manager->area_metropolitana);
+}
+
+// Funzione di utilità per chiudere una modifica iniziata con inizia_modifica. Fuori da un blocco
+// la bozza viene pubblicata se la modifica è riuscita e scartata altrimenti; in un blocco resta
+// aperta fino a pubblicaModificheRete
+static void termina_modifica(DeliveryManager manager, bool riuscita) {
+    if (manager->bozza_rete) return;
+    
+    if (riuscita) versioned_graph_publish(manager->area_metropolitana);
+    else versioned_graph_abort(manager->area_metropolitana);
+}
+
+// Funzione di utilità per trovare la posizione di una zona logistica (-1 se non esiste)
+static int indice_zona(DeliveryManager manager, ZonaLogistica zona) {
+    DA_FOR_EACH(ZonaLogistica, z, &manager->zone_logistiche) {
+        if (*z == zona) return (int)(z - manager->zone_logistiche.data);
+    }
+    return -1;
+}
+
 // F1. Aggiungere una nuova zona logistica
 int createZonaLogistica(DeliveryManager manager, char* nome) {
     if (!manager || !nome) return 1;
     
     // Verifica che il nome non sia già presente
-    for (int i = 0; i < dynamic_array_size(manager->zone_logistiche); i++) {
-        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
-        if (z && *z && strcmp(zona_logistica_get_nome(*z), nome) == 0) {
-            return 2; // Nome già presente
-        }
-    }
+    if (getZonaLogisticaByNome(manager, nome)) return 2; // Nome già presente
+    
+    const char* nome_interno = string_pool_intern(manager->stringhe, nome);
+    if (!nome_interno) return 1;
     
     // Genera un ID per la zona logistica
-    int id = dynamic_array_size(manager->zone_logistiche) + 1;
+    int id = ZonaLogistica_array_size(&manager->zone_logistiche) + 1;
     
-    ZonaLogistica zona = zona_logistica_create(id, nome);
+    ZonaLogistica zona = zona_logistica_create(id, nome_interno);
     if (!zona) return 1;
     
-    if (dynamic_array_append(manager->zone_logistiche, &zona) != DYN_ARRAY_SUCCESS) {
+    if (ZonaLogistica_array_append(&manager->zone_logistiche, zona) != DYN_ARRAY_SUCCESS) {
         zona_logistica_destroy(&zona);
         return 3; // Non c'è più spazio
     }
@@ -162,31 +318,42 @@ int createPuntoConsegna(DeliveryManager manager, char* nome, int priorita, int o
     if (!manager || !nome || !zona_logistica_nome) return 1;
     
     // Trova la zona logistica
-    ZonaLogistica zona = NULL;
-    for (int i = 0; i < dynamic_array_size(manager->zone_logistiche); i++) {
-        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
-        if (z && *z && strcmp(zona_logistica_get_nome(*z), zona_logistica_nome) == 0) {
-            zona = *z;
-            break;
-        }
-    }
-    
+    ZonaLogistica zona = getZonaLogisticaByNome(manager, zona_logistica_nome);
     if (!zona) return 3; // Zona logistica non esiste
     
-    // Verifica che il nome del punto non sia già presente
-    PuntoConsegna punto_esistente = getPuntoConsegnaByNome(manager, nome);
-    if (punto_esistente) return 2; // Nome già presente
+    // Verifica che il nome del punto non sia già presente (solo le modifiche, serializzate,
+    // cambiano gli indici: qui possono essere letti senza lock)
+    Luogo esistente = (Luogo)hash_index_get(manager->luoghi_per_nome, nome);
+    if (esistente && esistente->punto) return 2; // Nome già presente
+    
+    // Crea un nodo nel grafo per il punto di consegna. In un blocco di modifiche, se la
+    // creazione fallisce più avanti, il nodo resta isolato e senza entità nella bozza
+    weighted_direct_graph rete = inizia_modifica(manager);
+    if (!rete) return 1;
     
-    // Crea un nodo nel grafo per il punto di consegna
-    weighted_direct_graph_node_id nodo_id = weighted_direct_graph_add_node(manager->area_metropolitana, 0, NULL);
-    if (nodo_id < 0) return 1;
+    weighted_direct_graph_node_id nodo_id = weighted_direct_graph_add_node(rete, 0, NULL);
+    if (nodo_id < 0) {
+        termina_modifica(manager, false);
+        return 1;
+    }
     
-    Node nodo = weighted_direct_graph_get_node(manager->area_metropolitana, nodo_id);
+    Node nodo = weighted_direct_graph_get_node(rete, nodo_id);
+    
+    // Prepara la voce dell'indice dei nomi (se la creazione fallisce resta vuota) e lo spazio
+    // negli indici: le riserve non cambiano ciò che trovano i lettori, ma spostano gli array
+    pthread_rwlock_wrlock(&manager->indici_lock);
+    Luogo luogo = luogo_per_nome(manager, nome);
+    bool riservato = luogo && riserva_entita_nodi(manager, nodo_id + 1) == 0 &&
+                     Luogo_array_reserve(&manager->luoghi_ordinati, Luogo_array_size(&manager->luoghi_ordinati) + 1) == DYN_ARRAY_SUCCESS;
+    pthread_rwlock_unlock(&manager->indici_lock);
+    if (!riservato) {
+        termina_modifica(manager, false);
+        return 1;
+    }
     
     // Genera un ID per il punto di consegna
     int id = 0;
-    for (int i = 0; i < dynamic_array_size(manager->zone_logistiche); i++) {
-        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
+    DA_FOR_EACH(ZonaLogistica, z, &manager->zone_logistiche) {
         if (z && *z) {
             id += zona_logistica_get_num_punti_consegna(*z);
         }
@@ -194,15 +361,33 @@ int createPuntoConsegna(DeliveryManager manager, char* nome, int priorita, int o
     id += 1;
     
     // Crea il punto di consegna
-    PuntoConsegna punto = punto_consegna_create(id, nome, priorita, orario, tipo, nodo, zona);
-    if (!punto) return 1;
+    PuntoConsegna punto = punto_consegna_create(id, luogo->nome, priorita, orario, tipo, nodo, zona);
+    if (!punto) {
+        termina_modifica(manager, false);
+        return 1;
+    }
     
     // Aggiunge il punto alla zona logistica
     if (zona_logistica_add_punto_consegna(zona, punto) != 0) {
         punto_consegna_destroy(&punto);
+        termina_modifica(manager, false);
         return 4; // Non c'è più spazio
     }
     
+    // Il nodo viene pubblicato prima di registrare il nome: un lettore che trova il punto
+    // trova anche il suo nodo nella versione corrente della rete
+    termina_modifica(manager, true);
+    
+    pthread_rwlock_wrlock(&manager->indici_lock);
+    indicizza_luogo(manager, luogo);
+    luogo->punto = punto;
+    
+    EntitaNodo* entita = &DA_AT(&manager->entita_per_nodo, nodo_id);
+    entita->tipo = NODO_PUNTO_CONSEGNA;
+    entita->punto = punto;
+    entita->indice_zona = indice_zona(manager, zona);
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
     return 0;
 }
 
@@ -211,30 +396,59 @@ int createCentroSmistamento(DeliveryManager manager, char* nome) {
     if (!manager || !nome) return 1;
     
     // Verifica che il nome non sia già presente
-    for (int i = 0; i < dynamic_array_size(manager->centri_smistamento); i++) {
-        CentroSmistamento* c = (CentroSmistamento*)dynamic_array_get_at(manager->centri_smistamento, i);
-        if (c && *c && strcmp(centro_smistamento_get_nome(*c), nome) == 0) {
-            return 2; // Nome già presente
-        }
+    Luogo esistente = (Luogo)hash_index_get(manager->luoghi_per_nome, nome);
+    if (esistente && esistente->centro) return 2; // Nome già presente
+    
+    // Crea un nodo nel grafo per il centro di smistamento, come per i punti di consegna
+    weighted_direct_graph rete = inizia_modifica(manager);
+    if (!rete) return 1;
+    
+    weighted_direct_graph_node_id nodo_id = weighted_direct_graph_add_node(rete, 0, NULL);
+    if (nodo_id < 0) {
+        termina_modifica(manager, false);
+        return 1;
     }
     
-    // Crea un nodo nel grafo per il centro di smistamento
-    weighted_direct_graph_node_id nodo_id = weighted_direct_graph_add_node(manager->area_metropolitana, 0, NULL);
-    if (nodo_id < 0) return 1;
+    Node nodo = weighted_direct_graph_get_node(rete, nodo_id);
     
-    Node nodo = weighted_direct_graph_get_node(manager->area_metropolitana, nodo_id);
+    pthread_rwlock_wrlock(&manager->indici_lock);
+    Luogo luogo = luogo_per_nome(manager, nome);
+    bool riservato = luogo && riserva_entita_nodi(manager, nodo_id + 1) == 0 &&
+                     Luogo_array_reserve(&manager->luoghi_ordinati, Luogo_array_size(&manager->luoghi_ordinati) + 1) == DYN_ARRAY_SUCCESS;
+    pthread_rwlock_unlock(&manager->indici_lock);
+    if (!riservato) {
+        termina_modifica(manager, false);
+        return 1;
+    }
     
     // Genera un ID per il centro di smistamento
-    int id = dynamic_array_size(manager->centri_smistamento) + 1;
+    int id = CentroSmistamento_array_size(&manager->centri_smistamento) + 1;
     
-    CentroSmistamento centro = centro_smistamento_create(id, nome, nodo);
-    if (!centro) return 1;
+    CentroSmistamento centro = centro_smistamento_create(id, luogo->nome, nodo);
+    if (!centro) {
+        termina_modifica(manager, false);
+        return 1;
+    }
     
-    if (dynamic_array_append(manager->centri_smistamento, &centro) != DYN_ARRAY_SUCCESS) {
+    if (CentroSmistamento_array_append(&manager->centri_smistamento, centro) != DYN_ARRAY_SUCCESS) {
         centro_smistamento_destroy(&centro);
+        termina_modifica(manager, false);
         return 3; // Non c'è più spazio
     }
     
+    // Come per i punti, il nodo è pubblicato prima del nome
+    termina_modifica(manager, true);
+    
+    pthread_rwlock_wrlock(&manager->indici_lock);
+    indicizza_luogo(manager, luogo);
+    luogo->centro = centro;
+    
+    EntitaNodo* entita = &DA_AT(&manager->entita_per_nodo, nodo_id);
+    entita->tipo = NODO_CENTRO_SMISTAMENTO;
+    entita->centro = centro;
+    entita->indice_zona = -1;
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
     return 0;
 }
 
@@ -243,21 +457,28 @@ int createVeicolo(DeliveryManager manager, char* targa, int capacita) {
     if (!manager || !targa) return 1;
     
     // Verifica che la targa non sia già presente
-    for (int i = 0; i < dynamic_array_size(manager->veicoli); i++) {
-        Veicolo* v = (Veicolo*)dynamic_array_get_at(manager->veicoli, i);
-        if (v && *v && strcmp(veicolo_get_targa(*v), targa) == 0) {
-            return 2; // Targa già presente
-        }
+    if (hash_index_contains(manager->veicoli_per_targa, targa)) {
+        return 2; // Targa già presente
     }
     
-    Veicolo veicolo = veicolo_create(targa, capacita);
+    const char* targa_interna = string_pool_intern(manager->stringhe, targa);
+    if (!targa_interna) return 1;
+    
+    Veicolo veicolo = veicolo_create(targa_interna, capacita);
     if (!veicolo) return 1;
     
-    if (dynamic_array_append(manager->veicoli, &veicolo) != DYN_ARRAY_SUCCESS) {
+    if (Veicolo_array_append(&manager->veicoli, veicolo) != DYN_ARRAY_SUCCESS) {
         veicolo_destroy(&veicolo);
         return 3; // Non c'è più spazio
     }
     
+    // L'indice usa come chiave la targa internata
+    if (hash_index_put(manager->veicoli_per_targa, veicolo_get_targa(veicolo), veicolo) != HASH_INDEX_SUCCESS) {
+        Veicolo_array_remove_at(&manager->veicoli, Veicolo_array_size(&manager->veicoli) - 1);
+        veicolo_destroy(&veicolo);
+        return 3;
+    }
+    
     return 0;
 }
 
@@ -281,19 +502,23 @@ int insertCarico(DeliveryManager manager, int peso, TipoCarico tipologia, char*
     Carico carico = carico_create(manager->next_carico_id++, peso, tipologia, nodo_destinazione, priorita, nodo_centro);
     if (!carico) return 1;
     
-    // Aggiunge il carico al manager
-    if (dynamic_array_append(manager->carichi, &carico) != DYN_ARRAY_SUCCESS) {
+    // Aggiunge il carico al manager, riservandone la posizione nella tabella per id
+    if (Carico_array_resize(&manager->carichi_per_id, carico_get_id(carico), NULL) != DYN_ARRAY_SUCCESS ||
+        Carico_array_append(&manager->carichi, carico) != DYN_ARRAY_SUCCESS) {
         carico_destroy(&carico);
         return 4; // Non c'è più spazio
     }
     
-    // Aggiunge il carico alla coda del centro di smistamento
-    if (centro_smistamento_add_carico(centro, carico, priorita) != 0) {
+    // Aggiunge il carico alla coda del centro di smistamento, conservandone l'handle
+    bucket_queue_handle handle;
+    if (centro_smistamento_add_carico(centro, carico, priorita, &handle) != 0) {
         // Rimuove il carico dal manager se non può essere aggiunto al centro
-        dynamic_array_remove_at(manager->carichi, dynamic_array_size(manager->carichi) - 1, NULL);
+        Carico_array_remove_at(&manager->carichi, Carico_array_size(&manager->carichi) - 1);
         carico_destroy(&carico);
         return 1;
     }
+    carico_set_handle_coda(carico, handle);
+    DA_AT(&manager->carichi_per_id, carico_get_id(carico) - 1) = carico;
     
     return 0;
 }
@@ -323,6 +548,113 @@ int addVeicoloToCoda(DeliveryManager manager, char* targa, char* centro_smistame
     return 0;
 }
 
+// Funzione di utilità per trovare il centro di smistamento associato a un nodo
+static CentroSmistamento centro_by_nodo(DeliveryManager manager, Node nodo) {
+    if (!nodo) return NULL;
+    
+    const EntitaNodo* entita = entita_by_nodo(manager, weighted_direct_graph_get_node_id(nodo));
+    return (entita && entita->tipo == NODO_CENTRO_SMISTAMENTO) ? entita->centro : NULL;
+}
+
+// Annullare un carico in attesa
+int cancelCarico(DeliveryManager manager, int id_carico) {
+    if (!manager) return 1;
+    
+    // Trova il carico e la sua posizione nel gestore
+    int indice = Carico_array_find_key(&manager->carichi, carico_get_id, id_carico);
+    if (indice < 0) return 2; // Carico non esiste
+    
+    Carico carico = DA_AT(&manager->carichi, indice);
+    CentroSmistamento centro = centro_by_nodo(manager, carico_get_centro_smistamento(carico));
+    
+    // L'handle non è più valido se il carico è già stato estratto dalla coda
+    if (centro_smistamento_remove_carico(centro, carico_get_handle_coda(carico)) != 0) {
+        return 3;
+    }
+    
+    Carico_array_remove_at(&manager->carichi, indice);
+    DA_AT(&manager->carichi_per_id, id_carico - 1) = NULL;
+    carico_destroy(&carico);
+    return 0;
+}
+
+// Aumentare la priorità di un carico in attesa
+int escalateCarico(DeliveryManager manager, int id_carico, int priorita) {
+    if (!manager) return 1;
+    
+    Carico carico = getCaricoById(manager, id_carico);
+    if (!carico) return 2; // Carico non esiste
+    
+    CentroSmistamento centro = centro_by_nodo(manager, carico_get_centro_smistamento(carico));
+    bucket_queue_handle handle = carico_get_handle_coda(carico);
+    if (!centro_smistamento_contains_carico(centro, handle)) return 3;
+    
+    if (priorita > 5 || priorita <= carico_get_priorita(carico)) return 4;
+    
+    if (centro_smistamento_change_priorita_carico(centro, &handle, priorita) != 0) {
+        return 1;
+    }
+    carico_set_handle_coda(carico, handle);
+    carico_set_priorita(carico, priorita);
+    return 0;
+}
+
+// Funzione di utilità per aggiornare un carico spostato nella coda di un altro centro
+static void carico_trasferito(void* carico, bucket_queue_handle handle, void* nodo_centro) {
+    carico_set_centro_smistamento((Carico)carico, (Node)nodo_centro);
+    carico_set_handle_coda((Carico)carico, handle);
+}
+
+// Trasferire le code di un centro fuori servizio
+int transferBacklog(DeliveryManager manager, char* centro_origine, char* centro_destinazione) {
+    if (!manager || !centro_origine || !centro_destinazione) return 1;
+    
+    CentroSmistamento origine = getCentroSmistamentoByNome(manager, centro_origine);
+    if (!origine) return 2; // Centro da svuotare non esiste
+    
+    CentroSmistamento destinazione = getCentroSmistamentoByNome(manager, centro_destinazione);
+    if (!destinazione) return 3; // Centro di destinazione non esiste
+    
+    if (origine == destinazione) return 1;
+    
+    if (centro_smistamento_transfer_backlog(destinazione, origine, carico_trasferito, centro_smistamento_get_nodo(destinazione)) != 0) {
+        return 1;
+    }
+    return 0;
+}
+
+// Posizione di un carico nella coda del suo centro
+int getQueuePosition(DeliveryManager manager, int id_carico) {
+    if (!manager) return -1;
+    
+    Carico carico = getCaricoById(manager, id_carico);
+    if (!carico) return -1;
+    
+    CentroSmistamento centro = centro_by_nodo(manager, carico_get_centro_smistamento(carico));
+    return centro_smistamento_get_posizione_carico(centro, carico_get_handle_coda(carico));
+}
+
+// Stima dell'attesa di un carico in coda
+double getQueueETA(DeliveryManager manager, int id_carico) {
+    if (!manager) return -1;
+    
+    Carico carico = getCaricoById(manager, id_carico);
+    if (!carico) return -1;
+    
+    CentroSmistamento centro = centro_by_nodo(manager, carico_get_centro_smistamento(carico));
+    int posizione = centro_smistamento_get_posizione_carico(centro, carico_get_handle_coda(carico));
+    if (posizione < 0) return -1; // Carico non in coda
+    
+    if (manager->num_missioni_concluse == 0) return -2; // Nessuna missione da cui stimare i tempi
+    
+    // I veicoli in coda servono un carico ciascuno per turno, un turno dura una missione media
+    int veicoli = centro_smistamento_get_num_veicoli(centro);
+    if (veicoli < 1) veicoli = 1;
+    
+    double durata_media = manager->durata_totale_missioni / manager->num_missioni_concluse;
+    return (posizione / veicoli + 1) * durata_media;
+}
+
 // Assegnare una missione ad un veicolo
 int addTask(DeliveryManager manager, Veicolo veicolo, Carico carico) {
     if (!manager) return 1;
@@ -352,14 +684,17 @@ int addTask(DeliveryManager manager, Veicolo veicolo, Carico carico) {
         return 1;
     }
     
-    // Aggiunge la missione al manager
-    if (dynamic_array_append(manager->missioni, &missione) != DYN_ARRAY_SUCCESS) {
+    // Aggiunge la missione al manager, riservandone la posizione nella tabella per id
+    if (Missione_array_resize(&manager->missioni_per_id, missione_get_id(missione), NULL) != DYN_ARRAY_SUCCESS ||
+        Missione_array_append(&manager->missioni, missione) != DYN_ARRAY_SUCCESS) {
         veicolo_remove_carico(veicolo, carico);
         carico_set_missione(carico, NULL);
         missione_destroy(&missione);
         return 1;
     }
     
+    DA_AT(&manager->missioni_per_id, missione_get_id(missione) - 1) = missione;
+    
     // Imposta il veicolo come in viaggio
     veicolo_set_stato_operativo(veicolo, STATO_IN_VIAGGIO);
     
@@ -389,7 +724,10 @@ Missione addAutoTask(DeliveryManager manager, char* centro_smistamento_nome) {
     // Verifica compatibilità di peso
     if (carico_get_peso(carico) > veicolo_get_capacita(veicolo)) {
         // Rimette il carico in coda se non compatibile
-        centro_smistamento_add_carico(centro, carico, carico_get_priorita(carico));
+        bucket_queue_handle handle;
+        if (centro_smistamento_add_carico(centro, carico, carico_get_priorita(carico), &handle) == 0) {
+            carico_set_handle_coda(carico, handle);
+        }
         return NULL;
     }
     
@@ -416,14 +754,17 @@ Missione addAutoTask(DeliveryManager manager, char* centro_smistamento_nome) {
         return NULL;
     }
     
-    // Aggiunge la missione al manager
-    if (dynamic_array_append(manager->missioni, &missione) != DYN_ARRAY_SUCCESS) {
+    // Aggiunge la missione al manager, riservandone la posizione nella tabella per id
+    if (Missione_array_resize(&manager->missioni_per_id, missione_get_id(missione), NULL) != DYN_ARRAY_SUCCESS ||
+        Missione_array_append(&manager->missioni, missione) != DYN_ARRAY_SUCCESS) {
         veicolo_remove_carico(veicolo, carico);
         carico_set_missione(carico, NULL);
         missione_destroy(&missione);
         return NULL;
     }
     
+    DA_AT(&manager->missioni_per_id, missione_get_id(missione) - 1) = missione;
+    
     // Imposta il veicolo come in viaggio
     veicolo_set_stato_operativo(veicolo, STATO_IN_VIAGGIO);
     
@@ -441,17 +782,31 @@ int registraEsitoMissione(DeliveryManager manager, int id_missione, StatoMission
     Missione missione = getMissioneById(manager, id_missione);
     if (!missione) return 2; // Missione non esiste
     
+    // Le note ricorrenti condividono un'unica copia nel pool
+    const char* nota_interna = NULL;
+    if (nota) {
+        nota_interna = string_pool_intern(manager->stringhe, nota);
+        if (!nota_interna) return 1;
+    }
+    
     // Imposta lo stato della missione
     missione_set_stato(missione, stato);
     
     // Aggiunge la nota se fornita
-    if (nota) {
-        missione_set_nota(missione, nota);
+    if (nota_interna) {
+        missione_set_nota(missione, nota_interna);
     }
     
-    // Imposta data fine missione
+    // Imposta data fine missione, contando la durata solo alla prima registrazione dell'esito
+    bool prima_registrazione = missione_get_data_fine(missione) == 0;
     missione_set_data_fine(missione, time(NULL));
     
+    double durata = missione_get_durata(missione);
+    if (prima_registrazione && durata >= 0) {
+        manager->durata_totale_missioni += durata;
+        manager->num_missioni_concluse++;
+    }
+    
     // Libera il veicolo
     Veicolo veicolo = missione_get_veicolo(missione);
     if (veicolo) {
@@ -496,7 +851,7 @@ void getStatistics(DeliveryManager manager) {
     if (consegne) {
         printf("\nConsegne per zona logistica:\n");
         for (int i = 0; i < getNumZoneLogistiche(manager); i++) {
-            ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
+            ZonaLogistica* z = &DA_AT(&manager->zone_logistiche, i);
             if (z && *z) {
                 printf("- %s: %d consegne\n", zona_logistica_get_nome(*z), consegne[i]);
             }
@@ -521,8 +876,7 @@ double* getTempiMediPerTipologia(DeliveryManager manager) {
     }
     
     // Scorre tutte le missioni completate
-    for (int i = 0; i < dynamic_array_size(manager->missioni); i++) {
-        Missione* m = (Missione*)dynamic_array_get_at(manager->missioni, i);
+    DA_FOR_EACH(Missione, m, &manager->missioni) {
         if (m && *m && missione_get_stato(*m) == STATO_MISSIONE_COMPLETATA) {
             time_t inizio = missione_get_data_inizio(*m);
             time_t fine = missione_get_data_fine(*m);
@@ -560,7 +914,7 @@ double* getTempiMediPerTipologia(DeliveryManager manager) {
 double getCaricoMedioPerVeicolo(DeliveryManager manager) {
     if (!manager) return -1;
     
-    int num_veicoli = dynamic_array_size(manager->veicoli);
+    int num_veicoli = Veicolo_array_size(&manager->veicoli);
     if (num_veicoli == 0) return 0;
     
     double peso_totale = 0;
@@ -568,7 +922,7 @@ double getCaricoMedioPerVeicolo(DeliveryManager manager) {
     
     // Scorre tutti i veicoli
     for (int i = 0; i < num_veicoli; i++) {
-        Veicolo* v = (Veicolo*)dynamic_array_get_at(manager->veicoli, i);
+        Veicolo* v = &DA_AT(&manager->veicoli, i);
         if (v && *v) {
             // Per ogni carico nel veicolo
             for (int j = 0; j < veicolo_get_num_carichi(*v); j++) {
@@ -588,33 +942,23 @@ double getCaricoMedioPerVeicolo(DeliveryManager manager) {
 int* getNumConsegnePerZona(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int num_zone = dynamic_array_size(manager->zone_logistiche);
+    int num_zone = ZonaLogistica_array_size(&manager->zone_logistiche);
     int* consegne = calloc(num_zone, sizeof(int));
     
     if (!consegne) return NULL;
     
     // Scorre tutte le missioni completate
-    for (int i = 0; i < dynamic_array_size(manager->missioni); i++) {
-        Missione* m = (Missione*)dynamic_array_get_at(manager->missioni, i);
+    DA_FOR_EACH(Missione, m, &manager->missioni) {
         if (m && *m && missione_get_stato(*m) == STATO_MISSIONE_COMPLETATA) {
             // Per ogni carico nella missione
             for (int j = 0; j < missione_get_num_carichi(*m); j++) {
                 Carico carico = missione_get_carico(*m, j);
-                if (carico) {
-                    Node nodo_destinazione = carico_get_destinazione(carico);
-                    
-                    // Cerca il punto di consegna corrispondente al nodo
-                    for (int k = 0; k < num_zone; k++) {
-                        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, k);
-                        if (z && *z) {
-                            for (int l = 0; l < zona_logistica_get_num_punti_consegna(*z); l++) {
-                                PuntoConsegna punto = zona_logistica_get_punto_consegna(*z, l);
-                                if (punto && punto_consegna_get_nodo(punto) == nodo_destinazione) {
-                                    consegne[k]++;
-                                    break;
-                                }
-                            }
-                        }
+                Node nodo_destinazione = carico ? carico_get_destinazione(carico) : NULL;
+                if (nodo_destinazione) {
+                    // La zona del punto di consegna si ricava dall'indice inverso dei nodi
+                    const EntitaNodo* entita = entita_by_nodo(manager, weighted_direct_graph_get_node_id(nodo_destinazione));
+                    if (entita && entita->indice_zona >= 0 && entita->indice_zona < num_zone) {
+                        consegne[entita->indice_zona]++;
                     }
                 }
             }
@@ -625,71 +969,124 @@ int* getNumConsegnePerZona(DeliveryManager manager) {
 }
 
 // Ottenere il percorso più breve tra due punti
-char** getPercorsoBreve(DeliveryManager manager, char* partenza, char* arrivo) {
-    if (!manager || !partenza || !arrivo) return NULL;
-    
-    // Trova i punti di consegna
-    PuntoConsegna punto_partenza = getPuntoConsegnaByNome(manager, partenza);
-    PuntoConsegna punto_arrivo = getPuntoConsegnaByNome(manager, arrivo);
-    
-    if (!punto_partenza || !punto_arrivo) return NULL;
-    
-    // Ottieni i nodi del grafo
-    Node nodo_partenza = punto_consegna_get_nodo(punto_partenza);
-    Node nodo_arrivo = punto_consegna_get_nodo(punto_arrivo);
-    
-    if (!nodo_partenza || !nodo_arrivo) return NULL;
-    
-    // Calcola il percorso più breve
-    weighted_direct_graph_node_id id_partenza = weighted_direct_graph_get_node_id(nodo_partenza);
-    weighted_direct_graph_node_id id_arrivo = weighted_direct_graph_get_node_id(nodo_arrivo);
-    
-    linked_list percorso = weighted_direct_graph_shortest_path(manager->area_metropolitana, id_partenza, id_arrivo);
-    
-    if (!percorso) return NULL;
-    
-    // Converti il percorso in array di stringhe
+// Converte un percorso del grafo (id dei nodi) nell'array dei nomi dei punti, terminato da NULL.
+// I nodi di solo passaggio, senza punto né centro, non compaiono nel risultato
+static char** percorso_to_nomi(DeliveryManager manager, linked_list percorso) {
     int lunghezza = linked_list_size(percorso);
     char** nomi = malloc((lunghezza + 1) * sizeof(char*));
     
-    if (!nomi) {
-        linked_list_destroy(&percorso);
-        return NULL;
-    }
+    if (!nomi) return NULL;
     
     // Riempi l'array con i nomi dei punti
+    int num_nomi = 0;
+    pthread_rwlock_rdlock(&manager->indici_lock);
     for (int i = 0; i < lunghezza; i++) {
         int node_id_value;
         if (linked_list_get_at(percorso, i, &node_id_value) != LINKED_LIST_SUCCESS) continue;
         
         weighted_direct_graph_node_id node_id = (weighted_direct_graph_node_id)node_id_value;
         
-        // Trova il punto corrispondente al nodo
-        char* nome_punto = "Punto Sconosciuto";
-        for (int j = 0; j < dynamic_array_size(manager->zone_logistiche); j++) {
-            ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, j);
-            if (z && *z) {
-                for (int k = 0; k < zona_logistica_get_num_punti_consegna(*z); k++) {
-                    PuntoConsegna punto = zona_logistica_get_punto_consegna(*z, k);
-                    if (punto) {
-                        Node nodo = punto_consegna_get_nodo(punto);
-                        if (nodo && weighted_direct_graph_get_node_id(nodo) == node_id) {
-                            nome_punto = (char*)punto_consegna_get_nome(punto);
-                            break;
-                        }
-                    }
-                }
-            }
+        // Trova il punto (o il centro di smistamento) corrispondente al nodo
+        const char* nome_punto = NULL;
+        const EntitaNodo* entita = entita_by_nodo(manager, node_id);
+        if (entita && entita->tipo == NODO_PUNTO_CONSEGNA) {
+            nome_punto = punto_consegna_get_nome(entita->punto);
+        } else if (entita && entita->tipo == NODO_CENTRO_SMISTAMENTO) {
+            nome_punto = centro_smistamento_get_nome(entita->centro);
         }
+        if (!nome_punto) continue; // Nodo di solo passaggio
         
-        nomi[i] = malloc(strlen(nome_punto) + 1);
-        if (nomi[i]) {
-            strcpy(nomi[i], nome_punto);
+        nomi[num_nomi] = malloc(strlen(nome_punto) + 1);
+        if (nomi[num_nomi]) {
+            strcpy(nomi[num_nomi++], nome_punto);
         }
     }
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
+    nomi[num_nomi] = NULL; // Terminatore
+    return nomi;
+}
+
+// Restituisce l'id del nodo del grafo associato al punto di consegna con il nome indicato
+// o, se non c'è un punto con quel nome, al centro di smistamento omonimo; -1 se non esiste.
+// I lettori la chiamano con indici_lock in lettura; le modifiche, serializzate, senza lock
+static weighted_direct_graph_node_id nodo_by_nome(DeliveryManager manager, char* nome) {
+    Luogo luogo = (Luogo)hash_index_get(manager->luoghi_per_nome, nome);
+    if (!luogo) return -1;
+    
+    Node nodo = NULL;
+    if (luogo->punto) {
+        nodo = punto_consegna_get_nodo(luogo->punto);
+    } else if (luogo->centro) {
+        nodo = centro_smistamento_get_nodo(luogo->centro);
+    }
+    if (!nodo) return -1;
+    
+    return weighted_direct_graph_get_node_id(nodo);
+}
+
+char** getPercorsoBreve(DeliveryManager manager, char* partenza, char* arrivo) {
+    if (!manager || !partenza || !arrivo) return NULL;
     
-    nomi[lunghezza] = NULL; // Terminatore
+    // Trova i nodi dei punti di consegna
+    pthread_rwlock_rdlock(&manager->indici_lock);
+    weighted_direct_graph_node_id id_partenza = nodo_by_nome(manager, partenza);
+    weighted_direct_graph_node_id id_arrivo = nodo_by_nome(manager, arrivo);
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
+    if (id_partenza < 0 || id_arrivo < 0) return NULL;
+    
+    // Calcola il percorso più breve sulla versione pubblicata della rete, condividendo
+    // la ricerca con eventuali richieste identiche contemporanee
+    linked_list percorso = route_coalescer_shortest_path(manager->percorsi_in_corso, id_partenza, id_arrivo);
+    
+    if (!percorso) return NULL;
+    
+    // Converti il percorso in array di stringhe
+    char** nomi = percorso_to_nomi(manager, percorso);
+    linked_list_destroy(&percorso);
+    return nomi;
+}
+
+char** getPercorsoConChiusure(DeliveryManager manager, char* partenza, char* arrivo, DatiChiusura* strade_chiuse, int num_strade_chiuse, char** punti_chiusi, int num_punti_chiusi) {
+    if (!manager || !partenza || !arrivo || num_strade_chiuse < 0 || num_punti_chiusi < 0) return NULL;
+    if ((num_strade_chiuse > 0 && !strade_chiuse) || (num_punti_chiusi > 0 && !punti_chiusi)) return NULL;
+    
+    // Le chiusure vivono solo nella maschera: la rete condivisa non viene modificata
+    weighted_direct_graph_mask chiusure = weighted_direct_graph_mask_create();
+    if (!chiusure) return NULL;
+    
+    pthread_rwlock_rdlock(&manager->indici_lock);
+    weighted_direct_graph_node_id id_partenza = nodo_by_nome(manager, partenza);
+    weighted_direct_graph_node_id id_arrivo = nodo_by_nome(manager, arrivo);
+    
+    for (int i = 0; i < num_strade_chiuse; i++) {
+        if (!strade_chiuse[i].partenza || !strade_chiuse[i].arrivo) continue;
+        weighted_direct_graph_node_id da = nodo_by_nome(manager, strade_chiuse[i].partenza);
+        weighted_direct_graph_node_id a = nodo_by_nome(manager, strade_chiuse[i].arrivo);
+        if (da >= 0 && a >= 0) weighted_direct_graph_mask_close_edge(chiusure, da, a);
+    }
+    
+    for (int i = 0; i < num_punti_chiusi; i++) {
+        if (!punti_chiusi[i]) continue;
+        weighted_direct_graph_node_id nodo_id = nodo_by_nome(manager, punti_chiusi[i]);
+        if (nodo_id >= 0) weighted_direct_graph_mask_close_node(chiusure, nodo_id);
+    }
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
+    if (id_partenza < 0 || id_arrivo < 0) {
+        weighted_direct_graph_mask_destroy(&chiusure);
+        return NULL;
+    }
+    
+    graph_version versione = versioned_graph_acquire(manager->area_metropolitana);
+    linked_list percorso = weighted_direct_graph_shortest_path_masked(graph_version_get_graph(versione), id_partenza, id_arrivo, 0, chiusure);
+    graph_version_release(&versione);
+    weighted_direct_graph_mask_destroy(&chiusure);
+    
+    if (!percorso) return NULL;
     
+    char** nomi = percorso_to_nomi(manager, percorso);
     linked_list_destroy(&percorso);
     return nomi;
 }
@@ -698,42 +1095,340 @@ char** getPercorsoBreve(DeliveryManager manager, char* partenza, char* arrivo) {
 int addCollegamento(DeliveryManager manager, char* partenza, char* arrivo, int tempo) {
     if (!manager || !partenza || !arrivo) return 1;
     
-    // Trova i punti di consegna
-    PuntoConsegna punto_partenza = getPuntoConsegnaByNome(manager, partenza);
-    PuntoConsegna punto_arrivo = getPuntoConsegnaByNome(manager, arrivo);
+    // Trova i nodi dei punti (o dei centri di smistamento) collegati
+    weighted_direct_graph_node_id id_partenza = nodo_by_nome(manager, partenza);
+    weighted_direct_graph_node_id id_arrivo = nodo_by_nome(manager, arrivo);
     
-    if (!punto_partenza) return 2; // Punto di partenza non esiste
-    if (!punto_arrivo) return 3;   // Punto di arrivo non esiste
+    if (id_partenza < 0) return 2; // Punto di partenza non esiste
+    if (id_arrivo < 0) return 3;   // Punto di arrivo non esiste
     
-    // Ottieni i nodi del grafo
-    Node nodo_partenza = punto_consegna_get_nodo(punto_partenza);
-    Node nodo_arrivo = punto_consegna_get_nodo(punto_arrivo);
+    // Aggiunge l'arco a una nuova versione della rete (o alla bozza del blocco aperto)
+    weighted_direct_graph rete = inizia_modifica(manager);
+    if (!rete) return 1;
     
-    if (!nodo_partenza || !nodo_arrivo) return 1;
+    bool aggiunto = weighted_direct_graph_add_edge(rete, id_partenza, id_arrivo, tempo) == WDG_SUCCESS;
+    termina_modifica(manager, aggiunto);
     
-    // Aggiunge l'arco al grafo
-    weighted_direct_graph_node_id id_partenza = weighted_direct_graph_get_node_id(nodo_partenza);
-    weighted_direct_graph_node_id id_arrivo = weighted_direct_graph_get_node_id(nodo_arrivo);
+    return aggiunto ? 0 : 1;
+}
+
+// Importare in blocco punti di consegna e collegamenti
+int importaRete(DeliveryManager manager, DatiPuntoConsegna* punti, int num_punti, DatiCollegamento* collegamenti, int num_collegamenti) {
+    if (!manager || num_punti < 0 || num_collegamenti < 0) return 1;
+    if ((num_punti > 0 && !punti) || (num_collegamenti > 0 && !collegamenti)) return 1;
+    
+    // Verifica i collegamenti
+    for (int i = 0; i < num_collegamenti; i++) {
+        if (collegamenti[i].partenza < 0 || collegamenti[i].partenza >= num_punti ||
+            collegamenti[i].arrivo < 0 || collegamenti[i].arrivo >= num_punti ||
+            collegamenti[i].tempo <= 0) {
+            return 4;
+        }
+    }
+    
+    // Risolve le zone logistiche una volta per punto (gli incroci, senza nome, non hanno zona)
+    ZonaLogistica* zone = malloc((num_punti + 1) * sizeof(ZonaLogistica));
+    if (!zone) return 1;
+    
+    for (int i = 0; i < num_punti; i++) {
+        zone[i] = NULL;
+        if (!punti[i].nome) continue; // Incrocio
+        if (!punti[i].zona_logistica_nome) {
+            free(zone);
+            return 1;
+        }
+        zone[i] = getZonaLogisticaByNome(manager, punti[i].zona_logistica_nome);
+        if (!zone[i]) {
+            free(zone);
+            return 3; // Zona logistica non esiste
+        }
+    }
+    
+    // I nomi già presenti si trovano nell'indice; tra i nuovi, ordinati, i duplicati risultano adiacenti
+    int num_esistenti = 0;
+    DA_FOR_EACH(ZonaLogistica, z, &manager->zone_logistiche) {
+        if (z && *z) num_esistenti += zona_logistica_get_num_punti_consegna(*z);
+    }
+    
+    const char** nomi = malloc((num_punti + 1) * sizeof(char*));
+    if (!nomi) {
+        free(zone);
+        return 1;
+    }
     
-    if (weighted_direct_graph_add_edge(manager->area_metropolitana, id_partenza, id_arrivo, tempo) != WDG_SUCCESS) {
+    int num_nomi = 0;
+    for (int i = 0; i < num_punti; i++) {
+        if (punti[i].nome) nomi[num_nomi++] = punti[i].nome;
+    }
+    
+    qsort(nomi, num_nomi, sizeof(char*), compare_nomi);
+    for (int i = 0; i < num_nomi; i++) {
+        if ((i > 0 && strcmp(nomi[i - 1], nomi[i]) == 0) || getPuntoConsegnaByNome(manager, (char*)nomi[i])) {
+            free(nomi);
+            free(zone);
+            return 2; // Nome già presente
+        }
+    }
+    free(nomi);
+    
+    // Prepara tutto ciò che può fallire prima di toccare la rete o gli indici: lo spazio nelle
+    // zone e nelle voci dei nomi, gli array dei collegamenti e quello dei nomi da indicizzare
+    int num_zone = ZonaLogistica_array_size(&manager->zone_logistiche);
+    int* punti_per_zona = calloc(num_zone + 1, sizeof(int));
+    PuntoConsegna* creati = calloc(num_punti + 1, sizeof(PuntoConsegna));
+    void** blocco = malloc((num_punti + 1) * sizeof(void*));
+    Luogo* nuovi = malloc((num_punti + 1) * sizeof(Luogo));
+    weighted_direct_graph_node_id* sorgenti = malloc((num_collegamenti + 1) * sizeof(weighted_direct_graph_node_id));
+    weighted_direct_graph_node_id* destinazioni = malloc((num_collegamenti + 1) * sizeof(weighted_direct_graph_node_id));
+    int* tempi = malloc((num_collegamenti + 1) * sizeof(int));
+    
+    int esito = (punti_per_zona && creati && blocco && nuovi && sorgenti && destinazioni && tempi) ? 0 : 1;
+    if (esito == 0) {
+        for (int i = 0; i < num_punti; i++) {
+            if (zone[i]) punti_per_zona[indice_zona(manager, zone[i])]++;
+        }
+        
+        if (Luogo_array_reserve(&manager->luoghi, Luogo_array_size(&manager->luoghi) + num_nomi) != DYN_ARRAY_SUCCESS) {
+            esito = 1;
+        }
+        for (int k = 0; k < num_zone && esito == 0; k++) {
+            if (punti_per_zona[k] > 0 && zona_logistica_reserve_punti_consegna(DA_AT(&manager->zone_logistiche, k), punti_per_zona[k]) != 0) {
+                esito = 1;
+            }
+        }
+    }
+    
+    // Tutta l'importazione avviene su un'unica bozza, pubblicata come una sola versione
+    weighted_direct_graph rete = (esito == 0) ? inizia_modifica(manager) : NULL;
+    if (!rete) esito = 1;
+    
+    // Crea tutti i nodi con un'unica espansione del grafo e inserisce i collegamenti in un solo
+    // passaggio: se qualcosa fallisce la bozza viene scartata senza aver registrato alcun punto
+    // (in un blocco di modifiche nodi e collegamenti restano nella bozza, senza entità)
+    weighted_direct_graph_node_id primo_nodo = 0;
+    if (esito == 0 && num_punti > 0) {
+        primo_nodo = weighted_direct_graph_add_nodes(rete, num_punti);
+        if (primo_nodo < 0) esito = 1;
+    }
+    if (esito == 0 && num_collegamenti > 0) {
+        for (int i = 0; i < num_collegamenti; i++) {
+            sorgenti[i] = primo_nodo + collegamenti[i].partenza;
+            destinazioni[i] = primo_nodo + collegamenti[i].arrivo;
+            tempi[i] = collegamenti[i].tempo;
+        }
+        if (weighted_direct_graph_add_edges_bulk(rete, sorgenti, destinazioni, tempi, num_collegamenti) != WDG_SUCCESS) {
+            esito = 1;
+        }
+    }
+    free(sorgenti);
+    free(destinazioni);
+    free(tempi);
+    
+    // Prepara le voci dei nomi e lo spazio negli indici, poi crea i punti senza registrarli:
+    // in caso di errore vengono distrutti e le voci dei nomi restano vuote
+    int num_nuovi = 0;
+    if (esito == 0) {
+        pthread_rwlock_wrlock(&manager->indici_lock);
+        if (riserva_entita_nodi(manager, primo_nodo + num_punti) != 0 ||
+            Luogo_array_reserve(&manager->luoghi_ordinati, Luogo_array_size(&manager->luoghi_ordinati) + num_nomi) != DYN_ARRAY_SUCCESS) {
+            esito = 1;
+        }
+        for (int i = 0; i < num_punti && esito == 0; i++) {
+            if (!punti[i].nome) continue;
+            Luogo luogo = luogo_per_nome(manager, punti[i].nome);
+            if (!luogo) {
+                esito = 1;
+            } else if (!luogo->centro) {
+                nuovi[num_nuovi++] = luogo;
+            }
+        }
+        pthread_rwlock_unlock(&manager->indici_lock);
+    }
+    
+    for (int i = 0, num_creati = 0; i < num_punti && esito == 0; i++) {
+        if (!punti[i].nome) continue;
+        num_creati++;
+        Node nodo = weighted_direct_graph_get_node(rete, primo_nodo + i);
+        const char* nome = ((Luogo)hash_index_get(manager->luoghi_per_nome, punti[i].nome))->nome;
+        creati[i] = punto_consegna_create(num_esistenti + num_creati, nome, punti[i].priorita,
+                                          punti[i].orario, punti[i].tipo, nodo, zone[i]);
+        if (!creati[i]) esito = 1;
+    }
+    
+    if (esito != 0) {
+        for (int i = 0; creati && i < num_punti; i++) {
+            if (creati[i]) punto_consegna_destroy(&creati[i]);
+        }
+        if (rete) termina_modifica(manager, false);
+        free(punti_per_zona);
+        free(creati);
+        free(blocco);
+        free(nuovi);
+        free(zone);
         return 1;
     }
     
+    // Aggiunge i punti creati alle zone, un blocco per zona nell'ordine di importazione
+    // (lo spazio è riservato, quindi l'aggiunta non può fallire)
+    for (int k = 0; k < num_zone; k++) {
+        if (punti_per_zona[k] == 0) continue;
+        
+        ZonaLogistica zona = DA_AT(&manager->zone_logistiche, k);
+        int num_blocco = 0;
+        for (int i = 0; i < num_punti; i++) {
+            if (zone[i] == zona) blocco[num_blocco++] = creati[i];
+        }
+        zona_logistica_add_punti_consegna(zona, blocco, num_blocco);
+    }
+    
+    // I nodi vengono pubblicati prima di registrare i nomi, come nelle modifiche singole;
+    // da qui in poi nessun passaggio può fallire
+    termina_modifica(manager, true);
+    
+    pthread_rwlock_wrlock(&manager->indici_lock);
+    indicizza_luoghi(manager, nuovi, num_nuovi);
+    for (int i = 0; i < num_punti; i++) {
+        if (!punti[i].nome) continue; // Gli incroci restano nodi senza entità
+        Luogo luogo = (Luogo)hash_index_get(manager->luoghi_per_nome, punti[i].nome);
+        luogo->punto = creati[i];
+        
+        EntitaNodo* entita = &DA_AT(&manager->entita_per_nodo, primo_nodo + i);
+        entita->tipo = NODO_PUNTO_CONSEGNA;
+        entita->punto = creati[i];
+        entita->indice_zona = indice_zona(manager, zone[i]);
+    }
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
+    free(punti_per_zona);
+    free(creati);
+    free(blocco);
+    free(nuovi);
+    free(zone);
     return 0;
 }
 
+char*** getPercorsiBilanciati(DeliveryManager manager, char** partenze, char** arrivi, int num_percorsi, int capacita) {
+    if (!manager || !partenze || !arrivi || num_percorsi <= 0 || capacita <= 0) return NULL;
+    
+    char*** risultato = calloc(num_percorsi, sizeof(char**));
+    weighted_direct_graph_node_id* sorgenti = malloc(num_percorsi * sizeof(weighted_direct_graph_node_id));
+    weighted_direct_graph_node_id* destinazioni = malloc(num_percorsi * sizeof(weighted_direct_graph_node_id));
+    int* indici = malloc(num_percorsi * sizeof(int));
+    linked_list* percorsi = malloc(num_percorsi * sizeof(linked_list));
+    if (!risultato || !sorgenti || !destinazioni || !indici || !percorsi) {
+        free(risultato);
+        free(sorgenti);
+        free(destinazioni);
+        free(indici);
+        free(percorsi);
+        return NULL;
+    }
+    
+    // Solo le richieste con entrambi i punti esistenti partecipano all'assegnazione
+    int num_viaggi = 0;
+    pthread_rwlock_rdlock(&manager->indici_lock);
+    for (int i = 0; i < num_percorsi; i++) {
+        weighted_direct_graph_node_id da = partenze[i] ? nodo_by_nome(manager, partenze[i]) : -1;
+        weighted_direct_graph_node_id a = arrivi[i] ? nodo_by_nome(manager, arrivi[i]) : -1;
+        if (da < 0 || a < 0) continue;
+        sorgenti[num_viaggi] = da;
+        destinazioni[num_viaggi] = a;
+        indici[num_viaggi++] = i;
+    }
+    pthread_rwlock_unlock(&manager->indici_lock);
+    
+    graph_version versione = versioned_graph_acquire(manager->area_metropolitana);
+    int esito = weighted_direct_graph_assign_traffic(graph_version_get_graph(versione), sorgenti, destinazioni,
+                                                     num_viaggi, capacita, ITERAZIONI_BILANCIAMENTO, percorsi);
+    graph_version_release(&versione);
+    
+    for (int k = 0; k < num_viaggi && esito == WDG_SUCCESS; k++) {
+        if (percorsi[k]) {
+            risultato[indici[k]] = percorso_to_nomi(manager, percorsi[k]);
+            linked_list_destroy(&percorsi[k]);
+        }
+    }
+    
+    free(sorgenti);
+    free(destinazioni);
+    free(indici);
+    free(percorsi);
+    
+    if (esito != WDG_SUCCESS) {
+        free(risultato);
+        return NULL;
+    }
+    return risultato;
+}
+
+// Ottimizzare la disposizione in memoria della rete stradale
+int ottimizzaRete(DeliveryManager manager) {
+    if (!manager) return 1;
+    
+    weighted_direct_graph rete = inizia_modifica(manager);
+    if (!rete) return 1;
+    
+    bool riuscita = weighted_direct_graph_reorder(rete, WDG_ORDER_RCM) == WDG_SUCCESS;
+    termina_modifica(manager, riuscita);
+    
+    return riuscita ? 0 : 1;
+}
+
+int compattaRete(DeliveryManager manager) {
+    if (!manager) return 1;
+    
+    weighted_direct_graph rete = inizia_modifica(manager);
+    if (!rete) return 1;
+    
+    // Punti di consegna e centri di smistamento non vengono mai contratti, anche se oggi non
+    // hanno carichi: un carico inserito dopo la compattazione deve trovare ancora il suo nodo
+    bool riuscita = weighted_direct_graph_contract_chains(rete, is_nodo_terminale, manager) == WDG_SUCCESS;
+    termina_modifica(manager, riuscita);
+    
+    return riuscita ? 0 : 1;
+}
+
+int comprimiRete(DeliveryManager manager, int attiva) {
+    if (!manager) return 1;
+    
+    weighted_direct_graph rete = inizia_modifica(manager);
+    if (!rete) return 1;
+    
+    weighted_direct_graph_storage storage = attiva ? WDG_STORAGE_COMPRESSED : WDG_STORAGE_MATRIX;
+    bool riuscita = weighted_direct_graph_set_storage(rete, storage) == WDG_SUCCESS;
+    termina_modifica(manager, riuscita);
+    
+    return riuscita ? 0 : 1;
+}
+
+// Aprire un blocco di modifiche alla rete, pubblicato come un'unica versione
+int apriModificheRete(DeliveryManager manager) {
+    if (!manager) return 1;
+    if (manager->bozza_rete) return 2; // Blocco già aperto
+    
+    manager->bozza_rete = versioned_graph_begin_write(manager->area_metropolitana);
+    return manager->bozza_rete ? 0 : 1;
+}
+
+int pubblicaModificheRete(DeliveryManager manager) {
+    if (!manager) return 1;
+    if (!manager->bozza_rete) return 2; // Nessun blocco aperto
+    
+    manager->bozza_rete = NULL;
+    return versioned_graph_publish(manager->area_metropolitana) == VG_SUCCESS ? 0 : 1;
+}
+
 // Funzioni getter per gli array
 Veicolo* getVeicoli(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int size = dynamic_array_size(manager->veicoli);
+    int size = Veicolo_array_size(&manager->veicoli);
     Veicolo* veicoli = malloc(size * sizeof(Veicolo));
     
     if (!veicoli) return NULL;
     
     for (int i = 0; i < size; i++) {
-        Veicolo* v = (Veicolo*)dynamic_array_get_at(manager->veicoli, i);
-        veicoli[i] = v ? *v : NULL;
+        veicoli[i] = DA_AT(&manager->veicoli, i);
     }
     
     return veicoli;
@@ -742,14 +1437,13 @@ Veicolo* getVeicoli(DeliveryManager manager) {
 Carico* getCarichi(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int size = dynamic_array_size(manager->carichi);
+    int size = Carico_array_size(&manager->carichi);
     Carico* carichi = malloc(size * sizeof(Carico));
     
     if (!carichi) return NULL;
     
     for (int i = 0; i < size; i++) {
-        Carico* c = (Carico*)dynamic_array_get_at(manager->carichi, i);
-        carichi[i] = c ? *c : NULL;
+        carichi[i] = DA_AT(&manager->carichi, i);
     }
     
     return carichi;
@@ -758,14 +1452,13 @@ Carico* getCarichi(DeliveryManager manager) {
 Missione* getMissioni(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int size = dynamic_array_size(manager->missioni);
+    int size = Missione_array_size(&manager->missioni);
     Missione* missioni = malloc(size * sizeof(Missione));
     
     if (!missioni) return NULL;
     
     for (int i = 0; i < size; i++) {
-        Missione* m = (Missione*)dynamic_array_get_at(manager->missioni, i);
-        missioni[i] = m ? *m : NULL;
+        missioni[i] = DA_AT(&manager->missioni, i);
     }
     
     return missioni;
@@ -774,14 +1467,13 @@ Missione* getMissioni(DeliveryManager manager) {
 ZonaLogistica* getZoneLogistiche(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int size = dynamic_array_size(manager->zone_logistiche);
+    int size = ZonaLogistica_array_size(&manager->zone_logistiche);
     ZonaLogistica* zone = malloc(size * sizeof(ZonaLogistica));
     
     if (!zone) return NULL;
     
     for (int i = 0; i < size; i++) {
-        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
-        zone[i] = z ? *z : NULL;
+        zone[i] = DA_AT(&manager->zone_logistiche, i);
     }
     
     return zone;
@@ -790,14 +1482,13 @@ ZonaLogistica* getZoneLogistiche(DeliveryManager manager) {
 CentroSmistamento* getCentriSmistamento(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int size = dynamic_array_size(manager->centri_smistamento);
+    int size = CentroSmistamento_array_size(&manager->centri_smistamento);
     CentroSmistamento* centri = malloc(size * sizeof(CentroSmistamento));
     
     if (!centri) return NULL;
     
     for (int i = 0; i < size; i++) {
-        CentroSmistamento* c = (CentroSmistamento*)dynamic_array_get_at(manager->centri_smistamento, i);
-        centri[i] = c ? *c : NULL;
+        centri[i] = DA_AT(&manager->centri_smistamento, i);
     }
     
     return centri;
@@ -807,48 +1498,32 @@ CentroSmistamento* getCentriSmistamento(DeliveryManager manager) {
 Veicolo getVeicoloByTarga(DeliveryManager manager, char* targa) {
     if (!manager || !targa) return NULL;
     
-    for (int i = 0; i < dynamic_array_size(manager->veicoli); i++) {
-        Veicolo* v = (Veicolo*)dynamic_array_get_at(manager->veicoli, i);
-        if (v && *v && strcmp(veicolo_get_targa(*v), targa) == 0) {
-            return *v;
-        }
-    }
-    
-    return NULL;
+    return (Veicolo)hash_index_get(manager->veicoli_per_targa, targa);
 }
 
 Carico getCaricoById(DeliveryManager manager, int id) {
     if (!manager) return NULL;
     
-    for (int i = 0; i < dynamic_array_size(manager->carichi); i++) {
-        Carico* c = (Carico*)dynamic_array_get_at(manager->carichi, i);
-        if (c && *c && carico_get_id(*c) == id) {
-            return *c;
-        }
-    }
-    
-    return NULL;
+    if (id < 1 || id > Carico_array_size(&manager->carichi_per_id)) return NULL;
+    return DA_AT(&manager->carichi_per_id, id - 1);
 }
 
 Missione getMissioneById(DeliveryManager manager, int id) {
     if (!manager) return NULL;
     
-    for (int i = 0; i < dynamic_array_size(manager->missioni); i++) {
-        Missione* m = (Missione*)dynamic_array_get_at(manager->missioni, i);
-        if (m && *m && missione_get_id(*m) == id) {
-            return *m;
-        }
-    }
-    
-    return NULL;
+    if (id < 1 || id > Missione_array_size(&manager->missioni_per_id)) return NULL;
+    return DA_AT(&manager->missioni_per_id, id - 1);
 }
 
 ZonaLogistica getZonaLogisticaByNome(DeliveryManager manager, char* nome) {
     if (!manager || !nome) return NULL;
     
-    for (int i = 0; i < dynamic_array_size(manager->zone_logistiche); i++) {
-        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
-        if (z && *z && strcmp(zona_logistica_get_nome(*z), nome) == 0) {
+    // Un nome mai internato non può appartenere a nessuna zona; altrimenti basta confrontare i puntatori
+    const char* nome_interno = string_pool_find(manager->stringhe, nome);
+    if (!nome_interno) return NULL;
+    
+    DA_FOR_EACH(ZonaLogistica, z, &manager->zone_logistiche) {
+        if (z && *z && zona_logistica_get_nome(*z) == nome_interno) {
             return *z;
         }
     }
@@ -859,66 +1534,91 @@ ZonaLogistica getZonaLogisticaByNome(DeliveryManager manager, char* nome) {
 CentroSmistamento getCentroSmistamentoByNome(DeliveryManager manager, char* nome) {
     if (!manager || !nome) return NULL;
     
-    for (int i = 0; i < dynamic_array_size(manager->centri_smistamento); i++) {
-        CentroSmistamento* c = (CentroSmistamento*)dynamic_array_get_at(manager->centri_smistamento, i);
-        if (c && *c && strcmp(centro_smistamento_get_nome(*c), nome) == 0) {
-            return *c;
-        }
-    }
-    
-    return NULL;
+    pthread_rwlock_rdlock(&manager->indici_lock);
+    Luogo luogo = (Luogo)hash_index_get(manager->luoghi_per_nome, nome);
+    CentroSmistamento centro = luogo ? luogo->centro : NULL;
+    pthread_rwlock_unlock(&manager->indici_lock);
+    return centro;
 }
 
 PuntoConsegna getPuntoConsegnaByNome(DeliveryManager manager, char* nome) {
     if (!manager || !nome) return NULL;
     
-    // Cerca in tutte le zone logistiche
-    for (int i = 0; i < dynamic_array_size(manager->zone_logistiche); i++) {
-        ZonaLogistica* z = (ZonaLogistica*)dynamic_array_get_at(manager->zone_logistiche, i);
-        if (z && *z) {
-            for (int j = 0; j < zona_logistica_get_num_punti_consegna(*z); j++) {
-                PuntoConsegna punto = zona_logistica_get_punto_consegna(*z, j);
-                if (punto && strcmp(punto_consegna_get_nome(punto), nome) == 0) {
-                    return punto;
-                }
-            }
+    pthread_rwlock_rdlock(&manager->indici_lock);
+    Luogo luogo = (Luogo)hash_index_get(manager->luoghi_per_nome, nome);
+    PuntoConsegna punto = luogo ? luogo->punto : NULL;
+    pthread_rwlock_unlock(&manager->indici_lock);
+    return punto;
+}
+
+char** getNomiPerPrefisso(DeliveryManager manager, char* prefisso, int k) {
+    if (!manager || !prefisso || k < 1) return NULL;
+    
+    // I nomi con il prefisso occupano un intervallo contiguo dell'indice ordinato, a partire dal primo non minore del prefisso
+    pthread_rwlock_rdlock(&manager->indici_lock);
+    size_t lunghezza = strlen(prefisso);
+    int inizio = posizione_nome(manager, prefisso);
+    int fine = inizio;
+    int num_luoghi = Luogo_array_size(&manager->luoghi_ordinati);
+    while (fine < num_luoghi && fine - inizio < k &&
+           strncmp(DA_AT(&manager->luoghi_ordinati, fine)->nome, prefisso, lunghezza) == 0) {
+        fine++;
+    }
+    
+    char** nomi = malloc((fine - inizio + 1) * sizeof(char*));
+    if (!nomi) {
+        pthread_rwlock_unlock(&manager->indici_lock);
+        return NULL;
+    }
+    
+    for (int i = inizio; i < fine; i++) {
+        const char* nome = DA_AT(&manager->luoghi_ordinati, i)->nome;
+        nomi[i - inizio] = malloc(strlen(nome) + 1);
+        if (!nomi[i - inizio]) {
+            pthread_rwlock_unlock(&manager->indici_lock);
+            for (int j = 0; j < i - inizio; j++) free(nomi[j]);
+            free(nomi);
+            return NULL;
         }
+        strcpy(nomi[i - inizio], nome);
     }
+    pthread_rwlock_unlock(&manager->indici_lock);
+    nomi[fine - inizio] = NULL;
     
-    return NULL;
+    return nomi;
 }
 
 // Funzioni per ottenere i contatori
 int getNumVeicoli(DeliveryManager manager) {
     if (!manager) return -1;
-    return dynamic_array_size(manager->veicoli);
+    return Veicolo_array_size(&manager->veicoli);
 }
 
 int getNumCarichi(DeliveryManager manager) {
     if (!manager) return -1;
-    return dynamic_array_size(manager->carichi);
+    return Carico_array_size(&manager->carichi);
 }
 
 int getNumMissioni(DeliveryManager manager) {
     if (!manager) return -1;
-    return dynamic_array_size(manager->missioni);
+    return Missione_array_size(&manager->missioni);
 }
 
 int getNumZoneLogistiche(DeliveryManager manager) {
     if (!manager) return -1;
-    return dynamic_array_size(manager->zone_logistiche);
+    return ZonaLogistica_array_size(&manager->zone_logistiche);
 }
 
 int getNumCentriSmistamento(DeliveryManager manager) {
     if (!manager) return -1;
-    return dynamic_array_size(manager->centri_smistamento);
+    return CentroSmistamento_array_size(&manager->centri_smistamento);
 }
 
 // F8. Funzione personalizzata: Calcola l'efficienza dei veicoli
 double* calcolaEfficienzaVeicoli(DeliveryManager manager) {
     if (!manager) return NULL;
     
-    int num_veicoli = dynamic_array_size(manager->veicoli);
+    int num_veicoli = Veicolo_array_size(&manager->veicoli);
     if (num_veicoli == 0) return NULL;
     
     double* efficienze = calloc(num_veicoli, sizeof(double));
@@ -926,7 +1626,7 @@ double* calcolaEfficienzaVeicoli(DeliveryManager manager) {
     
     // Calcola l'efficienza per ogni veicolo
     for (int i = 0; i < num_veicoli; i++) {
-        Veicolo* v = (Veicolo*)dynamic_array_get_at(manager->veicoli, i);
+        Veicolo* v = &DA_AT(&manager->veicoli, i);
         if (v && *v) {
             int missioni_completate = 0;
             double tempo_totale = 0;
@@ -934,8 +1634,7 @@ double* calcolaEfficienzaVeicoli(DeliveryManager manager) {
             int num_carichi = 0;
             
             // Conta le missioni completate per questo veicolo
-            for (int j = 0; j < dynamic_array_size(manager->missioni); j++) {
-                Missione* m = (Missione*)dynamic_array_get_at(manager->missioni, j);
+            DA_FOR_EACH(Missione, m, &manager->missioni) {
                 if (m && *m && missione_get_veicolo(*m) == *v) {
                     if (missione_get_stato(*m) == STATO_MISSIONE_COMPLETATA) {
                         missioni_completate++;
@@ -9,8 +9,47 @@
 #include "carico.h"
 #include "centrosmistamento.h"
 
+/*
+ * Uso da più thread: le funzioni che modificano il gestore vanno serializzate dal chiamante
+ * tra loro. Le richieste di percorso (getPercorsoBreve, getPercorsoConChiusure,
+ * getPercorsiBilanciati) e le ricerche di punti e centri per nome o prefisso possono invece
+ * essere eseguite da più thread contemporaneamente, anche mentre un altro thread modifica la
+ * rete: i percorsi si calcolano senza lock su una versione pubblicata del grafo, e gli indici
+ * dei nomi e dei nodi sono protetti da un lock lettori/scrittori tenuto solo per le ricerche.
+ * Le altre funzioni di lettura (statistiche, array delle entità, zone) non vanno eseguite
+ * durante una modifica.
+ *
+ * Ogni modifica alla rete (createPuntoConsegna, createCentroSmistamento, addCollegamento,
+ * importaRete, ottimizzaRete, compattaRete, comprimiRete) viene pubblicata come nuova
+ * versione al termine della chiamata, al costo di una copia del grafo proporzionale al numero
+ * di nodi. Molte modifiche singole conviene raccoglierle in un blocco (apriModificheRete,
+ * pubblicaModificheRete), pubblicato come un'unica versione.
+ */
 typedef struct DeliveryManager* DeliveryManager;
 
+// Descrizione di un punto di consegna per l'importazione in blocco della rete (importaRete).
+// Con nome NULL descrive un incrocio: un nodo della rete senza punto di consegna né zona
+typedef struct {
+    char* nome;
+    int priorita;
+    int orario;
+    TipoPuntoConsegna tipo;
+    char* zona_logistica_nome;
+} DatiPuntoConsegna;
+
+// Strada chiusa per il calcolo di un percorso alternativo (getPercorsoConChiusure)
+typedef struct {
+    char* partenza;
+    char* arrivo;
+} DatiChiusura;
+
+// Collegamento per l'importazione in blocco: partenza e arrivo sono indici nell'array dei punti importati
+typedef struct {
+    int partenza;
+    int arrivo;
+    int tempo;
+} DatiCollegamento;
+
 /*
  * Funzione per creare un nuovo gestore della rete logistica
  * @params nessun parametro
@@ -88,6 +127,65 @@ int insertCarico(DeliveryManager manager, int peso, TipoCarico tipologia, char*
  */
 int addVeicoloToCoda(DeliveryManager manager, char* targa, char* centro_smistamento);
 
+/*
+ * Funzione per annullare un carico ancora in attesa nella coda del suo centro di smistamento
+ * Il carico viene tolto dalla coda senza scorrerla ed eliminato dal gestore.
+ * @params un puntatore al gestore della rete logistica, l'ID del carico
+ * @return 0 se l'annullamento è avvenuto con successo
+ *         1 se l'annullamento non è avvenuto con successo
+ *         2 se il carico non esiste
+ *         3 se il carico non è più in coda (ad esempio perché già assegnato a una missione)
+ */
+int cancelCarico(DeliveryManager manager, int id_carico);
+
+/*
+ * Funzione per aumentare la priorità di un carico in attesa nella coda del suo centro di smistamento
+ * Il carico passa in fondo ai carichi che hanno già la nuova priorità.
+ * @params un puntatore al gestore della rete logistica, l'ID del carico, la nuova priorità (1-5)
+ * @return 0 se la modifica è avvenuta con successo
+ *         1 se la modifica non è avvenuta con successo
+ *         2 se il carico non esiste
+ *         3 se il carico non è più in coda
+ *         4 se la nuova priorità non è valida o non è superiore a quella attuale
+ */
+int escalateCarico(DeliveryManager manager, int id_carico, int priorita);
+
+/*
+ * Funzione per trasferire a un altro centro di smistamento tutti i carichi e i veicoli in coda
+ * in un centro che va fuori servizio. Le code vengono unite in blocco, senza estrarre e
+ * reinserire i singoli elementi; a parità di priorità i carichi trasferiti seguono quelli
+ * già in attesa nel centro di destinazione. Ogni carico trasferito viene comunque visitato
+ * una volta per aggiornarne l'handle e il centro: il costo resta lineare nel numero di carichi
+ * e veicoli spostati (senza allocazioni per elemento), non costante.
+ * Il trasferimento è atomico: se fallisce, entrambi i centri restano invariati.
+ * @params un puntatore al gestore della rete logistica, il nome del centro da svuotare, il nome del centro di destinazione
+ * @return 0 se il trasferimento è avvenuto con successo
+ *         1 se il trasferimento non è avvenuto con successo (o i due centri coincidono)
+ *         2 se il centro da svuotare non esiste
+ *         3 se il centro di destinazione non esiste
+ */
+int transferBacklog(DeliveryManager manager, char* centro_origine, char* centro_destinazione);
+
+/*
+ * Funzione per ottenere la posizione di un carico nella coda del suo centro di smistamento
+ * La posizione è calcolata senza scorrere la coda.
+ * @params un puntatore al gestore della rete logistica, l'ID del carico
+ * @return il numero di carichi che verranno assegnati prima (0 se è il prossimo),
+ *         oppure -1 se il carico non esiste o non è in coda
+ */
+int getQueuePosition(DeliveryManager manager, int id_carico);
+
+/*
+ * Funzione per stimare il tempo di attesa di un carico in coda prima della sua consegna
+ * La stima combina la posizione in coda, il numero di veicoli in coda al centro di
+ * smistamento e la durata media delle missioni concluse.
+ * @params un puntatore al gestore della rete logistica, l'ID del carico
+ * @return il tempo stimato in secondi,
+ *         -1 se il carico non esiste o non è in coda,
+ *         -2 se non ci sono ancora missioni concluse su cui basare la stima
+ */
+double getQueueETA(DeliveryManager manager, int id_carico);
+
 /*
  * Funzione per assegnare una missione ad un veicolo
  * @params un puntatore al gestore della rete logistica, puntatore al veicolo, puntatore al carico
@@ -144,13 +242,41 @@ int* getNumConsegnePerZona(DeliveryManager manager);
 
 /*
  * Funzione per ottenere il percorso più breve tra due punti
+ * Richieste identiche eseguite contemporaneamente da più thread condividono un'unica ricerca
+ * Come partenza o arrivo si può indicare anche un centro di smistamento, se non esiste
+ * un punto di consegna con lo stesso nome
  * @params un puntatore al gestore della rete logistica, il nome del punto di partenza, il nome del punto di arrivo
  * @return una lista di nomi di punti che rappresentano il percorso, oppure NULL in caso di errore
  */
 char** getPercorsoBreve(DeliveryManager manager, char* partenza, char* arrivo);
 
+/*
+ * Funzione per ottenere il percorso più breve tra due punti ipotizzando alcune chiusure
+ * Le strade e i punti indicati vengono evitati solo per questo calcolo: la rete non viene
+ * modificata, quindi non è necessario riaggiungere i collegamenti al termine. Le chiusure
+ * che fanno riferimento a punti inesistenti vengono ignorate
+ * @params un puntatore al gestore della rete logistica, il nome del punto di partenza, il nome del punto di arrivo,
+ *         l'array delle strade chiuse e la sua lunghezza, l'array dei nomi dei punti chiusi e la sua lunghezza
+ * @return una lista di nomi di punti che rappresentano il percorso, oppure NULL se non esiste o in caso di errore
+ */
+char** getPercorsoConChiusure(DeliveryManager manager, char* partenza, char* arrivo, DatiChiusura* strade_chiuse, int num_strade_chiuse, char** punti_chiusi, int num_punti_chiusi);
+
+/*
+ * Funzione per pianificare insieme i percorsi di molti veicoli distribuendo il traffico
+ * Il tempo di ogni collegamento cresce con il numero di veicoli che lo percorrono, quindi
+ * i veicoli non vengono mandati tutti sulla stessa strada principale: veicoli con la stessa
+ * partenza e lo stesso arrivo possono ricevere percorsi diversi
+ * @params un puntatore al gestore della rete logistica, gli array dei nomi dei punti di partenza
+ *         e di arrivo, il numero di percorsi da calcolare, il numero di veicoli che un collegamento
+ *         sopporta prima di rallentare
+ * @return un array di num_percorsi percorsi (ognuno come in getPercorsoBreve, NULL se non esiste
+ *         o se un punto non esiste), oppure NULL in caso di errore
+ */
+char*** getPercorsiBilanciati(DeliveryManager manager, char** partenze, char** arrivi, int num_percorsi, int capacita);
+
 /*
  * Funzione per aggiungere un collegamento tra due punti
+ * Gli estremi possono essere anche centri di smistamento, come in getPercorsoBreve
  * @params un puntatore al gestore della rete logistica, il nome del punto di partenza, il nome del punto di arrivo, il tempo di percorrenza in minuti
  * @return 0 se l'aggiunta è avvenuta con successo
  *         1 se l'aggiunta non è avvenuta con successo
@@ -159,6 +285,79 @@ char** getPercorsoBreve(DeliveryManager manager, char* partenza, char* arrivo);
  */
 int addCollegamento(DeliveryManager manager, char* partenza, char* arrivo, int tempo);
 
+/*
+ * Funzione per importare in blocco una rete di punti di consegna e collegamenti
+ * Tutti i dati vengono verificati prima di modificare la rete; i nodi vengono creati con
+ * un'unica espansione del grafo e i collegamenti ordinati e inseriti in un solo passaggio.
+ * Se lo stesso collegamento compare più volte vale l'ultimo tempo indicato. In caso di errore
+ * nessun punto viene creato. Gli elementi con nome NULL diventano incroci: nodi di solo
+ * passaggio, che non compaiono nei percorsi restituiti e possono essere rimossi da compattaRete
+ * @params un puntatore al gestore della rete logistica, l'array dei punti da creare e la sua lunghezza,
+ *         l'array dei collegamenti (con indici nell'array dei punti) e la sua lunghezza
+ * @return 0 se l'importazione è avvenuta con successo
+ *         1 se l'importazione non è avvenuta con successo
+ *         2 se un nome è duplicato o già presente nella rete
+ *         3 se una zona logistica non esiste
+ *         4 se un collegamento fa riferimento a un punto inesistente o ha un tempo non positivo
+ */
+int importaRete(DeliveryManager manager, DatiPuntoConsegna* punti, int num_punti, DatiCollegamento* collegamenti, int num_collegamenti);
+
+/*
+ * Funzione per ottimizzare la disposizione in memoria della rete stradale
+ * Riordina internamente i nodi del grafo (Reverse Cuthill-McKee) così che punti collegati
+ * siano vicini in memoria; i riferimenti ai nodi di carichi e punti di consegna restano validi
+ * @params un puntatore al gestore della rete logistica
+ * @return 0 se l'ottimizzazione è avvenuta con successo
+ *         1 se l'ottimizzazione non è avvenuta con successo
+ */
+int ottimizzaRete(DeliveryManager manager);
+
+/*
+ * Funzione per compattare la rete stradale ai fini del calcolo dei percorsi
+ * Le catene di nodi di solo passaggio (incroci importati con importaRete, con due soli
+ * collegamenti) vengono sostituite da un unico collegamento; i punti di
+ * consegna e i centri restano sempre nella rete, quindi i percorsi restituiti da
+ * getPercorsoBreve continuano a elencarli tutti.
+ * Aggiungere punti, centri o collegamenti annulla la compattazione
+ * @params un puntatore al gestore della rete logistica
+ * @return 0 se la compattazione è avvenuta con successo
+ *         1 se la compattazione non è avvenuta con successo
+ */
+int compattaRete(DeliveryManager manager);
+
+/*
+ * Funzione per attivare o disattivare la rappresentazione compressa della rete stradale
+ * Con la rete compressa il calcolo dei percorsi resta disponibile con un consumo di memoria
+ * ridotto, ma non è possibile aggiungere punti, centri o collegamenti finché non viene disattivata
+ * @params un puntatore al gestore della rete logistica, 1 per comprimere la rete e 0 per ripristinarla
+ * @return 0 se l'operazione è avvenuta con successo
+ *         1 se l'operazione non è avvenuta con successo
+ */
+int comprimiRete(DeliveryManager manager, int attiva);
+
+/*
+ * Funzione per aprire un blocco di modifiche alla rete stradale
+ * Fino a pubblicaModificheRete le modifiche alla rete non vengono pubblicate una per una ma
+ * raccolte in un'unica bozza. I nuovi punti e centri si trovano subito per nome, ma i percorsi
+ * continuano a usare la rete pubblicata in precedenza (un percorso verso un punto non ancora
+ * pubblicato non esiste)
+ * @params un puntatore al gestore della rete logistica
+ * @return 0 se il blocco è stato aperto
+ *         1 se l'apertura non è avvenuta con successo
+ *         2 se un blocco è già aperto
+ */
+int apriModificheRete(DeliveryManager manager);
+
+/*
+ * Funzione per pubblicare le modifiche raccolte dal blocco aperto con apriModificheRete
+ * Tutte le modifiche diventano visibili ai percorsi in un'unica versione della rete
+ * @params un puntatore al gestore della rete logistica
+ * @return 0 se le modifiche sono state pubblicate
+ *         1 se la pubblicazione non è avvenuta con successo
+ *         2 se non c'è un blocco aperto
+ */
+int pubblicaModificheRete(DeliveryManager manager);
+
 /*
  * Funzione per ottenere tutti i veicoli registrati
  * @params un puntatore al gestore della rete logistica
@@ -236,6 +435,17 @@ CentroSmistamento getCentroSmistamentoByNome(DeliveryManager manager, char* nome
  */
 PuntoConsegna getPuntoConsegnaByNome(DeliveryManager manager, char* nome);
 
+/*
+ * Funzione per completare un nome: restituisce i nomi di punti di consegna e centri di
+ * smistamento che iniziano con il prefisso indicato, in ordine alfabetico
+ * Un nome usato sia da un punto sia da un centro compare una sola volta
+ * @params un puntatore al gestore della rete logistica, il prefisso da cercare (vuoto per tutti i nomi),
+ *         il numero massimo di nomi da restituire (almeno 1)
+ * @return una lista di al più k nomi terminata da NULL (vuota se nessun nome corrisponde),
+ *         oppure NULL in caso di errore. La lista e ogni nome vanno liberati dal chiamante
+ */
+char** getNomiPerPrefisso(DeliveryManager manager, char* prefisso, int k);
+
 /*
  * Funzione per ottenere il numero di veicoli registrati
  * @params un puntatore al gestore della rete logistica
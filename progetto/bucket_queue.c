@@ -0,0 +1,500 @@
+/*
+ * bucket_queue.c
+ *
+ * Implementazione della coda a livelli definita in bucket_queue.h.
+ *
+ * Ogni livello è un buffer circolare di puntatori con capacità potenza di due, che
+ * raddoppia quando è pieno: nessuna allocazione per elemento. Il bit k della maschera
+ * è acceso se il livello k + 1 contiene elementi, quindi il livello da cui estrarre è
+ * il bit acceso più significativo.
+ *
+ * Le celle di un livello sono numerate con una posizione crescente e la cella in posizione
+ * p è la p modulo capacità. Un elemento rimosso dal mezzo lascia una cella marcata come
+ * vuota, che viene scartata quando raggiunge la testa del livello; se le celle marcate
+ * superano gli elementi presenti il livello viene compattato, così lo spazio occupato
+ * resta proporzionale agli elementi e non al numero di operazioni.
+ *
+ * Come in queue.c, ogni elemento occupa uno slot di una tabella che ne registra la
+ * posizione, aggiornata quando la compattazione lo sposta. Un handle è la terna
+ * (livello, slot, sequenza): lo slot trova la cella in tempo costante e la sequenza, mai
+ * riusata, distingue l'elemento originale da uno inserito in seguito nello stesso slot.
+ *
+ * Per calcolare la posizione di un elemento senza scorrere il livello, un albero di Fenwick
+ * sulle celle conta le celle marcate: gli elementi davanti a quello in posizione p sono
+ * p - head meno le celle marcate nell'intervallo [head, p).
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "bucket_queue.h"
+
+#define INITIAL_LEVEL_CAPACITY 8
+#define INITIAL_SLOT_CAPACITY 8
+
+static char removed_marker;
+#define REMOVED ((void*)&removed_marker)   // Cella di un elemento rimosso dal mezzo
+
+// Cella di un livello: l'elemento e lo slot del suo handle
+typedef struct {
+    void* element;
+    int slot;
+} bucket_cell;
+
+// Slot della tabella degli handle
+typedef struct {
+    unsigned long sequence; // Sequenza dell'elemento che occupa lo slot (0 se libero)
+    unsigned long position; // Posizione della cella dell'elemento nel suo livello
+    int next_free;          // Prossimo slot libero, se lo slot è libero (-1 se nessuno)
+} bucket_slot;
+
+// Coda FIFO circolare di un livello
+typedef struct {
+    bucket_cell* cells;
+    unsigned long head;     // Posizione del primo elemento
+    unsigned long tail;     // Posizione del prossimo elemento inserito
+    int count;              // Elementi presenti (celle rimosse escluse)
+    int capacity;           // Dimensione del buffer (potenza di due, 0 se non allocato)
+    int* removed_tree;      // Albero di Fenwick (da 1) delle celle marcate come rimosse
+    int removed;            // Celle marcate tra head e tail
+} bucket_level;
+
+struct _bucket_queue {
+    bucket_level* levels;   // levels[p - 1] contiene gli elementi con priorità p
+    int num_levels;
+    uint32_t non_empty;     // Bit k acceso se il livello k + 1 non è vuoto
+    int size;
+    bucket_slot* slots;     // Tabella degli handle, uno slot per elemento presente
+    int slot_capacity;
+    int num_slots;          // Slot usati almeno una volta dall'ultimo svuotamento
+    int free_slot;          // Primo slot libero da riusare (-1 se nessuno)
+    unsigned long next_sequence;
+};
+
+// Funzione di utilità per trovare il livello non vuoto più alto (indice da 0)
+static int highest_level(uint32_t _mask) {
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(_mask);
+#else
+    int level = 0;
+    while (_mask >>= 1) level++;
+    return level;
+#endif
+}
+
+// Funzione di utilità per ottenere la cella di una posizione
+static bucket_cell* level_cell(bucket_level* _level, unsigned long _position) {
+    return &_level->cells[_position & (unsigned long)(_level->capacity - 1)];
+}
+
+// Funzione di utilità per aggiungere _delta al conteggio delle celle marcate nella cella _cell
+static void tree_add(int* _tree, int _capacity, int _cell, int _delta) {
+    for (int i = _cell + 1; i <= _capacity; i += i & -i) {
+        _tree[i] += _delta;
+    }
+}
+
+// Funzione di utilità per contare le celle marcate tra le celle [0, _cells)
+static int tree_prefix(const int* _tree, int _cells) {
+    int total = 0;
+    for (int i = _cells; i > 0; i -= i & -i) {
+        total += _tree[i];
+    }
+    return total;
+}
+
+// Funzione di utilità per contare le celle marcate tra le posizioni [_level->head, _position)
+static int removed_before(const bucket_level* _level, unsigned long _position) {
+    if (_level->removed == 0) return 0;
+
+    int start = (int)(_level->head & (unsigned long)(_level->capacity - 1));
+    int length = (int)(_position - _level->head);
+    if (start + length <= _level->capacity) {
+        return tree_prefix(_level->removed_tree, start + length) - tree_prefix(_level->removed_tree, start);
+    }
+
+    // L'intervallo attraversa la fine del buffer circolare
+    return tree_prefix(_level->removed_tree, _level->capacity) - tree_prefix(_level->removed_tree, start)
+         + tree_prefix(_level->removed_tree, start + length - _level->capacity);
+}
+
+// Funzione di utilità per togliere dal conteggio una cella marcata che esce dal livello
+static void forget_removed(bucket_level* _level, unsigned long _position) {
+    tree_add(_level->removed_tree, _level->capacity, (int)(_position & (unsigned long)(_level->capacity - 1)), -1);
+    _level->removed--;
+}
+
+// Funzione di utilità per raddoppiare il buffer di un livello mantenendo le posizioni
+static int grow_level(bucket_level* _level) {
+    int new_capacity = (_level->capacity == 0) ? INITIAL_LEVEL_CAPACITY : _level->capacity * 2;
+    bucket_cell* cells = (bucket_cell*)malloc(new_capacity * sizeof(bucket_cell));
+    int* removed_tree = (int*)calloc(new_capacity + 1, sizeof(int));
+    if (cells == NULL || removed_tree == NULL) {
+        free(cells);
+        free(removed_tree);
+        return BUCKET_QUEUE_ERROR_ALLOC;
+    }
+
+    for (unsigned long p = _level->head; p != _level->tail; p++) {
+        int cell = (int)(p & (unsigned long)(new_capacity - 1));
+        cells[cell] = *level_cell(_level, p);
+        if (cells[cell].element == REMOVED) tree_add(removed_tree, new_capacity, cell, 1);
+    }
+    free(_level->cells);
+    free(_level->removed_tree);
+    _level->cells = cells;
+    _level->removed_tree = removed_tree;
+    _level->capacity = new_capacity;
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+// Funzione di utilità per garantire spazio per _extra inserimenti nel livello
+static int reserve_level(bucket_level* _level, int _extra) {
+    while (_level->tail - _level->head + (unsigned long)_extra > (unsigned long)_level->capacity) {
+        if (grow_level(_level) != BUCKET_QUEUE_SUCCESS) return BUCKET_QUEUE_ERROR_ALLOC;
+    }
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+// Funzione di utilità per scartare le celle rimosse in testa a un livello non vuoto
+static void skip_removed(bucket_level* _level) {
+    while (level_cell(_level, _level->head)->element == REMOVED) {
+        forget_removed(_level, _level->head);
+        _level->head++;
+    }
+}
+
+// Funzione di utilità per svuotare un livello scartando le celle marcate rimaste
+static void reset_level(bucket_level* _level) {
+    for (unsigned long p = _level->head; p != _level->tail && _level->removed > 0; p++) {
+        if (level_cell(_level, p)->element == REMOVED) forget_removed(_level, p);
+    }
+    _level->head = _level->tail;
+    _level->count = 0;
+}
+
+// Funzione di utilità per scartare le celle marcate di un livello spostando gli elementi verso
+// la testa, nell'ordine in cui si trovano; le posizioni negli slot vengono aggiornate
+static void compact_level(bucket_queue _queue, bucket_level* _level) {
+    unsigned long write = _level->head;
+    for (unsigned long p = _level->head; p != _level->tail; p++) {
+        bucket_cell* cell = level_cell(_level, p);
+        if (cell->element == REMOVED) {
+            forget_removed(_level, p);
+            continue;
+        }
+        if (write != p) {
+            *level_cell(_level, write) = *cell;
+            _queue->slots[cell->slot].position = write;
+        }
+        write++;
+    }
+    _level->tail = write;
+}
+
+// Funzione di utilità per garantire uno slot libero per _extra nuovi elementi
+static int reserve_slots(bucket_queue _queue, int _extra) {
+    if (_queue->size + _extra <= _queue->slot_capacity) return BUCKET_QUEUE_SUCCESS;
+
+    int new_capacity = (_queue->slot_capacity == 0) ? INITIAL_SLOT_CAPACITY : _queue->slot_capacity;
+    while (new_capacity < _queue->size + _extra) new_capacity *= 2;
+
+    bucket_slot* slots = (bucket_slot*)realloc(_queue->slots, new_capacity * sizeof(bucket_slot));
+    if (slots == NULL) return BUCKET_QUEUE_ERROR_ALLOC;
+    _queue->slots = slots;
+    _queue->slot_capacity = new_capacity;
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+// Funzione di utilità per assegnare uno slot (già riservato) all'elemento in posizione _position
+static int take_slot(bucket_queue _queue, unsigned long _position) {
+    int slot = _queue->free_slot;
+    if (slot >= 0) {
+        _queue->free_slot = _queue->slots[slot].next_free;
+    } else {
+        slot = _queue->num_slots++;
+    }
+
+    _queue->slots[slot].sequence = _queue->next_sequence++;
+    _queue->slots[slot].position = _position;
+    return slot;
+}
+
+// Funzione di utilità per liberare lo slot di un elemento uscito dalla coda
+static void release_slot(bucket_queue _queue, int _slot) {
+    _queue->slots[_slot].sequence = 0;
+    _queue->slots[_slot].next_free = _queue->free_slot;
+    _queue->free_slot = _slot;
+}
+
+// Funzione di utilità per liberare tutti gli slot di una coda rimasta vuota
+static void reset_slots(bucket_queue _queue) {
+    _queue->num_slots = 0;
+    _queue->free_slot = -1;
+}
+
+// Funzione di utilità per aggiornare i contatori dopo l'uscita di un elemento dal livello
+static void level_left(bucket_queue _queue, int _index) {
+    bucket_level* level = &_queue->levels[_index];
+    level->count--;
+    if (level->count == 0) {
+        // Nessun elemento vivo: le eventuali celle rimosse possono essere scartate
+        reset_level(level);
+        _queue->non_empty &= ~((uint32_t)1 << _index);
+    }
+    _queue->size--;
+}
+
+// Funzione di utilità per trovare la cella di un handle ancora valido
+static bucket_cell* handle_cell(bucket_queue _queue, bucket_queue_handle _handle) {
+    if (_handle.priority < 1 || _handle.priority > _queue->num_levels) return NULL;
+    if (_handle.slot < 0 || _handle.slot >= _queue->num_slots) return NULL;
+
+    const bucket_slot* slot = &_queue->slots[_handle.slot];
+    if (slot->sequence == 0 || slot->sequence != _handle.sequence) return NULL;
+
+    bucket_level* level = &_queue->levels[_handle.priority - 1];
+    if (slot->position - level->head >= level->tail - level->head) return NULL;
+
+    bucket_cell* cell = level_cell(level, slot->position);
+    return (cell->element == REMOVED || cell->slot != _handle.slot) ? NULL : cell;
+}
+
+bucket_queue bucket_queue_create(int _num_levels) {
+    if (_num_levels < 1 || _num_levels > BUCKET_QUEUE_MAX_LEVELS) return NULL;
+
+    bucket_queue queue = (bucket_queue)malloc(sizeof(struct _bucket_queue));
+    if (queue == NULL) return NULL;
+
+    queue->levels = (bucket_level*)calloc(_num_levels, sizeof(bucket_level));
+    if (queue->levels == NULL) {
+        free(queue);
+        return NULL;
+    }
+
+    queue->num_levels = _num_levels;
+    queue->non_empty = 0;
+    queue->size = 0;
+    queue->slots = NULL;
+    queue->slot_capacity = 0;
+    queue->num_slots = 0;
+    queue->free_slot = -1;
+    queue->next_sequence = 1;   // Uno slot libero ha sequenza 0, che nessun handle riceve
+    return queue;
+}
+
+void bucket_queue_destroy(bucket_queue* _queue, void (*_free_element)(void*)) {
+    if (_queue == NULL || *_queue == NULL) return;
+
+    bucket_queue_clear(*_queue, _free_element);
+    for (int l = 0; l < (*_queue)->num_levels; l++) {
+        free((*_queue)->levels[l].cells);
+        free((*_queue)->levels[l].removed_tree);
+    }
+    free((*_queue)->levels);
+    free((*_queue)->slots);
+    free(*_queue);
+    *_queue = NULL;
+}
+
+int bucket_queue_enqueue(bucket_queue _queue, void* _element, int _priority, bucket_queue_handle* _handle_out) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (_priority < 1 || _priority > _queue->num_levels) return BUCKET_QUEUE_ERROR_PRIORITY;
+
+    bucket_level* level = &_queue->levels[_priority - 1];
+    if (reserve_slots(_queue, 1) != BUCKET_QUEUE_SUCCESS || reserve_level(level, 1) != BUCKET_QUEUE_SUCCESS) {
+        return BUCKET_QUEUE_ERROR_ALLOC;
+    }
+
+    bucket_cell* cell = level_cell(level, level->tail);
+    cell->element = _element;
+    cell->slot = take_slot(_queue, level->tail);
+    if (_handle_out != NULL) {
+        _handle_out->priority = _priority;
+        _handle_out->slot = cell->slot;
+        _handle_out->sequence = _queue->slots[cell->slot].sequence;
+    }
+    level->tail++;
+    level->count++;
+    _queue->non_empty |= (uint32_t)1 << (_priority - 1);
+    _queue->size++;
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+int bucket_queue_dequeue(bucket_queue _queue, void** _element_out) {
+    if (_queue == NULL || _element_out == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (_queue->non_empty == 0) return BUCKET_QUEUE_ERROR_EMPTY;
+
+    int l = highest_level(_queue->non_empty);
+    bucket_level* level = &_queue->levels[l];
+    skip_removed(level);
+    bucket_cell* cell = level_cell(level, level->head);
+    *_element_out = cell->element;
+    release_slot(_queue, cell->slot);
+    level->head++;
+
+    level_left(_queue, l);
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+int bucket_queue_peek(bucket_queue _queue, void** _element_out) {
+    if (_queue == NULL || _element_out == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (_queue->non_empty == 0) return BUCKET_QUEUE_ERROR_EMPTY;
+
+    bucket_level* level = &_queue->levels[highest_level(_queue->non_empty)];
+    skip_removed(level);
+    *_element_out = level_cell(level, level->head)->element;
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+int bucket_queue_remove(bucket_queue _queue, bucket_queue_handle _handle, void** _element_out) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+
+    bucket_cell* cell = handle_cell(_queue, _handle);
+    if (cell == NULL) return BUCKET_QUEUE_ERROR_NOT_FOUND;
+
+    if (_element_out != NULL) *_element_out = cell->element;
+    cell->element = REMOVED;
+
+    bucket_level* level = &_queue->levels[_handle.priority - 1];
+    unsigned long position = _queue->slots[_handle.slot].position;
+    tree_add(level->removed_tree, level->capacity, (int)(position & (unsigned long)(level->capacity - 1)), 1);
+    level->removed++;
+    release_slot(_queue, _handle.slot);
+
+    level_left(_queue, _handle.priority - 1);
+
+    // Ogni compattazione scarta più celle di quanti elementi sposta: il costo resta costante
+    // per rimozione e la finestra del livello non supera il doppio degli elementi presenti
+    if (level->removed > level->count) compact_level(_queue, level);
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+int bucket_queue_change_priority(bucket_queue _queue, bucket_queue_handle* _handle, int _priority) {
+    if (_queue == NULL || _handle == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (_priority < 1 || _priority > _queue->num_levels) return BUCKET_QUEUE_ERROR_PRIORITY;
+
+    bucket_cell* cell = handle_cell(_queue, *_handle);
+    if (cell == NULL) return BUCKET_QUEUE_ERROR_NOT_FOUND;
+    if (_handle->priority == _priority) return BUCKET_QUEUE_SUCCESS;
+
+    // Riserva lo spazio prima di toccare il livello di partenza, così un errore non perde
+    // l'elemento (lo slot liberato dalla rimozione viene riusato dall'inserimento)
+    if (reserve_level(&_queue->levels[_priority - 1], 1) != BUCKET_QUEUE_SUCCESS) {
+        return BUCKET_QUEUE_ERROR_ALLOC;
+    }
+
+    void* element = cell->element;
+    bucket_queue_remove(_queue, *_handle, NULL);
+    return bucket_queue_enqueue(_queue, element, _priority, _handle);
+}
+
+int bucket_queue_reserve_merge(bucket_queue _dest, bucket_queue _src) {
+    if (_dest == NULL || _src == NULL || _dest == _src) return BUCKET_QUEUE_ERROR_NULL;
+    if (_src->num_levels > _dest->num_levels) return BUCKET_QUEUE_ERROR_PRIORITY;
+
+    if (reserve_slots(_dest, _src->size) != BUCKET_QUEUE_SUCCESS) return BUCKET_QUEUE_ERROR_ALLOC;
+    for (int l = 0; l < _src->num_levels; l++) {
+        if (reserve_level(&_dest->levels[l], _src->levels[l].count) != BUCKET_QUEUE_SUCCESS) {
+            return BUCKET_QUEUE_ERROR_ALLOC;
+        }
+    }
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+int bucket_queue_merge(bucket_queue _dest, bucket_queue _src, void (*_moved)(void*, bucket_queue_handle, void*), void* _context) {
+    // Riserva tutto lo spazio prima di spostare, così un errore lascia entrambe le code intatte
+    int result = bucket_queue_reserve_merge(_dest, _src);
+    if (result != BUCKET_QUEUE_SUCCESS) return result;
+
+    for (int l = 0; l < _src->num_levels; l++) {
+        bucket_level* from = &_src->levels[l];
+        bucket_level* to = &_dest->levels[l];
+
+        for (unsigned long p = from->head; p != from->tail; p++) {
+            void* element = level_cell(from, p)->element;
+            if (element == REMOVED) continue;
+
+            bucket_cell* cell = level_cell(to, to->tail);
+            cell->element = element;
+            cell->slot = take_slot(_dest, to->tail);
+            to->tail++;
+
+            bucket_queue_handle handle = { l + 1, cell->slot, _dest->slots[cell->slot].sequence };
+            if (_moved != NULL) _moved(element, handle, _context);
+        }
+
+        to->count += from->count;
+        reset_level(from);
+    }
+
+    _dest->non_empty |= _src->non_empty;
+    _dest->size += _src->size;
+    _src->non_empty = 0;
+    _src->size = 0;
+    reset_slots(_src);
+    return BUCKET_QUEUE_SUCCESS;
+}
+
+int bucket_queue_rank(bucket_queue _queue, bucket_queue_handle _handle) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (handle_cell(_queue, _handle) == NULL) return BUCKET_QUEUE_ERROR_NOT_FOUND;
+
+    bucket_level* level = &_queue->levels[_handle.priority - 1];
+    unsigned long position = _queue->slots[_handle.slot].position;
+    int ahead = (int)(position - level->head) - removed_before(level, position);
+    return bucket_queue_count_ahead(_queue, _handle.priority + 1) + ahead;
+}
+
+int bucket_queue_count_ahead(bucket_queue _queue, int _priority) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (_priority < 1) _priority = 1;
+
+    // Somma solo i livelli non vuoti con priorità almeno _priority
+    int total = 0;
+    uint32_t mask = (_priority > _queue->num_levels) ? 0 : _queue->non_empty >> (_priority - 1);
+    for (int l = _priority - 1; mask != 0; l++, mask >>= 1) {
+        if (mask & 1) total += _queue->levels[l].count;
+    }
+    return total;
+}
+
+bool bucket_queue_contains(bucket_queue _queue, bucket_queue_handle _handle) {
+    return (_queue != NULL && handle_cell(_queue, _handle) != NULL);
+}
+
+int bucket_queue_size(bucket_queue _queue) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    return _queue->size;
+}
+
+int bucket_queue_level_size(bucket_queue _queue, int _priority) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+    if (_priority < 1 || _priority > _queue->num_levels) return BUCKET_QUEUE_ERROR_PRIORITY;
+    return _queue->levels[_priority - 1].count;
+}
+
+bool bucket_queue_is_empty(bucket_queue _queue) {
+    return (_queue == NULL || _queue->size == 0);
+}
+
+int bucket_queue_clear(bucket_queue _queue, void (*_free_element)(void*)) {
+    if (_queue == NULL) return BUCKET_QUEUE_ERROR_NULL;
+
+    for (int l = 0; l < _queue->num_levels; l++) {
+        bucket_level* level = &_queue->levels[l];
+
+        // Libera gli elementi se è fornita una funzione per farlo
+        for (unsigned long p = level->head; p != level->tail && _free_element != NULL; p++) {
+            void* element = level_cell(level, p)->element;
+            if (element != NULL && element != REMOVED) _free_element(element);
+        }
+
+        reset_level(level);
+    }
+
+    // Le sequenze non ripartono da zero: gli handle precedenti restano non validi
+    _queue->non_empty = 0;
+    _queue->size = 0;
+    reset_slots(_queue);
+    return BUCKET_QUEUE_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/*
+ * bucket_queue.h
+ *
+ * Interfaccia di un Tipo di Dato Astratto (ADT) per una coda con priorità a livelli
+ * fissi (1, 2, ..., num_levels). Ogni livello è una coda FIFO circolare e una maschera
+ * di bit indica i livelli non vuoti: inserimento ed estrazione richiedono tempo costante
+ * e, a parità di priorità, gli elementi escono nell'ordine di inserimento.
+ *
+ * Come in priority_queue, valori di priorità più alti vengono estratti per primi.
+ * Una coda con un solo livello si comporta come una semplice coda FIFO.
+ *
+ * L'inserimento restituisce un handle con cui, finché l'elemento resta in coda, è possibile
+ * rimuoverlo, verificarne la presenza o cambiarne la priorità in tempo costante e
+ * conoscerne la posizione in coda in tempo logaritmico. Lo spazio occupato resta
+ * proporzionale agli elementi presenti, anche dopo molti inserimenti e rimozioni.
+ */
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct _bucket_queue* bucket_queue;
+
+// Riferimento a un elemento in coda: livello, slot nella tabella degli handle e numero di sequenza
+typedef struct {
+    int priority;
+    int slot;
+    unsigned long sequence;
+} bucket_queue_handle;
+
+#define BUCKET_QUEUE_SUCCESS 0
+#define BUCKET_QUEUE_ERROR_NULL -1
+#define BUCKET_QUEUE_ERROR_ALLOC -2
+#define BUCKET_QUEUE_ERROR_EMPTY -3
+#define BUCKET_QUEUE_ERROR_PRIORITY -4
+#define BUCKET_QUEUE_ERROR_NOT_FOUND -5
+
+#define BUCKET_QUEUE_MAX_LEVELS 32   // Numero massimo di livelli (uno per bit della maschera)
+
+/*
+ * Crea una nuova coda a livelli vuota.
+ * @param _num_levels Numero di livelli di priorità (da 1 a BUCKET_QUEUE_MAX_LEVELS).
+ * @return Puntatore alla coda creata, oppure NULL se _num_levels non è valido
+ *         o fallisce l'allocazione.
+ */
+bucket_queue bucket_queue_create(int _num_levels);
+
+/*
+ * Distrugge la coda e libera la memoria.
+ * @param _queue Puntatore al puntatore della coda da distruggere.
+ *               Dopo la chiamata, *_queue sarà impostato a NULL.
+ * @param _free_element Funzione per liberare la memoria degli elementi (può essere NULL).
+ */
+void bucket_queue_destroy(bucket_queue* _queue, void (*_free_element)(void*));
+
+/*
+ * Inserisce un elemento in fondo al livello indicato.
+ * @param _queue Coda in cui inserire.
+ * @param _element Puntatore all'elemento da inserire.
+ * @param _priority Livello di priorità (da 1 a num_levels).
+ * @param _handle_out Puntatore dove salvare l'handle dell'elemento (può essere NULL).
+ * @return BUCKET_QUEUE_SUCCESS se inserito,
+ *         BUCKET_QUEUE_ERROR_NULL se _queue è NULL,
+ *         BUCKET_QUEUE_ERROR_PRIORITY se _priority è fuori dai livelli,
+ *         BUCKET_QUEUE_ERROR_ALLOC se fallisce l'allocazione.
+ */
+int bucket_queue_enqueue(bucket_queue _queue, void* _element, int _priority, bucket_queue_handle* _handle_out);
+
+/*
+ * Estrae il primo elemento del livello non vuoto più alto.
+ * @param _queue Coda da cui estrarre.
+ * @param _element_out Puntatore dove salvare il puntatore all'elemento estratto.
+ * @return BUCKET_QUEUE_SUCCESS se estratto,
+ *         BUCKET_QUEUE_ERROR_NULL se _queue o _element_out sono NULL,
+ *         BUCKET_QUEUE_ERROR_EMPTY se la coda è vuota.
+ */
+int bucket_queue_dequeue(bucket_queue _queue, void** _element_out);
+
+/*
+ * Restituisce il prossimo elemento da estrarre senza rimuoverlo.
+ * @param _queue Coda da cui leggere.
+ * @param _element_out Puntatore dove salvare il puntatore all'elemento.
+ * @return BUCKET_QUEUE_SUCCESS se trovato,
+ *         BUCKET_QUEUE_ERROR_NULL se _queue o _element_out sono NULL,
+ *         BUCKET_QUEUE_ERROR_EMPTY se la coda è vuota.
+ */
+int bucket_queue_peek(bucket_queue _queue, void** _element_out);
+
+/*
+ * Rimuove l'elemento indicato dall'handle, ovunque si trovi nella coda.
+ * @param _queue Coda da cui rimuovere.
+ * @param _handle Handle restituito dall'inserimento.
+ * @param _element_out Puntatore dove salvare il puntatore all'elemento rimosso (può essere NULL).
+ * @return BUCKET_QUEUE_SUCCESS se rimosso,
+ *         BUCKET_QUEUE_ERROR_NULL se _queue è NULL,
+ *         BUCKET_QUEUE_ERROR_NOT_FOUND se l'elemento non è più in coda.
+ */
+int bucket_queue_remove(bucket_queue _queue, bucket_queue_handle _handle, void** _element_out);
+
+/*
+ * Sposta l'elemento indicato dall'handle in fondo a un altro livello di priorità.
+ * Se la priorità non cambia l'elemento mantiene la sua posizione.
+ * @param _queue Coda da modificare.
+ * @param _handle Handle dell'elemento; in caso di successo viene aggiornato con il nuovo handle.
+ * @param _priority Nuovo livello di priorità.
+ * @return BUCKET_QUEUE_SUCCESS se modificato,
+ *         BUCKET_QUEUE_ERROR_NULL se _queue o _handle sono NULL,
+ *         BUCKET_QUEUE_ERROR_PRIORITY se _priority è fuori dai livelli,
+ *         BUCKET_QUEUE_ERROR_NOT_FOUND se l'elemento non è più in coda,
+ *         BUCKET_QUEUE_ERROR_ALLOC se fallisce l'allocazione (l'elemento resta dov'era).
+ */
+int bucket_queue_change_priority(bucket_queue _queue, bucket_queue_handle* _handle, int _priority);
+
+/*
+ * Sposta tutti gli elementi di _src in fondo ai livelli corrispondenti di _dest, mantenendo
+ * l'ordine FIFO di ciascun livello; al termine _src è vuota. Vengono copiati solo i puntatori,
+ * senza allocazioni per elemento. Gli handle degli elementi spostati cambiano: se fornita,
+ * _moved viene chiamata per ogni elemento con il nuovo handle.
+ * @param _dest Coda di destinazione.
+ * @param _src Coda da svuotare (deve essere diversa da _dest).
+ * @param _moved Funzione chiamata per ogni elemento spostato (può essere NULL).
+ * @param _context Puntatore passato a _moved.
+ * @return BUCKET_QUEUE_SUCCESS se spostati,
+ *         BUCKET_QUEUE_ERROR_NULL se le code sono NULL o coincidono,
+ *         BUCKET_QUEUE_ERROR_PRIORITY se _src ha più livelli di _dest,
+ *         BUCKET_QUEUE_ERROR_ALLOC se fallisce l'allocazione (nessun elemento viene spostato).
+ */
+int bucket_queue_merge(bucket_queue _dest, bucket_queue _src, void (*_moved)(void*, bucket_queue_handle, void*), void* _context);
+
+/*
+ * Riserva in _dest lo spazio per ricevere tutti gli elementi di _src, senza spostarli: dopo
+ * un esito positivo bucket_queue_merge(_dest, _src, ...) non può fallire finché le due code
+ * non vengono modificate. Serve a spostare più code insieme in modo atomico.
+ * @param _dest Coda di destinazione.
+ * @param _src Coda da cui verranno spostati gli elementi (deve essere diversa da _dest).
+ * @return BUCKET_QUEUE_SUCCESS se riservato,
+ *         BUCKET_QUEUE_ERROR_NULL se le code sono NULL o coincidono,
+ *         BUCKET_QUEUE_ERROR_PRIORITY se _src ha più livelli di _dest,
+ *         BUCKET_QUEUE_ERROR_ALLOC se fallisce l'allocazione.
+ */
+int bucket_queue_reserve_merge(bucket_queue _dest, bucket_queue _src);
+
+/*
+ * Restituisce la posizione dell'elemento indicato dall'handle, cioè il numero di elementi
+ * che verranno estratti prima di lui.
+ * @param _queue Coda da interrogare.
+ * @param _handle Handle restituito dall'inserimento.
+ * @return Posizione dell'elemento (0 se è il prossimo a uscire),
+ *         BUCKET_QUEUE_ERROR_NULL se _queue è NULL,
+ *         BUCKET_QUEUE_ERROR_NOT_FOUND se l'elemento non è più in coda.
+ */
+int bucket_queue_rank(bucket_queue _queue, bucket_queue_handle _handle);
+
+/*
+ * Restituisce il numero di elementi con priorità almeno _priority, cioè quelli che
+ * precederebbero un elemento inserito ora con priorità _priority.
+ * @param _queue Coda da interrogare.
+ * @param _priority Livello di priorità.
+ * @return Numero di elementi, oppure BUCKET_QUEUE_ERROR_NULL se _queue è NULL.
+ */
+int bucket_queue_count_ahead(bucket_queue _queue, int _priority);
+
+/*
+ * Verifica se l'elemento indicato dall'handle è ancora in coda.
+ * @param _queue Coda da verificare.
+ * @param _handle Handle restituito dall'inserimento.
+ * @return true se l'elemento è in coda, false altrimenti o se _queue è NULL.
+ */
+bool bucket_queue_contains(bucket_queue _queue, bucket_queue_handle _handle);
+
+/*
+ * Restituisce il numero totale di elementi nella coda.
+ * @param _queue Coda da interrogare.
+ * @return Numero di elementi, oppure BUCKET_QUEUE_ERROR_NULL se _queue è NULL.
+ */
+int bucket_queue_size(bucket_queue _queue);
+
+/*
+ * Restituisce il numero di elementi in un livello.
+ * @param _queue Coda da interrogare.
+ * @param _priority Livello di priorità.
+ * @return Numero di elementi del livello, BUCKET_QUEUE_ERROR_NULL se _queue è NULL,
+ *         BUCKET_QUEUE_ERROR_PRIORITY se _priority è fuori dai livelli.
+ */
+int bucket_queue_level_size(bucket_queue _queue, int _priority);
+
+/*
+ * Verifica se la coda è vuota.
+ * @param _queue Coda da verificare.
+ * @return true se vuota o NULL, false altrimenti.
+ */
+bool bucket_queue_is_empty(bucket_queue _queue);
+
+/*
+ * Svuota la coda, rimuovendo tutti gli elementi.
+ * @param _queue Coda da svuotare.
+ * @param _free_element Funzione per liberare la memoria degli elementi (può essere NULL).
+ * @return BUCKET_QUEUE_SUCCESS se svuotata,
+ *         BUCKET_QUEUE_ERROR_NULL se _queue è NULL.
+ */
+int bucket_queue_clear(bucket_queue _queue, void (*_free_element)(void*));
+
+#endif /* BUCKET_QUEUE_H */
@@ -8,6 +8,7 @@ struct Carico {
     int priorita;            // Priorità del carico (1-5)
     Node centro_smistamento; // Nodo del grafo associato al centro di smistamento
     Missione missione;       // Missione associata al carico
+    bucket_queue_handle coda; // Posizione nella coda del centro di smistamento
 };
 
 Carico carico_create(int _id, int _peso, TipoCarico _tipologia, 
@@ -25,6 +26,8 @@ Carico carico_create(int _id, int _peso, TipoCarico _tipologia,
     carico->priorita = _priorita;
     carico->centro_smistamento = _centro_smistamento;
     carico->missione = NULL;
+    carico->coda.priority = 0;  // Nessun livello: non ancora in coda
+    carico->coda.sequence = 0;
 
     return carico;
 }
@@ -62,11 +65,24 @@ int carico_get_priorita(Carico _carico) {
     return _carico->priorita;
 }
 
+int carico_set_priorita(Carico _carico, int _priorita) {
+    if (_carico == NULL) return -1;
+    if (_priorita < 1 || _priorita > 5) return -1;  // Priorità deve essere tra 1 e 5
+    _carico->priorita = _priorita;
+    return 0;
+}
+
 Node carico_get_centro_smistamento(Carico _carico) {
     if (_carico == NULL) return NULL;
     return _carico->centro_smistamento;
 }
 
+int carico_set_centro_smistamento(Carico _carico, Node _centro_smistamento) {
+    if (_carico == NULL || _centro_smistamento == NULL) return -1;
+    _carico->centro_smistamento = _centro_smistamento;
+    return 0;
+}
+
 Missione carico_get_missione(Carico _carico) {
     if (_carico == NULL) return NULL;
     return _carico->missione;
@@ -78,6 +94,20 @@ int carico_set_missione(Carico _carico, Missione _missione) {
     return 0;
 }
 
+bucket_queue_handle carico_get_handle_coda(Carico _carico) {
+    if (_carico == NULL) {
+        bucket_queue_handle nessuno = { 0, 0, 0 };
+        return nessuno;
+    }
+    return _carico->coda;
+}
+
+int carico_set_handle_coda(Carico _carico, bucket_queue_handle _handle) {
+    if (_carico == NULL) return -1;
+    _carico->coda = _handle;
+    return 0;
+}
+
 const char* carico_tipo_to_string(TipoCarico _tipo) {
     switch (_tipo) {
         case CARICO_STANDARD:
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include "weighted_directed_graph.h"
 #include "missione.h"
+#include "bucket_queue.h"
 
 typedef struct Carico* Carico;
 
@@ -68,6 +69,14 @@ Node carico_get_destinazione(Carico _carico);
  */
 int carico_get_priorita(Carico _carico);
 
+/*
+ * Imposta la priorità del carico
+ * @param _carico Carico da modificare
+ * @param _priorita Nuova priorità (1-5)
+ * @return 0 se impostata con successo, -1 altrimenti
+ */
+int carico_set_priorita(Carico _carico, int _priorita);
+
 /*
  * Restituisce il nodo del centro di smistamento del carico
  * @param _carico Carico da cui leggere
@@ -75,6 +84,14 @@ int carico_get_priorita(Carico _carico);
  */
 Node carico_get_centro_smistamento(Carico _carico);
 
+/*
+ * Imposta il nodo del centro di smistamento del carico
+ * @param _carico Carico da modificare
+ * @param _centro_smistamento Nodo del grafo associato al nuovo centro di smistamento
+ * @return 0 se impostato con successo, -1 altrimenti
+ */
+int carico_set_centro_smistamento(Carico _carico, Node _centro_smistamento);
+
 /*
  * Restituisce la missione associata al carico
  * @param _carico Carico da cui leggere
@@ -90,6 +107,21 @@ Missione carico_get_missione(Carico _carico);
  */
 int carico_set_missione(Carico _carico, Missione _missione);
 
+/*
+ * Restituisce l'handle del carico nella coda del centro di smistamento
+ * @param _carico Carico da cui leggere
+ * @return Handle dell'ultimo inserimento in coda (non più valido se il carico è stato estratto)
+ */
+bucket_queue_handle carico_get_handle_coda(Carico _carico);
+
+/*
+ * Imposta l'handle del carico nella coda del centro di smistamento
+ * @param _carico Carico da modificare
+ * @param _handle Handle restituito dall'inserimento in coda
+ * @return 0 se impostato con successo, -1 altrimenti
+ */
+int carico_set_handle_coda(Carico _carico, bucket_queue_handle _handle);
+
 /*
  * Restituisce una stringa che rappresenta il tipo del carico
  * @param _tipo Tipo del carico
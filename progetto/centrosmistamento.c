@@ -1,12 +1,14 @@
 #include "centrosmistamento.h"
 #include <string.h>
 
+#define PRIORITA_MAX_CARICO 5   // Livelli di priorità dei carichi (da 1 a 5)
+
 struct CentroSmistamento {
     int id;                      
-    char* nome;                  
+    const char* nome;           // Non posseduto: internato dal gestore
     Node nodo;                 
-    priority_queue carichi;     
-    priority_queue veicoli;     
+    bucket_queue carichi;       // Un livello FIFO per ogni priorità
+    bucket_queue veicoli;       // Un solo livello: coda FIFO
 };
 
 CentroSmistamento centro_smistamento_create(int _id, const char* _nome, Node _nodo) {
@@ -16,25 +18,19 @@ CentroSmistamento centro_smistamento_create(int _id, const char* _nome, Node _no
     if (centro == NULL) return NULL;
 
     centro->id = _id;
-    centro->nome = strdup(_nome);
-    if (centro->nome == NULL) {
-        free(centro);
-        return NULL;
-    }
+    centro->nome = _nome;
 
     centro->nodo = _nodo;
 
-    centro->carichi = priority_queue_create();
+    centro->carichi = bucket_queue_create(PRIORITA_MAX_CARICO);
     if (centro->carichi == NULL) {
-        free(centro->nome);
         free(centro);
         return NULL;
     }
 
-    centro->veicoli = priority_queue_create();
+    centro->veicoli = bucket_queue_create(1);
     if (centro->veicoli == NULL) {
-        priority_queue_destroy(&(centro->carichi), NULL);
-        free(centro->nome);
+        bucket_queue_destroy(&(centro->carichi), NULL);
         free(centro);
         return NULL;
     }
@@ -45,14 +41,11 @@ CentroSmistamento centro_smistamento_create(int _id, const char* _nome, Node _no
 void centro_smistamento_destroy(CentroSmistamento* _centro) {
     if (_centro == NULL || *_centro == NULL) return;
 
-    // Libera il nome
-    free((*_centro)->nome);
-
     // Libera le code
     // Nota: non liberiamo i carichi e i veicoli stessi, poiché potrebbero essere
     // referenziati altrove
-    priority_queue_destroy(&((*_centro)->carichi), NULL);
-    priority_queue_destroy(&((*_centro)->veicoli), NULL);
+    bucket_queue_destroy(&((*_centro)->carichi), NULL);
+    bucket_queue_destroy(&((*_centro)->veicoli), NULL);
 
     // Libera la struttura
     free(*_centro);
@@ -74,48 +67,87 @@ Node centro_smistamento_get_nodo(CentroSmistamento _centro) {
     return _centro->nodo;
 }
 
-int centro_smistamento_add_carico(CentroSmistamento _centro, void* _carico, int _priorita) {
+int centro_smistamento_add_carico(CentroSmistamento _centro, void* _carico, int _priorita, bucket_queue_handle* _handle_out) {
     if (_centro == NULL || _carico == NULL) return -1;
-    if (_priorita < 1 || _priorita > 5) return -1;  // Priorità deve essere tra 1 e 5
+    if (_priorita < 1 || _priorita > PRIORITA_MAX_CARICO) return -1;  // Priorità deve essere tra 1 e 5
     
-    return priority_queue_enqueue(_centro->carichi, _carico, _priorita);
+    return bucket_queue_enqueue(_centro->carichi, _carico, _priorita, _handle_out);
+}
+
+int centro_smistamento_remove_carico(CentroSmistamento _centro, bucket_queue_handle _handle) {
+    if (_centro == NULL) return -1;
+    return bucket_queue_remove(_centro->carichi, _handle, NULL) == BUCKET_QUEUE_SUCCESS ? 0 : -1;
+}
+
+int centro_smistamento_change_priorita_carico(CentroSmistamento _centro, bucket_queue_handle* _handle, int _priorita) {
+    if (_centro == NULL || _handle == NULL) return -1;
+    if (_priorita < 1 || _priorita > PRIORITA_MAX_CARICO) return -1;  // Priorità deve essere tra 1 e 5
+
+    return bucket_queue_change_priority(_centro->carichi, _handle, _priorita) == BUCKET_QUEUE_SUCCESS ? 0 : -1;
+}
+
+int centro_smistamento_contains_carico(CentroSmistamento _centro, bucket_queue_handle _handle) {
+    if (_centro == NULL) return 0;
+    return bucket_queue_contains(_centro->carichi, _handle) ? 1 : 0;
 }
 
 int centro_smistamento_get_next_carico(CentroSmistamento _centro, void** _carico_out) {
     if (_centro == NULL || _carico_out == NULL) return -1;
     
-    return priority_queue_dequeue(_centro->carichi, _carico_out);
+    return bucket_queue_dequeue(_centro->carichi, _carico_out);
 }
 
 int centro_smistamento_get_num_carichi(CentroSmistamento _centro) {
     if (_centro == NULL) return -1;
-    return priority_queue_size(_centro->carichi);
+    return bucket_queue_size(_centro->carichi);
 }
 
 int centro_smistamento_has_carichi(CentroSmistamento _centro) {
     if (_centro == NULL) return 0;
-    return priority_queue_is_empty(_centro->carichi) ? 0 : 1;
+    return bucket_queue_is_empty(_centro->carichi) ? 0 : 1;
+}
+
+int centro_smistamento_get_posizione_carico(CentroSmistamento _centro, bucket_queue_handle _handle) {
+    if (_centro == NULL) return -1;
+
+    int posizione = bucket_queue_rank(_centro->carichi, _handle);
+    return (posizione >= 0) ? posizione : -1;
+}
+
+int centro_smistamento_transfer_backlog(CentroSmistamento _dest, CentroSmistamento _src,
+                                        void (*_carico_spostato)(void*, bucket_queue_handle, void*), void* _context) {
+    if (_dest == NULL || _src == NULL || _dest == _src) return -1;
+
+    // Riserva lo spazio in entrambe le code prima di spostare: dopo, gli spostamenti non possono fallire
+    if (bucket_queue_reserve_merge(_dest->carichi, _src->carichi) != BUCKET_QUEUE_SUCCESS ||
+        bucket_queue_reserve_merge(_dest->veicoli, _src->veicoli) != BUCKET_QUEUE_SUCCESS) {
+        return -1;
+    }
+
+    bucket_queue_merge(_dest->carichi, _src->carichi, _carico_spostato, _context);
+    bucket_queue_merge(_dest->veicoli, _src->veicoli, NULL, NULL);
+    return 0;
 }
 
 int centro_smistamento_add_veicolo(CentroSmistamento _centro, void* _veicolo) {
     if (_centro == NULL || _veicolo == NULL) return -1;
     
     // I veicoli vengono inseriti con priorità 1 (FIFO)
-    return priority_queue_enqueue(_centro->veicoli, _veicolo, 1);
+    return bucket_queue_enqueue(_centro->veicoli, _veicolo, 1, NULL);
 }
 
 int centro_smistamento_get_next_veicolo(CentroSmistamento _centro, void** _veicolo_out) {
     if (_centro == NULL || _veicolo_out == NULL) return -1;
     
-    return priority_queue_dequeue(_centro->veicoli, _veicolo_out);
+    return bucket_queue_dequeue(_centro->veicoli, _veicolo_out);
 }
 
 int centro_smistamento_get_num_veicoli(CentroSmistamento _centro) {
     if (_centro == NULL) return -1;
-    return priority_queue_size(_centro->veicoli);
+    return bucket_queue_size(_centro->veicoli);
 }
 
 int centro_smistamento_has_veicoli(CentroSmistamento _centro) {
     if (_centro == NULL) return 0;
-    return priority_queue_is_empty(_centro->veicoli) ? 0 : 1;
+    return bucket_queue_is_empty(_centro->veicoli) ? 0 : 1;
 } 
\ No newline at end of file
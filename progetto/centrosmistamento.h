@@ -2,7 +2,7 @@
 #define CENTRO_SMISTAMENTO_H
 
 #include <stdlib.h>
-#include "queue.h"
+#include "bucket_queue.h"
 #include "weighted_directed_graph.h"
 
 typedef struct CentroSmistamento* CentroSmistamento;
@@ -10,7 +10,7 @@ typedef struct CentroSmistamento* CentroSmistamento;
 /*
  * Crea un nuovo centro di smistamento
  * @param _id Identificativo del centro di smistamento
- * @param _nome Nome del centro di smistamento
+ * @param _nome Nome del centro di smistamento (non viene copiato: deve restare valido per tutta la vita del centro)
  * @param _nodo Nodo del grafo associato al centro di smistamento
  * @return Puntatore al centro di smistamento creato, oppure NULL in caso di errore
  */
@@ -48,9 +48,35 @@ Node centro_smistamento_get_nodo(CentroSmistamento _centro);
  * @param _centro Centro di smistamento a cui aggiungere il carico
  * @param _carico Carico da aggiungere
  * @param _priorita Priorità del carico
+ * @param _handle_out Puntatore dove salvare l'handle del carico in coda (può essere NULL)
  * @return 0 se aggiunto con successo, -1 altrimenti
  */
-int centro_smistamento_add_carico(CentroSmistamento _centro, void* _carico, int _priorita);
+int centro_smistamento_add_carico(CentroSmistamento _centro, void* _carico, int _priorita, bucket_queue_handle* _handle_out);
+
+/*
+ * Rimuove un carico dalla coda del centro di smistamento, ovunque si trovi
+ * @param _centro Centro di smistamento da cui rimuovere
+ * @param _handle Handle restituito dall'inserimento del carico
+ * @return 0 se rimosso con successo, -1 se il carico non è in coda o _centro è NULL
+ */
+int centro_smistamento_remove_carico(CentroSmistamento _centro, bucket_queue_handle _handle);
+
+/*
+ * Cambia la priorità di un carico in coda; il carico passa in fondo al nuovo livello
+ * @param _centro Centro di smistamento da modificare
+ * @param _handle Handle del carico, aggiornato in caso di successo
+ * @param _priorita Nuova priorità del carico
+ * @return 0 se modificata con successo, -1 altrimenti
+ */
+int centro_smistamento_change_priorita_carico(CentroSmistamento _centro, bucket_queue_handle* _handle, int _priorita);
+
+/*
+ * Verifica se un carico è ancora in coda nel centro di smistamento
+ * @param _centro Centro di smistamento da verificare
+ * @param _handle Handle restituito dall'inserimento del carico
+ * @return 1 se il carico è in coda, 0 altrimenti
+ */
+int centro_smistamento_contains_carico(CentroSmistamento _centro, bucket_queue_handle _handle);
 
 /*
  * Estrae il carico con la priorità più alta dalla coda del centro di smistamento
@@ -74,6 +100,27 @@ int centro_smistamento_get_num_carichi(CentroSmistamento _centro);
  */
 int centro_smistamento_has_carichi(CentroSmistamento _centro);
 
+/*
+ * Restituisce la posizione di un carico nella coda del centro di smistamento
+ * @param _centro Centro di smistamento da cui leggere
+ * @param _handle Handle restituito dall'inserimento del carico
+ * @return Numero di carichi che verranno estratti prima (0 se è il prossimo),
+ *         oppure -1 se il carico non è in coda o _centro è NULL
+ */
+int centro_smistamento_get_posizione_carico(CentroSmistamento _centro, bucket_queue_handle _handle);
+
+/*
+ * Sposta in coda a un centro di smistamento tutti i carichi e i veicoli in attesa in un altro,
+ * mantenendo l'ordine di ciascun livello di priorità
+ * @param _dest Centro di smistamento che riceve le code
+ * @param _src Centro di smistamento da svuotare
+ * @param _carico_spostato Funzione chiamata per ogni carico spostato con il suo nuovo handle (può essere NULL)
+ * @param _context Puntatore passato a _carico_spostato
+ * @return 0 se spostate con successo, -1 altrimenti (in tal caso nessuna coda viene modificata)
+ */
+int centro_smistamento_transfer_backlog(CentroSmistamento _dest, CentroSmistamento _src,
+                                        void (*_carico_spostato)(void*, bucket_queue_handle, void*), void* _context);
+
 /*
  * Aggiunge un veicolo alla coda del centro di smistamento
  * @param _centro Centro di smistamento a cui aggiungere il veicolo
@@ -14,8 +14,13 @@ struct _dynamic_array {
     int size;           
     int capacity;      
     size_t element_size; 
+    double growth_factor;   // Fattore di crescita della capacità quando l'array è pieno
+    int (*sorted_by)(const void*, const void*);   // Confronto secondo cui l'array è ordinato (NULL se non noto)
 };
 
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
 dynamic_array dynamic_array_create(int _initial_capacity, size_t _element_size) {
     if (_initial_capacity <= 0 || _element_size <= 0) {
         return NULL;
@@ -35,6 +40,8 @@ dynamic_array dynamic_array_create(int _initial_capacity, size_t _element_size)
     array->size = 0;
     array->capacity = _initial_capacity;
     array->element_size = _element_size;
+    array->growth_factor = GROWTH_FACTOR;
+    array->sorted_by = NULL;
 
     return array;
 }
@@ -57,30 +64,49 @@ void dynamic_array_destroy(dynamic_array* _array, void (*_free_element)(void*))
     *_array = NULL;
 }
 
-// Funzione interna per espandere l'array quando necessario
-static int _dynamic_array_ensure_capacity(dynamic_array _array) {
-    if (_array->size >= _array->capacity) {
-        int new_capacity = _array->capacity * GROWTH_FACTOR;
-        void* new_data = realloc(_array->data, new_capacity * _array->element_size);
-        if (new_data == NULL) {
-            return DYN_ARRAY_ERROR_ALLOC;
-        }
-        _array->data = new_data;
-        _array->capacity = new_capacity;
-        }
+// Funzione interna per reimpostare la capacità dell'array
+static int _dynamic_array_set_capacity(dynamic_array _array, int _capacity) {
+    void* new_data = realloc(_array->data, _capacity * _array->element_size);
+    if (new_data == NULL) {
+        return DYN_ARRAY_ERROR_ALLOC;
+    }
+    _array->data = new_data;
+    _array->capacity = _capacity;
     return DYN_ARRAY_SUCCESS;
 }
 
+// Funzione interna per espandere l'array quando necessario, secondo il fattore di crescita
+static int _dynamic_array_ensure_capacity(dynamic_array _array, int _needed) {
+    if (_needed <= _array->capacity) {
+        return DYN_ARRAY_SUCCESS;
+    }
+
+    int new_capacity = _array->capacity;
+    while (new_capacity < _needed) {
+        int grown = (int)(new_capacity * _array->growth_factor);
+        new_capacity = (grown > new_capacity) ? grown : new_capacity + 1;
+    }
+    return _dynamic_array_set_capacity(_array, new_capacity);
+}
+
 int dynamic_array_append(dynamic_array _array, void* _element) {
     if (_array == NULL || _element == NULL) {
         return DYN_ARRAY_ERROR_NULL;
     }
 
-    int result = _dynamic_array_ensure_capacity(_array);
+    int result = _dynamic_array_ensure_capacity(_array, _array->size + 1);
     if (result != DYN_ARRAY_SUCCESS) {
         return result;
     }
 
+    // Un elemento aggiunto fuori ordine fa perdere l'ordinamento mantenuto
+    if (_array->sorted_by != NULL && _array->size > 0) {
+        void* last = (char*)(_array->data) + (_array->size - 1) * _array->element_size;
+        if (_array->sorted_by(last, _element) > 0) {
+            _array->sorted_by = NULL;
+        }
+    }
+
     // Calcola l'indirizzo di destinazione e copia l'elemento
     void* dest = (char*)(_array->data) + _array->size * _array->element_size;
     memcpy(dest, _element, _array->element_size);
@@ -98,7 +124,7 @@ int dynamic_array_insert_at(dynamic_array _array, int _index, void* _element) {
         return DYN_ARRAY_ERROR_INDEX;
     }
 
-    int result = _dynamic_array_ensure_capacity(_array);
+    int result = _dynamic_array_ensure_capacity(_array, _array->size + 1);
     if (result != DYN_ARRAY_SUCCESS) {
         return result;
     }
@@ -115,6 +141,7 @@ int dynamic_array_insert_at(dynamic_array _array, int _index, void* _element) {
     void* dest = (char*)(_array->data) + _index * _array->element_size;
     memcpy(dest, _element, _array->element_size);
     _array->size++;
+    _array->sorted_by = NULL;
 
     return DYN_ARRAY_SUCCESS;
 }
@@ -146,6 +173,102 @@ int dynamic_array_remove_at(dynamic_array _array, int _index, void (*_free_eleme
     return DYN_ARRAY_SUCCESS;
 }
 
+int dynamic_array_append_n(dynamic_array _array, const void* _elements, int _count) {
+    if (_array == NULL || (_elements == NULL && _count > 0)) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    if (_count < 0) {
+        return DYN_ARRAY_ERROR_INDEX;
+    }
+
+    int result = _dynamic_array_ensure_capacity(_array, _array->size + _count);
+    if (result != DYN_ARRAY_SUCCESS) {
+        return result;
+    }
+
+    // Copia tutti gli elementi in un'unica operazione
+    if (_count > 0) {
+        void* dest = (char*)(_array->data) + _array->size * _array->element_size;
+        memcpy(dest, _elements, _count * _array->element_size);
+        _array->size += _count;
+        _array->sorted_by = NULL;
+    }
+
+    return DYN_ARRAY_SUCCESS;
+}
+
+int dynamic_array_swap_remove(dynamic_array _array, int _index, void (*_free_element)(void*)) {
+    if (_array == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    if (_index < 0 || _index >= _array->size) {
+        return DYN_ARRAY_ERROR_INDEX;
+    }
+
+    void* element = (char*)(_array->data) + _index * _array->element_size;
+    if (_free_element != NULL) {
+        _free_element(element);
+    }
+
+    // L'ultimo elemento prende il posto di quello rimosso
+    if (_index < _array->size - 1) {
+        void* last = (char*)(_array->data) + (_array->size - 1) * _array->element_size;
+        memcpy(element, last, _array->element_size);
+        _array->sorted_by = NULL;
+    }
+
+    _array->size--;
+    return DYN_ARRAY_SUCCESS;
+}
+
+int dynamic_array_reserve(dynamic_array _array, int _capacity) {
+    if (_array == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    if (_capacity <= _array->capacity) {
+        return DYN_ARRAY_SUCCESS;
+    }
+
+    return _dynamic_array_set_capacity(_array, _capacity);
+}
+
+int dynamic_array_shrink_to_fit(dynamic_array _array) {
+    if (_array == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    // La capacità minima resta 1, come alla creazione
+    int new_capacity = (_array->size > 0) ? _array->size : 1;
+    if (new_capacity == _array->capacity) {
+        return DYN_ARRAY_SUCCESS;
+    }
+
+    return _dynamic_array_set_capacity(_array, new_capacity);
+}
+
+int dynamic_array_set_growth_factor(dynamic_array _array, double _growth_factor) {
+    if (_array == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    if (!(_growth_factor > 1.0)) {
+        return DYN_ARRAY_ERROR_INDEX;
+    }
+
+    _array->growth_factor = _growth_factor;
+    return DYN_ARRAY_SUCCESS;
+}
+
+int dynamic_array_capacity(dynamic_array _array) {
+    if (_array == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+    return _array->capacity;
+}
+
 void* dynamic_array_get_at(dynamic_array _array, int _index) {
     if (_array == NULL || _index < 0 || _index >= _array->size) {
         return NULL;
@@ -170,15 +293,155 @@ int dynamic_array_sort(dynamic_array _array, int (*_compare)(const void*, const
         return DYN_ARRAY_ERROR_NULL;
     }
 
+    // Da qui in poi l'array è mantenuto ordinato secondo _compare
     qsort(_array->data, _array->size, _array->element_size, _compare);
+    _array->sorted_by = _compare;
+    return DYN_ARRAY_SUCCESS;
+}
+
+int dynamic_array_sort_by_key(dynamic_array _array, int (*_key)(const void*)) {
+    if (_array == NULL || _key == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    int n = _array->size;
+    if (n < 2) {
+        return DYN_ARRAY_SUCCESS;
+    }
+
+    // Chiavi calcolate una sola volta e rese senza segno conservando l'ordine (bit di segno invertito)
+    // Il buffer ha la stessa capacità dell'array perché, dopo un numero dispari di passate, lo sostituisce
+    unsigned int* keys = malloc(2 * n * sizeof(unsigned int));
+    void* buffer = malloc(_array->capacity * _array->element_size);
+    if (keys == NULL || buffer == NULL) {
+        free(keys);
+        free(buffer);
+        return DYN_ARRAY_ERROR_ALLOC;
+    }
+    unsigned int* keys_buffer = keys + n;
+
+    for (int i = 0; i < n; i++) {
+        void* element = (char*)(_array->data) + i * _array->element_size;
+        keys[i] = (unsigned int)_key(element) ^ 0x80000000u;
+    }
+
+    // Ordinamento radix LSD, stabile: una passata di conteggio per ogni cifra da RADIX_BITS bit
+    char* src = _array->data;
+    char* dest = buffer;
+    for (int shift = 0; shift < (int)(sizeof(unsigned int) * 8); shift += RADIX_BITS) {
+        int count[RADIX_BUCKETS] = {0};
+        for (int i = 0; i < n; i++) {
+            count[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+
+        // Se tutte le chiavi hanno la stessa cifra la passata non cambia nulla
+        if (count[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n) {
+            continue;
+        }
+
+        int start = 0;
+        for (int d = 0; d < RADIX_BUCKETS; d++) {
+            int c = count[d];
+            count[d] = start;
+            start += c;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int pos = count[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            memcpy(dest + pos * _array->element_size, src + i * _array->element_size, _array->element_size);
+            keys_buffer[pos] = keys[i];
+        }
+
+        char* swap_data = src;
+        src = dest;
+        dest = swap_data;
+        unsigned int* swap_keys = keys;
+        keys = keys_buffer;
+        keys_buffer = swap_keys;
+    }
+
+    // Il risultato è nel buffer temporaneo: diventa il nuovo array e il vecchio viene liberato
+    if (src != _array->data) {
+        buffer = _array->data;
+        _array->data = src;
+    }
+    free(buffer);
+    free(keys < keys_buffer ? keys : keys_buffer);
+
+    _array->sorted_by = NULL;
     return DYN_ARRAY_SUCCESS;
 }
 
+int dynamic_array_lower_bound(dynamic_array _array, const void* _element, int (*_compare)(const void*, const void*)) {
+    if (_array == NULL || _element == NULL || _compare == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    int low = 0;
+    int high = _array->size;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        void* current = (char*)(_array->data) + mid * _array->element_size;
+        if (_compare(current, _element) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+int dynamic_array_binary_find(dynamic_array _array, const void* _element, int (*_compare)(const void*, const void*)) {
+    int index = dynamic_array_lower_bound(_array, _element, _compare);
+    if (index < 0 || index == _array->size) {
+        return -1;
+    }
+
+    void* current = (char*)(_array->data) + index * _array->element_size;
+    return (_compare(current, _element) == 0) ? index : -1;
+}
+
+int dynamic_array_insert_sorted(dynamic_array _array, void* _element, int (*_compare)(const void*, const void*)) {
+    if (_array == NULL || _element == NULL || _compare == NULL) {
+        return DYN_ARRAY_ERROR_NULL;
+    }
+
+    // Inserisce dopo gli elementi uguali, per mantenere l'ordine di inserimento
+    int low = 0;
+    int high = _array->size;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        void* current = (char*)(_array->data) + mid * _array->element_size;
+        if (_compare(current, _element) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int (*sorted_by)(const void*, const void*) = _array->sorted_by;
+    int result = dynamic_array_insert_at(_array, low, _element);
+    if (result == DYN_ARRAY_SUCCESS && sorted_by == _compare) {
+        _array->sorted_by = sorted_by;
+    }
+    return result;
+}
+
+bool dynamic_array_is_sorted_by(dynamic_array _array, int (*_compare)(const void*, const void*)) {
+    return (_array != NULL && _compare != NULL && _array->sorted_by == _compare);
+}
+
 int dynamic_array_find(dynamic_array _array, void* _element, int (*_compare)(const void*, const void*)) {
     if (_array == NULL || _element == NULL || _compare == NULL) {
         return -1;
     }
 
+    // Se l'array è mantenuto ordinato secondo lo stesso confronto basta una ricerca binaria
+    if (_array->sorted_by == _compare) {
+        return dynamic_array_binary_find(_array, _element, _compare);
+    }
+
     for (int i = 0; i < _array->size; i++) {
         void* current = (char*)(_array->data) + i * _array->element_size;
         if (_compare(current, _element) == 0) {
@@ -11,8 +11,13 @@
  * L'interfaccia fornisce operazioni per creare e distruggere l'array,
  * aggiungere e rimuovere elementi, accedere a una posizione specifica
  * e interrogare lo stato logico della struttura (vuota o meno, dimensione).
+ * La capacità può essere gestita esplicitamente (reserve, shrink_to_fit) e il
+ * fattore di crescita è configurabile per ogni array.
  */
 
+#ifndef DYNAMIC_ARRAY_H
+#define DYNAMIC_ARRAY_H
+
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -70,6 +75,66 @@ int dynamic_array_insert_at(dynamic_array _array, int _index, void* _element);
  */
 int dynamic_array_remove_at(dynamic_array _array, int _index, void (*_free_element)(void*));
 
+/*
+ * Aggiunge in coda più elementi contigui con un'unica copia, riallocando al più una volta
+ * @param _array Array in cui inserire
+ * @param _elements Puntatore al primo degli elementi da inserire
+ * @param _count Numero di elementi da inserire (≥ 0)
+ * @return DYN_ARRAY_SUCCESS se inseriti,
+ *         DYN_ARRAY_ERROR_NULL se _array o _elements sono NULL,
+ *         DYN_ARRAY_ERROR_INDEX se _count è negativo,
+ *         DYN_ARRAY_ERROR_ALLOC se realloc fallisce
+ */
+int dynamic_array_append_n(dynamic_array _array, const void* _elements, int _count);
+
+/*
+ * Rimuove l'elemento in posizione specifica in tempo costante, spostandovi l'ultimo elemento.
+ * L'ordine degli elementi non viene mantenuto.
+ * @param _array Array da cui rimuovere
+ * @param _index Indice da rimuovere
+ * @param _free_element Funzione per liberare la memoria dell'elemento (può essere NULL)
+ * @return DYN_ARRAY_SUCCESS se rimosso,
+ *         DYN_ARRAY_ERROR_INDEX se l'indice non è valido
+ */
+int dynamic_array_swap_remove(dynamic_array _array, int _index, void (*_free_element)(void*));
+
+/*
+ * Garantisce spazio per almeno _capacity elementi, così che i successivi inserimenti
+ * non debbano riallocare
+ * @param _array Array da espandere
+ * @param _capacity Capacità minima richiesta
+ * @return DYN_ARRAY_SUCCESS se ok,
+ *         DYN_ARRAY_ERROR_NULL se _array è NULL,
+ *         DYN_ARRAY_ERROR_ALLOC se realloc fallisce
+ */
+int dynamic_array_reserve(dynamic_array _array, int _capacity);
+
+/*
+ * Riduce la capacità al numero di elementi presenti (almeno 1)
+ * @param _array Array da ridurre
+ * @return DYN_ARRAY_SUCCESS se ok,
+ *         DYN_ARRAY_ERROR_NULL se _array è NULL,
+ *         DYN_ARRAY_ERROR_ALLOC se realloc fallisce (l'array resta invariato)
+ */
+int dynamic_array_shrink_to_fit(dynamic_array _array);
+
+/*
+ * Imposta il fattore con cui cresce la capacità quando l'array è pieno (predefinito 2)
+ * @param _array Array da configurare
+ * @param _growth_factor Fattore di crescita (> 1)
+ * @return DYN_ARRAY_SUCCESS se impostato,
+ *         DYN_ARRAY_ERROR_NULL se _array è NULL,
+ *         DYN_ARRAY_ERROR_INDEX se il fattore non è maggiore di 1
+ */
+int dynamic_array_set_growth_factor(dynamic_array _array, double _growth_factor);
+
+/*
+ * Restituisce la capacità attuale dell'array
+ * @param _array Array da cui leggere
+ * @return Capacità, oppure DYN_ARRAY_ERROR_NULL se _array è NULL
+ */
+int dynamic_array_capacity(dynamic_array _array);
+
 /*
  * Recupera l'elemento in posizione i
  * @param _array Array da cui leggere
@@ -93,7 +158,11 @@ int dynamic_array_size(dynamic_array _array);
 bool dynamic_array_is_empty(dynamic_array _array);
 
 /*
- * Ordina gli elementi dell'array utilizzando la funzione di confronto fornita
+ * Ordina gli elementi dell'array utilizzando la funzione di confronto fornita.
+ * L'array resta poi in modalità ordinata secondo _compare: dynamic_array_find con lo stesso
+ * confronto usa la ricerca binaria, finché un inserimento fuori ordine (insert_at, append_n,
+ * swap_remove o un append di un elemento minore dell'ultimo) non fa uscire dalla modalità.
+ * Chi modifica la chiave di un elemento tramite dynamic_array_get_at deve riordinare l'array.
  * @param _array Array da ordinare
  * @param _compare Funzione di confronto tra elementi
  * @return DYN_ARRAY_SUCCESS se ordinato,
@@ -102,10 +171,65 @@ bool dynamic_array_is_empty(dynamic_array _array);
 int dynamic_array_sort(dynamic_array _array, int (*_compare)(const void*, const void*));
 
 /*
- * Cerca un elemento nell'array utilizzando la funzione di confronto fornita
+ * Ordina gli elementi secondo una chiave intera con un radix sort LSD stabile, in tempo
+ * lineare invece che O(n log n) come dynamic_array_sort. Non attiva la modalità ordinata,
+ * perché non è nota una funzione di confronto.
+ * @param _array Array da ordinare
+ * @param _key Funzione che restituisce la chiave di un elemento
+ * @return DYN_ARRAY_SUCCESS se ordinato,
+ *         DYN_ARRAY_ERROR_NULL se _array o _key sono NULL,
+ *         DYN_ARRAY_ERROR_ALLOC se fallisce l'allocazione del buffer temporaneo
+ */
+int dynamic_array_sort_by_key(dynamic_array _array, int (*_key)(const void*));
+
+/*
+ * Trova la prima posizione il cui elemento non è minore di _element (ricerca binaria).
+ * L'array deve essere ordinato secondo _compare.
+ * @param _array Array in cui cercare
+ * @param _element Elemento di riferimento
+ * @param _compare Funzione di confronto tra elementi
+ * @return Indice trovato (uguale alla dimensione se tutti gli elementi sono minori),
+ *         DYN_ARRAY_ERROR_NULL se un parametro è NULL
+ */
+int dynamic_array_lower_bound(dynamic_array _array, const void* _element, int (*_compare)(const void*, const void*));
+
+/*
+ * Cerca un elemento con una ricerca binaria. L'array deve essere ordinato secondo _compare.
+ * @param _array Array in cui cercare
+ * @param _element Elemento da cercare
+ * @param _compare Funzione di confronto tra elementi
+ * @return Indice del primo elemento uguale se trovato, -1 altrimenti
+ */
+int dynamic_array_binary_find(dynamic_array _array, const void* _element, int (*_compare)(const void*, const void*));
+
+/*
+ * Inserisce un elemento mantenendo l'ordine, dopo eventuali elementi uguali.
+ * L'array deve essere ordinato secondo _compare; la modalità ordinata viene conservata.
+ * @param _array Array in cui inserire
+ * @param _element Puntatore all'elemento da inserire
+ * @param _compare Funzione di confronto tra elementi
+ * @return DYN_ARRAY_SUCCESS se inserito,
+ *         DYN_ARRAY_ERROR_NULL se un parametro è NULL,
+ *         DYN_ARRAY_ERROR_ALLOC se realloc fallisce
+ */
+int dynamic_array_insert_sorted(dynamic_array _array, void* _element, int (*_compare)(const void*, const void*));
+
+/*
+ * Verifica se l'array è in modalità ordinata secondo _compare
+ * @param _array Array da verificare
+ * @param _compare Funzione di confronto tra elementi
+ * @return true se l'array è mantenuto ordinato secondo _compare, false altrimenti
+ */
+bool dynamic_array_is_sorted_by(dynamic_array _array, int (*_compare)(const void*, const void*));
+
+/*
+ * Cerca un elemento nell'array utilizzando la funzione di confronto fornita.
+ * Se l'array è in modalità ordinata secondo _compare la ricerca è binaria, altrimenti lineare.
  * @param _array Array in cui cercare
  * @param _element Elemento da cercare
  * @param _compare Funzione di confronto tra elementi
  * @return Indice dell'elemento se trovato, -1 altrimenti
  */
 int dynamic_array_find(dynamic_array _array, void* _element, int (*_compare)(const void*, const void*));
+
+#endif /* DYNAMIC_ARRAY_H */
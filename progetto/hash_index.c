@@ -0,0 +1,189 @@
+/*
+ * hash_index.c
+ *
+ * Implementazione dell'indice hash definito in hash_index.h.
+ *
+ * Le celle sono in un unico array di dimensione potenza di due. Con l'inserimento Robin Hood
+ * un elemento che ha percorso più celle del residente ne prende il posto, e il residente
+ * prosegue la ricerca: le distanze restano basse e uniformi anche con carichi alti.
+ * La rimozione sposta indietro di una cella gli elementi successivi (backward shift),
+ * quindi non servono marcatori di cella cancellata.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "hash_index.h"
+
+#define INITIAL_CAPACITY 16
+#define MAX_LOAD_PERCENT 85     // Oltre questa percentuale di celle occupate la tabella raddoppia
+
+typedef struct {
+    const char* key;            // NULL se la cella è vuota
+    void* value;
+    uint32_t hash;
+    int distance;               // Distanza dalla posizione ideale
+} hash_index_cell;
+
+struct _hash_index {
+    hash_index_cell* cells;
+    int capacity;               // Potenza di due
+    int size;
+};
+
+// Funzione di utilità per calcolare l'hash FNV-1a di una stringa
+static uint32_t hash_string(const char* _key) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)_key; *c != '\0'; c++) {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Funzione di utilità per collocare una cella, scambiandola con i residenti più vicini alla loro posizione ideale
+static void place(hash_index _index, hash_index_cell _cell) {
+    int mask = _index->capacity - 1;
+    int position = (int)(_cell.hash & (uint32_t)mask);
+    _cell.distance = 0;
+
+    for (;;) {
+        hash_index_cell* current = &_index->cells[position];
+        if (current->key == NULL) {
+            *current = _cell;
+            return;
+        }
+
+        if (current->distance < _cell.distance) {
+            hash_index_cell resident = *current;
+            *current = _cell;
+            _cell = resident;
+        }
+
+        position = (position + 1) & mask;
+        _cell.distance++;
+    }
+}
+
+// Funzione di utilità per raddoppiare la tabella reinserendo tutte le celle
+static int grow(hash_index _index, int _capacity) {
+    hash_index_cell* old_cells = _index->cells;
+    int old_capacity = _index->capacity;
+
+    hash_index_cell* cells = calloc(_capacity, sizeof(hash_index_cell));
+    if (cells == NULL) return HASH_INDEX_ERROR_ALLOC;
+
+    _index->cells = cells;
+    _index->capacity = _capacity;
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_cells[i].key != NULL) place(_index, old_cells[i]);
+    }
+
+    free(old_cells);
+    return HASH_INDEX_SUCCESS;
+}
+
+// Funzione di utilità per trovare la cella di una chiave (-1 se assente)
+static int find_position(hash_index _index, const char* _key) {
+    uint32_t hash = hash_string(_key);
+    int mask = _index->capacity - 1;
+    int position = (int)(hash & (uint32_t)mask);
+
+    for (int distance = 0; ; distance++) {
+        hash_index_cell* current = &_index->cells[position];
+
+        // Una cella vuota o un residente più vicino alla sua posizione ideale: la chiave non c'è
+        if (current->key == NULL || current->distance < distance) return -1;
+
+        // Con chiavi internate lo stesso puntatore evita il confronto delle stringhe
+        if (current->hash == hash && (current->key == _key || strcmp(current->key, _key) == 0)) return position;
+
+        position = (position + 1) & mask;
+    }
+}
+
+hash_index hash_index_create(int _expected_size) {
+    hash_index index = (hash_index)malloc(sizeof(struct _hash_index));
+    if (index == NULL) return NULL;
+
+    // Capacità sufficiente a contenere _expected_size elementi sotto il carico massimo
+    int capacity = INITIAL_CAPACITY;
+    while (_expected_size > 0 && (long)capacity * MAX_LOAD_PERCENT / 100 < _expected_size) {
+        capacity *= 2;
+    }
+
+    index->cells = calloc(capacity, sizeof(hash_index_cell));
+    if (index->cells == NULL) {
+        free(index);
+        return NULL;
+    }
+
+    index->capacity = capacity;
+    index->size = 0;
+    return index;
+}
+
+void hash_index_destroy(hash_index* _index) {
+    if (_index == NULL || *_index == NULL) return;
+
+    free((*_index)->cells);
+    free(*_index);
+    *_index = NULL;
+}
+
+int hash_index_put(hash_index _index, const char* _key, void* _value) {
+    if (_index == NULL || _key == NULL) return HASH_INDEX_ERROR_NULL;
+
+    if (find_position(_index, _key) >= 0) return HASH_INDEX_ERROR_DUPLICATE;
+
+    if ((long)(_index->size + 1) * 100 > (long)_index->capacity * MAX_LOAD_PERCENT) {
+        if (grow(_index, _index->capacity * 2) != HASH_INDEX_SUCCESS) return HASH_INDEX_ERROR_ALLOC;
+    }
+
+    hash_index_cell cell;
+    cell.key = _key;
+    cell.value = _value;
+    cell.hash = hash_string(_key);
+    cell.distance = 0;
+    place(_index, cell);
+
+    _index->size++;
+    return HASH_INDEX_SUCCESS;
+}
+
+void* hash_index_get(hash_index _index, const char* _key) {
+    if (_index == NULL || _key == NULL) return NULL;
+
+    int position = find_position(_index, _key);
+    return (position >= 0) ? _index->cells[position].value : NULL;
+}
+
+bool hash_index_contains(hash_index _index, const char* _key) {
+    return (_index != NULL && _key != NULL && find_position(_index, _key) >= 0);
+}
+
+int hash_index_remove(hash_index _index, const char* _key) {
+    if (_index == NULL || _key == NULL) return HASH_INDEX_ERROR_NULL;
+
+    int position = find_position(_index, _key);
+    if (position < 0) return HASH_INDEX_ERROR_NOT_FOUND;
+
+    // Sposta indietro gli elementi che seguono finché uno non è già nella sua posizione ideale
+    int mask = _index->capacity - 1;
+    int next = (position + 1) & mask;
+    while (_index->cells[next].key != NULL && _index->cells[next].distance > 0) {
+        _index->cells[position] = _index->cells[next];
+        _index->cells[position].distance--;
+        position = next;
+        next = (next + 1) & mask;
+    }
+    _index->cells[position].key = NULL;
+    _index->cells[position].value = NULL;
+
+    _index->size--;
+    return HASH_INDEX_SUCCESS;
+}
+
+int hash_index_size(hash_index _index) {
+    if (_index == NULL) return HASH_INDEX_ERROR_NULL;
+    return _index->size;
+}
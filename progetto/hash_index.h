@@ -0,0 +1,89 @@
+/*
+ * hash_index.h
+ *
+ * Interfaccia di un Tipo di Dato Astratto (ADT) per un indice hash da stringhe a puntatori,
+ * con indirizzamento aperto e inserimento Robin Hood.
+ *
+ * Ogni cella conserva l'hash della chiave e la distanza dalla sua posizione ideale: una
+ * ricerca confronta le stringhe solo quando gli hash coincidono e si ferma appena incontra
+ * una cella più vicina alla propria posizione ideale di quanto lo sarebbe la chiave cercata.
+ * Inserimento, ricerca e rimozione richiedono tempo costante in media.
+ *
+ * L'indice non copia le chiavi: ogni chiave deve restare valida e invariata finché
+ * l'elemento resta nell'indice (tipicamente è il nome posseduto dall'elemento stesso).
+ */
+
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct _hash_index* hash_index;
+
+#define HASH_INDEX_SUCCESS 0
+#define HASH_INDEX_ERROR_NULL -1
+#define HASH_INDEX_ERROR_ALLOC -2
+#define HASH_INDEX_ERROR_DUPLICATE -3
+#define HASH_INDEX_ERROR_NOT_FOUND -4
+
+/*
+ * Crea un nuovo indice vuoto.
+ * @param _expected_size Numero di elementi previsto, per evitare ridimensionamenti (può essere 0).
+ * @return Puntatore all'indice creato, oppure NULL se fallisce l'allocazione.
+ */
+hash_index hash_index_create(int _expected_size);
+
+/*
+ * Distrugge l'indice e libera la memoria. Chiavi e valori non vengono liberati.
+ * @param _index Puntatore al puntatore dell'indice da distruggere.
+ *               Dopo la chiamata, *_index sarà impostato a NULL.
+ */
+void hash_index_destroy(hash_index* _index);
+
+/*
+ * Inserisce una nuova associazione tra chiave e valore.
+ * @param _index Indice in cui inserire.
+ * @param _key Chiave (non viene copiata).
+ * @param _value Valore associato alla chiave.
+ * @return HASH_INDEX_SUCCESS se inserita,
+ *         HASH_INDEX_ERROR_NULL se _index o _key sono NULL,
+ *         HASH_INDEX_ERROR_DUPLICATE se la chiave è già presente (l'indice non cambia),
+ *         HASH_INDEX_ERROR_ALLOC se fallisce l'allocazione.
+ */
+int hash_index_put(hash_index _index, const char* _key, void* _value);
+
+/*
+ * Restituisce il valore associato a una chiave.
+ * @param _index Indice in cui cercare.
+ * @param _key Chiave da cercare.
+ * @return Valore associato, oppure NULL se la chiave non è presente o un parametro è NULL.
+ */
+void* hash_index_get(hash_index _index, const char* _key);
+
+/*
+ * Verifica se una chiave è presente nell'indice.
+ * @param _index Indice in cui cercare.
+ * @param _key Chiave da cercare.
+ * @return true se presente, false altrimenti o se un parametro è NULL.
+ */
+bool hash_index_contains(hash_index _index, const char* _key);
+
+/*
+ * Rimuove una chiave dall'indice.
+ * @param _index Indice da cui rimuovere.
+ * @param _key Chiave da rimuovere.
+ * @return HASH_INDEX_SUCCESS se rimossa,
+ *         HASH_INDEX_ERROR_NULL se _index o _key sono NULL,
+ *         HASH_INDEX_ERROR_NOT_FOUND se la chiave non è presente.
+ */
+int hash_index_remove(hash_index _index, const char* _key);
+
+/*
+ * Restituisce il numero di chiavi presenti nell'indice.
+ * @param _index Indice da interrogare.
+ * @return Numero di chiavi, oppure HASH_INDEX_ERROR_NULL se _index è NULL.
+ */
+int hash_index_size(hash_index _index);
+
+#endif /* HASH_INDEX_H */
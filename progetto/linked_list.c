@@ -5,33 +5,167 @@
  * con puntatori opachi per nascondere i dettagli interni. Le operazioni includono
  * inserimento, accesso, rimozione e ricerca.
  *
+ * La lista è "srotolata": ogni nodo è un blocco che contiene fino a CHUNK_CAPACITY
+ * valori contigui, quindi un'allocazione serve molti inserimenti. Un blocco pieno che
+ * riceve un inserimento nel mezzo viene diviso a metà; un blocco che resta vuoto
+ * viene liberato.
+ *
+ * La lista ricorda l'ultimo blocco raggiunto (il cursore) e l'indice del suo primo
+ * valore: un accesso per indice parte da lì, quindi una scansione con get_at su
+ * indici consecutivi costa O(1) ammortizzato invece di ripartire ogni volta dalla testa.
+ *
  * Include anche il supporto a un iteratore per la scansione sequenziale della lista.
  */
 
+#include <string.h>
 #include "linked_list.h"
 
-typedef struct _node {
-    int value;
-    struct _node* next;
-} node;
+#define CHUNK_CAPACITY 64
+
+typedef struct _chunk {
+    int count;                      // Valori presenti nel blocco
+    struct _chunk* prev;
+    struct _chunk* next;
+    int values[CHUNK_CAPACITY];
+} chunk;
 
 struct linked_list {
-    node* head;
-    node* tail;
+    chunk* head;
+    chunk* tail;
     int size;
+    chunk* cursor;                  // Ultimo blocco raggiunto (NULL se la lista è vuota)
+    int cursor_start;               // Indice del primo valore del blocco cursore
 };
 
 struct linked_list_iterator {
     linked_list list;
-    node* current;
+    chunk* current;
+    int offset;                     // Posizione del prossimo valore nel blocco corrente
 };
 
+// Funzione di utilità per creare un blocco vuoto
+static chunk* chunk_create() {
+    chunk* new_chunk = malloc(sizeof(chunk));
+    if (new_chunk != NULL) {
+        new_chunk->count = 0;
+        new_chunk->prev = NULL;
+        new_chunk->next = NULL;
+    }
+    return new_chunk;
+}
+
+// Funzione di utilità per collegare _new_chunk dopo _prev (in testa se _prev è NULL)
+static void chunk_link_after(linked_list _list, chunk* _prev, chunk* _new_chunk) {
+    _new_chunk->prev = _prev;
+    _new_chunk->next = (_prev != NULL) ? _prev->next : _list->head;
+
+    if (_new_chunk->next != NULL) {
+        _new_chunk->next->prev = _new_chunk;
+    } else {
+        _list->tail = _new_chunk;
+    }
+
+    if (_prev != NULL) {
+        _prev->next = _new_chunk;
+    } else {
+        _list->head = _new_chunk;
+    }
+}
+
+// Funzione di utilità per scollegare e liberare un blocco rimasto vuoto
+static void chunk_unlink(linked_list _list, chunk* _chunk) {
+    if (_chunk->prev != NULL) {
+        _chunk->prev->next = _chunk->next;
+    } else {
+        _list->head = _chunk->next;
+    }
+
+    if (_chunk->next != NULL) {
+        _chunk->next->prev = _chunk->prev;
+    } else {
+        _list->tail = _chunk->prev;
+    }
+
+    free(_chunk);
+
+    // Il cursore torna in testa, che ha sempre indice iniziale 0
+    _list->cursor = _list->head;
+    _list->cursor_start = 0;
+}
+
+// Funzione di utilità per trovare il blocco che contiene _index (0 <= _index < size).
+// Restituisce il blocco, scrive in *_start l'indice del suo primo valore e vi sposta il cursore.
+static chunk* locate(linked_list _list, int _index, int* _start) {
+    chunk* current;
+    int start;
+
+    // Parte dal punto più vicino tra testa, coda e cursore
+    int from_tail = _list->size - _index;
+    int from_cursor = (_list->cursor != NULL) ? abs(_index - _list->cursor_start) : _list->size;
+    if (from_cursor <= _index && from_cursor <= from_tail) {
+        current = _list->cursor;
+        start = _list->cursor_start;
+    } else if (_index <= from_tail) {
+        current = _list->head;
+        start = 0;
+    } else {
+        current = _list->tail;
+        start = _list->size - _list->tail->count;
+    }
+
+    while (_index < start) {
+        current = current->prev;
+        start -= current->count;
+    }
+    while (_index >= start + current->count) {
+        start += current->count;
+        current = current->next;
+    }
+
+    _list->cursor = current;
+    _list->cursor_start = start;
+    *_start = start;
+    return current;
+}
+
+// Funzione di utilità per trovare il blocco e la posizione di un valore
+static chunk* find_value(linked_list _list, int _value, int* _start, int* _offset) {
+    int start = 0;
+    for (chunk* current = _list->head; current != NULL; current = current->next) {
+        for (int i = 0; i < current->count; i++) {
+            if (current->values[i] == _value) {
+                *_start = start;
+                *_offset = i;
+                return current;
+            }
+        }
+        start += current->count;
+    }
+    return NULL;
+}
+
+// Funzione di utilità per togliere il valore in posizione _offset di un blocco
+static void chunk_remove(linked_list _list, chunk* _chunk, int _start, int _offset) {
+    memmove(&_chunk->values[_offset], &_chunk->values[_offset + 1], (_chunk->count - _offset - 1) * sizeof(int));
+    _chunk->count--;
+    _list->size--;
+
+    if (_chunk->count == 0) {
+        chunk_unlink(_list, _chunk);
+    } else {
+        _list->cursor = _chunk;
+        _list->cursor_start = _start;
+    }
+}
+
 linked_list linked_list_create() {
     linked_list list = malloc(sizeof(struct linked_list));
     if (list != NULL) {
         list->head = NULL;
         list->tail = NULL;
         list->size = 0;
+        list->cursor = NULL;
+        list->cursor_start = 0;
     }
     return list;
 }
@@ -39,38 +173,39 @@ linked_list linked_list_create() {
 int linked_list_insert_front(linked_list _list, int _value) {
     if (_list == NULL) return LINKED_LIST_ERROR_NULL;
 
-    node* new_node = malloc(sizeof(node));
-    if (new_node == NULL) return LINKED_LIST_ERROR_ALLOC;
-
-    new_node->value = _value;
-    new_node->next = _list->head;
-    _list->head = new_node;
-
-    if (_list->tail == NULL) {
-        _list->tail = new_node;
+    // Se il primo blocco è pieno ne crea uno nuovo davanti, senza spostare valori
+    if (_list->head == NULL || _list->head->count == CHUNK_CAPACITY) {
+        chunk* new_chunk = chunk_create();
+        if (new_chunk == NULL) return LINKED_LIST_ERROR_ALLOC;
+        chunk_link_after(_list, NULL, new_chunk);
     }
 
+    chunk* head = _list->head;
+    memmove(&head->values[1], &head->values[0], head->count * sizeof(int));
+    head->values[0] = _value;
+    head->count++;
+
     _list->size++;
+    _list->cursor = head;
+    _list->cursor_start = 0;
     return LINKED_LIST_SUCCESS;
 }
 
 int linked_list_insert_back(linked_list _list, int _value) {
     if (_list == NULL) return LINKED_LIST_ERROR_NULL;
 
-    node* new_node = malloc(sizeof(node));
-    if (new_node == NULL) return LINKED_LIST_ERROR_ALLOC;
-
-    new_node->value = _value;
-    new_node->next = NULL;
-
-    if (_list->tail != NULL) {
-        _list->tail->next = new_node;
-    } else {
-        _list->head = new_node;
+    if (_list->tail == NULL || _list->tail->count == CHUNK_CAPACITY) {
+        chunk* new_chunk = chunk_create();
+        if (new_chunk == NULL) return LINKED_LIST_ERROR_ALLOC;
+        chunk_link_after(_list, _list->tail, new_chunk);
     }
 
-    _list->tail = new_node;
+    chunk* tail = _list->tail;
+    tail->values[tail->count++] = _value;
+
     _list->size++;
+    _list->cursor = tail;
+    _list->cursor_start = _list->size - tail->count;
     return LINKED_LIST_SUCCESS;
 }
 
@@ -83,19 +218,34 @@ int linked_list_insert_at(linked_list _list, int _index, int _value) {
 
     if (_index == _list->size) return linked_list_insert_back(_list, _value);
 
-    node* prev = _list->head;
-    for (int i = 0; i < _index - 1; i++) {
-        prev = prev->next;
-    }
+    int start;
+    chunk* current = locate(_list, _index, &start);
+
+    if (current->count == CHUNK_CAPACITY) {
+        // Divide il blocco pieno a metà e inserisce nella metà giusta
+        chunk* new_chunk = chunk_create();
+        if (new_chunk == NULL) return LINKED_LIST_ERROR_ALLOC;
 
-    node* new_node = malloc(sizeof(node));
-    if (new_node == NULL) return LINKED_LIST_ERROR_ALLOC;
+        int half = CHUNK_CAPACITY / 2;
+        memcpy(new_chunk->values, &current->values[half], (CHUNK_CAPACITY - half) * sizeof(int));
+        new_chunk->count = CHUNK_CAPACITY - half;
+        current->count = half;
+        chunk_link_after(_list, current, new_chunk);
 
-    new_node->value = _value;
-    new_node->next = prev->next;
-    prev->next = new_node;
+        if (_index >= start + half) {
+            start += half;
+            current = new_chunk;
+        }
+    }
+
+    int offset = _index - start;
+    memmove(&current->values[offset + 1], &current->values[offset], (current->count - offset) * sizeof(int));
+    current->values[offset] = _value;
+    current->count++;
 
     _list->size++;
+    _list->cursor = current;
+    _list->cursor_start = start;
     return LINKED_LIST_SUCCESS;
 }
 
@@ -106,12 +256,10 @@ int linked_list_get_at(linked_list _list, int _index, int* _value_out) {
 
     if (_index < 0 || _index >= _list->size) return LINKED_LIST_ERROR_INDEX;
 
-    node* current = _list->head;
-    for (int i = 0; i < _index; i++) {
-        current = current->next;
-    }
+    int start;
+    chunk* current = locate(_list, _index, &start);
 
-    *_value_out = current->value;
+    *_value_out = current->values[_index - start];
     return LINKED_LIST_SUCCESS;
 }
 
@@ -120,7 +268,7 @@ int linked_list_get_front(linked_list _list, int* _value_out) {
 
     if (_list->head == NULL) return LINKED_LIST_ERROR_EMPTY;
 
-    *_value_out = _list->head->value;
+    *_value_out = _list->head->values[0];
     return LINKED_LIST_SUCCESS;
 }
 
@@ -129,23 +277,18 @@ int linked_list_get_back(linked_list _list, int* _value_out) {
 
     if (_list->tail == NULL) return LINKED_LIST_ERROR_EMPTY;
 
-    *_value_out = _list->tail->value;
+    *_value_out = _list->tail->values[_list->tail->count - 1];
     return LINKED_LIST_SUCCESS;
 }
 
 int linked_list_find(linked_list _list, int _value, int* _index_out) {
     if (_list == NULL) return LINKED_LIST_ERROR_NULL;
 
-    node* current = _list->head;
-    int index = 0;
-    while ((current != NULL) && (current->value != _value)) {
-        current = current->next;
-        index++;
-    }
-    if (current == NULL)
+    int start, offset;
+    if (find_value(_list, _value, &start, &offset) == NULL)
         return LINKED_LIST_ERROR_NOT_FOUND;
     else {
-        *_index_out = index;
+        *_index_out = start + offset;
         return LINKED_LIST_SUCCESS;
     }
 }
@@ -157,52 +300,22 @@ int linked_list_remove_at(linked_list _list, int _index) {
 
     if (_list->head == NULL) return LINKED_LIST_ERROR_EMPTY;
 
-    node* to_delete;
-
-    if (_index == 0) {
-        to_delete = _list->head;
-        _list->head = to_delete->next;
-        if (_list->head == NULL) _list->tail = NULL;
-    } else {
-        node* prev = _list->head;
-        for (int i = 0; i < _index - 1; i++) {
-            prev = prev->next;
-        }
-        to_delete = prev->next;
-        prev->next = to_delete->next;
-        if (to_delete == _list->tail) {
-            _list->tail = prev;
-        }
-    }
-
-    free(to_delete);
-    _list->size--;
+    int start;
+    chunk* current = locate(_list, _index, &start);
+    chunk_remove(_list, current, start, _index - start);
     return LINKED_LIST_SUCCESS;
 }
 
 int linked_list_remove_value(linked_list _list, int _value) {
     if (_list == NULL) return LINKED_LIST_ERROR_NULL;
 
-    node* current = _list->head;
-    node* prev = NULL;
-
-    while ((current != NULL) && (current->value != _value)) {
-        prev = current;
-        current = current->next;
-    }
+    int start, offset;
+    chunk* current = find_value(_list, _value, &start, &offset);
 
     if (current == NULL)
         return LINKED_LIST_ERROR_NOT_FOUND;
     else {
-        if (prev == NULL) {
-            _list->head = current->next;
-            if (_list->head == NULL) _list->tail = NULL;
-        } else {
-            prev->next = current->next;
-            if (current == _list->tail) _list->tail = prev;
-        }
-        free(current);
-        _list->size--;
+        chunk_remove(_list, current, start, offset);
         return LINKED_LIST_SUCCESS;
     }
 }
@@ -212,24 +325,8 @@ int linked_list_remove_back(linked_list _list) {
 
     if (_list->head == NULL) return LINKED_LIST_ERROR_EMPTY;
 
-    node* current = _list->head;
-    node* prev = NULL;
-
-    while (current->next != NULL) {
-        prev = current;
-        current = current->next;
-    }
-
-    if (prev == NULL) {
-        _list->head = NULL;
-        _list->tail = NULL;
-    } else {
-        prev->next = NULL;
-        _list->tail = prev;
-    }
-
-    free(current);
-    _list->size--;
+    chunk* tail = _list->tail;
+    chunk_remove(_list, tail, _list->size - tail->count, tail->count - 1);
     return LINKED_LIST_SUCCESS;
 }
 
@@ -246,9 +343,9 @@ int linked_list_size(const linked_list _list) {
 void linked_list_destroy(linked_list* _list) {
     if (_list == NULL || *_list == NULL) return;
 
-    node* current = (*_list)->head;
+    chunk* current = (*_list)->head;
     while (current != NULL) {
-        node* next = current->next;
+        chunk* next = current->next;
         free(current);
         current = next;
     }
@@ -263,7 +360,9 @@ linked_list_iterator linked_list_iterator_create(linked_list _list) {
     linked_list_iterator iterator = malloc(sizeof(struct linked_list_iterator));
     if (iterator == NULL) return NULL;
 
+    iterator->list = _list;
     iterator->current = _list->head;
+    iterator->offset = 0;
     return iterator;
 }
 
@@ -272,8 +371,11 @@ bool linked_list_iterator_has_next(linked_list_iterator _iterator) {
 }
 
 int linked_list_iterator_next(linked_list_iterator _iterator) {
-    int value = _iterator->current->value;
-    _iterator->current = _iterator->current->next;
+    int value = _iterator->current->values[_iterator->offset++];
+    if (_iterator->offset == _iterator->current->count) {
+        _iterator->current = _iterator->current->next;
+        _iterator->offset = 0;
+    }
     return value;
 }
 
@@ -291,4 +393,4 @@ int linked_list_append(linked_list _list, int _value) {
 // Funzione di utilità per aggiungere un elemento all'inizio della lista (alias di insert_front)
 int linked_list_prepend(linked_list _list, int _value) {
     return linked_list_insert_front(_list, _value);
-}
\ No newline at end of file
+}
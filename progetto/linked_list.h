@@ -8,9 +8,16 @@
  * per essere sicura, modulare e facile da utilizzare in applicazioni C che richiedono
  * strutture dati flessibili.
  *
+ * Gli elementi sono memorizzati in blocchi contigui e la lista ricorda l'ultima posizione
+ * raggiunta: scorrere la lista con linked_list_get_at su indici consecutivi costa O(1)
+ * ammortizzato per accesso, e gli inserimenti in coda allocano un blocco ogni molti elementi.
+ *
  * Include inoltre un iteratore, con funzioni per creare, scorrere e distruggere l'iteratore.
  */
 
+#ifndef LINKED_LIST_H
+#define LINKED_LIST_H
+
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -205,3 +212,5 @@ int linked_list_append(linked_list _list, int _value);
  *         LINKED_LIST_ERROR_ALLOC se fallisce l'allocazione della memoria
  */
 int linked_list_prepend(linked_list _list, int _value);
+
+#endif /* LINKED_LIST_H */
@@ -3,25 +3,22 @@
  *
  * Implementazione della coda di interi definita in queue.h.
  *
- * La coda è realizzata mediante lista concatenata, con riferimento esplicito
- * alla testa (head) e alla coda (tail). La capacità massima è rispettata come
- * vincolo logico e impedisce l'inserimento oltre il limite prefissato.
+ * La coda è realizzata mediante buffer circolare: head indica la posizione
+ * del primo elemento e gli elementi successivi seguono, ricominciando
+ * dall'inizio del buffer quando ne raggiungono la fine. Quando il buffer è
+ * pieno viene raddoppiato, riportando gli elementi in ordine dall'inizio.
  *
  * Ogni operazione è protetta contro puntatori NULL e situazioni di errore
- * come coda vuota o piena. L’interfaccia è conforme al comportamento FIFO.
+ * come coda vuota. L’interfaccia è conforme al comportamento FIFO.
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "list_queue.h"
 
-typedef struct _node {
-    int value;
-    struct _node* next;
-} node;
-
 struct _queue {
-    node* head;
-    node* tail;
+    int* values;
+    int head;
     int size;
     int capacity;
 };
@@ -32,8 +29,13 @@ queue queue_create(int _capacity) {
     queue q = malloc(sizeof(struct _queue));
     if (q == NULL) return NULL;
 
-    q->head = NULL;
-    q->tail = NULL;
+    q->values = malloc(_capacity * sizeof(int));
+    if (q->values == NULL) {
+        free(q);
+        return NULL;
+    }
+
+    q->head = 0;
     q->size = 0;
     q->capacity = _capacity;
 
@@ -43,35 +45,42 @@ queue queue_create(int _capacity) {
 void queue_destroy(queue* _queue) {
     if (_queue == NULL || *_queue == NULL) return;
 
-    node* current = (*_queue)->head;
-    while (current != NULL) {
-        node* next = current->next;
-        free(current);
-        current = next;
-    }
-
+    free((*_queue)->values);
     free(*_queue);
     *_queue = NULL;
 }
 
-int queue_enqueue(queue _queue, int _value) {
+int queue_reserve(queue _queue, int _capacity) {
     if (_queue == NULL) return QUEUE_ERROR_NULL;
+    if (_capacity <= _queue->capacity) return QUEUE_SUCCESS;
 
-    if (_queue->size == _queue->capacity) return QUEUE_ERROR_FULL;
+    int* values = malloc(_capacity * sizeof(int));
+    if (values == NULL) return QUEUE_ERROR_ALLOC;
 
-    node* new_node = malloc(sizeof(node));
-    if (new_node == NULL) return QUEUE_ERROR_ALLOC;
+    // Copia gli elementi in ordine, in al più due tratti contigui
+    int first = _queue->capacity - _queue->head;
+    if (first > _queue->size) first = _queue->size;
+    memcpy(values, _queue->values + _queue->head, first * sizeof(int));
+    memcpy(values + first, _queue->values, (_queue->size - first) * sizeof(int));
 
-    new_node->value = _value;
-    new_node->next = NULL;
+    free(_queue->values);
+    _queue->values = values;
+    _queue->head = 0;
+    _queue->capacity = _capacity;
+
+    return QUEUE_SUCCESS;
+}
+
+int queue_enqueue(queue _queue, int _value) {
+    if (_queue == NULL) return QUEUE_ERROR_NULL;
 
-    if (_queue->tail == NULL) {
-        _queue->head = new_node;
-    } else {
-        _queue->tail->next = new_node;
+    if (_queue->size == _queue->capacity && queue_reserve(_queue, _queue->capacity * 2) != QUEUE_SUCCESS) {
+        return QUEUE_ERROR_ALLOC;
     }
 
-    _queue->tail = new_node;
+    int tail = _queue->head + _queue->size;
+    if (tail >= _queue->capacity) tail -= _queue->capacity;
+    _queue->values[tail] = _value;
     _queue->size++;
 
     return QUEUE_SUCCESS;
@@ -80,28 +89,23 @@ int queue_enqueue(queue _queue, int _value) {
 int queue_dequeue(queue _queue, int* _ptr_value_out) {
     if (_queue == NULL) return QUEUE_ERROR_NULL;
 
-    if (_queue->head == NULL) return QUEUE_ERROR_EMPTY;
+    if (_queue->size == 0) return QUEUE_ERROR_EMPTY;
 
-    node* to_remove = _queue->head;
-    *_ptr_value_out = to_remove->value;
-    _queue->head = to_remove->next;
-    free(to_remove);
+    *_ptr_value_out = _queue->values[_queue->head];
+    _queue->head++;
+    if (_queue->head == _queue->capacity) _queue->head = 0;
 
     _queue->size--;
 
-    if (_queue->head == NULL) {
-        _queue->tail = NULL;
-    }
-
     return QUEUE_SUCCESS;
 }
 
 int queue_peek(queue _queue, int* _ptr_value_out) {
     if (_queue == NULL) return QUEUE_ERROR_NULL;
 
-    if (_queue->head == NULL) return QUEUE_ERROR_EMPTY;
+    if (_queue->size == 0) return QUEUE_ERROR_EMPTY;
 
-    *_ptr_value_out = _queue->head->value;
+    *_ptr_value_out = _queue->values[_queue->head];
     return QUEUE_SUCCESS;
 }
 
@@ -110,6 +114,19 @@ bool queue_is_empty(queue _queue) {
 }
 
 bool queue_is_full(queue _queue) {
-    if (_queue == NULL) return false;
-    return (_queue->size == _queue->capacity);
+    (void)_queue;
+    return false;
+}
+
+int queue_size(queue _queue) {
+    if (_queue == NULL) return QUEUE_ERROR_NULL;
+    return _queue->size;
+}
+
+int queue_clear(queue _queue) {
+    if (_queue == NULL) return QUEUE_ERROR_NULL;
+
+    _queue->head = 0;
+    _queue->size = 0;
+    return QUEUE_SUCCESS;
 }
@@ -2,21 +2,24 @@
  * queue.h
  *
  * Interfaccia di un Tipo di Dato Astratto (ADT) per una coda di interi,
- * implementata mediante lista concatenata con capacità massima impostata
- * all'atto della creazione.
+ * implementata mediante buffer circolare contiguo con capacità iniziale
+ * impostata all'atto della creazione.
  *
  * La coda segue la semantica FIFO (First In, First Out), in cui gli
  * elementi vengono inseriti in coda (enqueue) e rimossi dalla testa (dequeue).
  *
- * L’uso di una lista concatenata consente flessibilità nell’allocazione
- * dinamica della memoria, mentre il vincolo di capacità mantiene
- * sotto controllo l’uso delle risorse, analogamente a un array.
+ * Il buffer raddoppia quando è pieno e non viene mai ridotto: una coda
+ * riusata (ad esempio svuotata con queue_clear tra una visita e l'altra)
+ * non richiede allocazioni una volta raggiunta la dimensione di regime.
  *
  * Il modulo fornisce operazioni per creare, distruggere, inserire,
- * rimuovere, consultare l’elemento in testa e verificare lo stato
- * della coda (vuota o piena).
+ * rimuovere, consultare l’elemento in testa, riservare spazio, svuotare
+ * e verificare lo stato della coda.
  */
 
+#ifndef LIST_QUEUE_H
+#define LIST_QUEUE_H
+
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -26,12 +29,12 @@ typedef struct _queue* queue;
 #define QUEUE_ERROR_NULL -1
 #define QUEUE_ERROR_ALLOC -2
 #define QUEUE_ERROR_EMPTY -3
-#define QUEUE_ERROR_FULL -4
+#define QUEUE_ERROR_FULL -4    // Non più restituito: la coda cresce automaticamente
 
 /*
- * Crea una nuova coda con capacità specificata
- * @param _capacity Numero massimo di elementi nella coda
- * @return Puntatore alla coda creata, oppure NULL se errore di allocazione
+ * Crea una nuova coda con capacità iniziale specificata
+ * @param _capacity Numero di elementi per cui riservare spazio (maggiore di 0)
+ * @return Puntatore alla coda creata, oppure NULL se _capacity non è valida o errore di allocazione
  */
 queue queue_create(int _capacity);
 
@@ -47,7 +50,7 @@ void queue_destroy(queue* _queue);
  * @param _value Valore da inserire
  * @return QUEUE_SUCCESS se inserito,
  *         QUEUE_ERROR_NULL se _queue è NULL,
- *         QUEUE_ERROR_FULL se la coda è piena
+ *         QUEUE_ERROR_ALLOC se la coda è piena e non è possibile ingrandirla
  */
 int queue_enqueue(queue _queue, int _ptr_value);
 
@@ -81,6 +84,32 @@ bool queue_is_empty(queue _queue);
 /*
  * Verifica se la coda è piena
  * @param _queue Coda da verificare
- * @return true se piena, false altrimenti. Ritorna false se _queue è NULL
+ * @return Sempre false: la coda cresce automaticamente (mantenuta per compatibilità)
  */
 bool queue_is_full(queue _queue);
+
+/*
+ * Restituisce il numero di elementi nella coda
+ * @param _queue Coda da interrogare
+ * @return Numero di elementi, oppure QUEUE_ERROR_NULL se _queue è NULL
+ */
+int queue_size(queue _queue);
+
+/*
+ * Garantisce spazio per almeno _capacity elementi senza ulteriori allocazioni
+ * @param _queue Coda da preparare
+ * @param _capacity Numero di elementi da poter contenere
+ * @return QUEUE_SUCCESS se lo spazio è disponibile,
+ *         QUEUE_ERROR_NULL se _queue è NULL,
+ *         QUEUE_ERROR_ALLOC se errore di allocazione
+ */
+int queue_reserve(queue _queue, int _capacity);
+
+/*
+ * Svuota la coda mantenendo lo spazio allocato
+ * @param _queue Coda da svuotare
+ * @return QUEUE_SUCCESS se svuotata, QUEUE_ERROR_NULL se _queue è NULL
+ */
+int queue_clear(queue _queue);
+
+#endif /* LIST_QUEUE_H */
@@ -3,13 +3,10 @@
  *
  * Implementazione dello stack di interi definito in stack.h.
  *
- * Lo stack è rappresentato tramite una lista concatenata (linked list)
- * in cui ogni nodo contiene un valore intero e un puntatore al nodo successivo.
- * La struttura mantiene un riferimento alla cima (top), alla capacità massima
- * e alla dimensione attuale (numero di elementi presenti).
- *
- * Anche se la struttura è dinamica, la capacità massima imposta all'atto
- * della creazione limita il numero di elementi inseribili, analogamente a un array.
+ * Lo stack è rappresentato tramite un array contiguo in cui la cima è
+ * l'ultimo elemento occupato. La struttura mantiene la dimensione attuale
+ * (numero di elementi presenti) e la capacità dell'array, che raddoppia
+ * quando è pieno.
  *
  * Tutte le funzioni restituiscono codici di errore e controllano
  * i puntatori NULL. La memoria viene gestita in modo esplicito e sicuro.
@@ -17,13 +14,8 @@
 
 #include "list_stack.h"
 
-typedef struct _node {
-    int value;
-    struct _node* next;
-} node;
-
 struct _stack {
-    node* top;
+    int* values;
     int size;
     int capacity;
 };
@@ -34,7 +26,12 @@ stack stack_create(int _capacity) {
     stack s = malloc(sizeof(struct _stack));
     if (s == NULL) return NULL;
 
-    s->top = NULL;
+    s->values = malloc(_capacity * sizeof(int));
+    if (s->values == NULL) {
+        free(s);
+        return NULL;
+    }
+
     s->size = 0;
     s->capacity = _capacity;
 
@@ -44,29 +41,32 @@ stack stack_create(int _capacity) {
 void stack_destroy(stack* _stack) {
     if (_stack == NULL || *_stack == NULL) return;
 
-    node* current = (*_stack)->top;
-    while (current != NULL) {
-        node* next = current->next;
-        free(current);
-        current = next;
-    }
-
+    free((*_stack)->values);
     free(*_stack);
     *_stack = NULL;
 }
 
-int stack_push(stack _stack, int _ptr_value) {
+int stack_reserve(stack _stack, int _capacity) {
     if (_stack == NULL) return STACK_ERROR_NULL;
+    if (_capacity <= _stack->capacity) return STACK_SUCCESS;
+
+    int* values = realloc(_stack->values, _capacity * sizeof(int));
+    if (values == NULL) return STACK_ERROR_ALLOC;
 
-    if (_stack->size == _stack->capacity) return STACK_ERROR_FULL;
+    _stack->values = values;
+    _stack->capacity = _capacity;
 
-    node* new_node = malloc(sizeof(node));
-    if (new_node == NULL) return STACK_ERROR_ALLOC;
+    return STACK_SUCCESS;
+}
 
-    new_node->value = _ptr_value;
-    new_node->next = _stack->top;
-    _stack->top = new_node;
-    _stack->size++;
+int stack_push(stack _stack, int _ptr_value) {
+    if (_stack == NULL) return STACK_ERROR_NULL;
+
+    if (_stack->size == _stack->capacity && stack_reserve(_stack, _stack->capacity * 2) != STACK_SUCCESS) {
+        return STACK_ERROR_ALLOC;
+    }
+
+    _stack->values[_stack->size++] = _ptr_value;
 
     return STACK_SUCCESS;
 }
@@ -74,13 +74,9 @@ int stack_push(stack _stack, int _ptr_value) {
 int stack_pop(stack _stack, int* _ptr_value_out) {
     if (_stack == NULL) return STACK_ERROR_NULL;
 
-    if (_stack->top == NULL) return STACK_ERROR_EMPTY;
+    if (_stack->size == 0) return STACK_ERROR_EMPTY;
 
-    node* to_delete = _stack->top;
-    *_ptr_value_out = to_delete->value;
-    _stack->top = to_delete->next;
-    free(to_delete);
-    _stack->size--;
+    *_ptr_value_out = _stack->values[--_stack->size];
 
     return STACK_SUCCESS;
 }
@@ -88,9 +84,9 @@ int stack_pop(stack _stack, int* _ptr_value_out) {
 int stack_top(stack _stack, int* _ptr_value_out) {
     if (_stack == NULL) return STACK_ERROR_NULL;
 
-    if (_stack->top == NULL) return STACK_ERROR_EMPTY;
+    if (_stack->size == 0) return STACK_ERROR_EMPTY;
 
-    *_ptr_value_out = _stack->top->value;
+    *_ptr_value_out = _stack->values[_stack->size - 1];
     return STACK_SUCCESS;
 }
 
@@ -99,6 +95,18 @@ bool stack_is_empty(stack _stack) {
 }
 
 bool stack_is_full(stack _stack) {
-    if (_stack == NULL) return false;
-    return (_stack->size == _stack->capacity);
+    (void)_stack;
+    return false;
+}
+
+int stack_size(stack _stack) {
+    if (_stack == NULL) return STACK_ERROR_NULL;
+    return _stack->size;
+}
+
+int stack_clear(stack _stack) {
+    if (_stack == NULL) return STACK_ERROR_NULL;
+
+    _stack->size = 0;
+    return STACK_SUCCESS;
 }
@@ -2,17 +2,20 @@
  * stack.h
  *
  * Interfaccia di un Tipo di Dato Astratto (ADT) per uno stack di interi,
- * implementato mediante lista concatenata con capacità massima configurabile.
+ * implementato mediante array contiguo con capacità iniziale configurabile.
  *
- * Lo stack gestisce gli elementi secondo il paradigma LIFO (Last In, First Out),
- * limitando il numero massimo di elementi tramite una capacità impostata all'atto
- * della creazione, in modo analogo a un array a dimensione fissa.
+ * Lo stack gestisce gli elementi secondo il paradigma LIFO (Last In, First Out).
+ * L'array raddoppia quando è pieno e non viene mai ridotto, quindi uno stack
+ * riusato non richiede allocazioni una volta raggiunta la dimensione di regime.
  *
  * Fornisce operazioni per creare, distruggere, inserire (push),
- * rimuovere (pop), consultare l'elemento in cima (top) e verificare
- * lo stato dello stack (vuoto o pieno).
+ * rimuovere (pop), consultare l'elemento in cima (top), riservare spazio,
+ * svuotare e verificare lo stato dello stack.
  */
 
+#ifndef LIST_STACK_H
+#define LIST_STACK_H
+
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -22,12 +25,12 @@ typedef struct _stack* stack;
 #define STACK_ERROR_NULL -1
 #define STACK_ERROR_ALLOC -2
 #define STACK_ERROR_EMPTY -3
-#define STACK_ERROR_FULL -4
+#define STACK_ERROR_FULL -4    // Non più restituito: lo stack cresce automaticamente
 
 /*
- * Crea un nuovo stack con capacità specificata
- * @param _capacity Capacità massima dello stack
- * @return Puntatore allo stack, oppure NULL in caso di errore di allocazione
+ * Crea un nuovo stack con capacità iniziale specificata
+ * @param _capacity Numero di elementi per cui riservare spazio (maggiore di 0)
+ * @return Puntatore allo stack, oppure NULL se _capacity non è valida o errore di allocazione
  */
 stack stack_create(int _capacity);
 
@@ -43,7 +46,7 @@ void stack_destroy(stack* _stack);
  * @param _value Valore intero da inserire
  * @return STACK_SUCCESS se inserito,
  *         STACK_ERROR_NULL se _stack è NULL,
- *         STACK_ERROR_FULL se lo stack è pieno
+ *         STACK_ERROR_ALLOC se lo stack è pieno e non è possibile ingrandirlo
  */
 int stack_push(stack _stack, int _ptr_value);
 
@@ -77,6 +80,32 @@ bool stack_is_empty(stack _stack);
 /*
  * Verifica se lo stack è pieno
  * @param _stack Stack da verificare
- * @return true se pieno, false altrimenti. Ritorna false se _stack è NULL
+ * @return Sempre false: lo stack cresce automaticamente (mantenuta per compatibilità)
  */
 bool stack_is_full(stack _stack);
+
+/*
+ * Restituisce il numero di elementi nello stack
+ * @param _stack Stack da interrogare
+ * @return Numero di elementi, oppure STACK_ERROR_NULL se _stack è NULL
+ */
+int stack_size(stack _stack);
+
+/*
+ * Garantisce spazio per almeno _capacity elementi senza ulteriori allocazioni
+ * @param _stack Stack da preparare
+ * @param _capacity Numero di elementi da poter contenere
+ * @return STACK_SUCCESS se lo spazio è disponibile,
+ *         STACK_ERROR_NULL se _stack è NULL,
+ *         STACK_ERROR_ALLOC se errore di allocazione
+ */
+int stack_reserve(stack _stack, int _capacity);
+
+/*
+ * Svuota lo stack mantenendo lo spazio allocato
+ * @param _stack Stack da svuotare
+ * @return STACK_SUCCESS se svuotato, STACK_ERROR_NULL se _stack è NULL
+ */
+int stack_clear(stack _stack);
+
+#endif /* LIST_STACK_H */
@@ -9,7 +9,7 @@ struct Missione {
     dynamic_array carichi;  
     time_t data_inizio;      
     time_t data_fine;      
-    char* nota;            
+    const char* nota;       // Non posseduta: internata dal gestore
 };
 
 Missione missione_create(int _id, Veicolo _veicolo) {
@@ -37,11 +37,6 @@ Missione missione_create(int _id, Veicolo _veicolo) {
 void missione_destroy(Missione* _missione) {
     if (_missione == NULL || *_missione == NULL) return;
 
-    // Libera la nota se presente
-    if ((*_missione)->nota != NULL) {
-        free((*_missione)->nota);
-    }
-
     // Libera l'array dinamico dei carichi
     // Nota: non liberiamo i carichi stessi, poiché potrebbero essere
     // referenziati altrove
@@ -105,7 +100,7 @@ int missione_remove_carico(Missione _missione, void* _carico) {
             carico_set_missione((Carico)_carico, NULL);
             
             // Rimuovi il carico dall'array
-            return dynamic_array_remove_at(_missione->carichi, i, NULL);
+            return dynamic_array_swap_remove(_missione->carichi, i, NULL);
         }
     }
     
@@ -160,19 +155,8 @@ double missione_get_durata(Missione _missione) {
 int missione_set_nota(Missione _missione, const char* _nota) {
     if (_missione == NULL) return -1;
     
-    // Libera la nota precedente se presente
-    if (_missione->nota != NULL) {
-        free(_missione->nota);
-        _missione->nota = NULL;
-    }
-    
-    // Se la nuova nota è NULL, lasciamo la nota come NULL
-    if (_nota == NULL) return 0;
-    
-    // Altrimenti, duplica la stringa
-    _missione->nota = strdup(_nota);
-    if (_missione->nota == NULL) return -1;
-    
+    // Una nota NULL rimuove quella precedente
+    _missione->nota = _nota;
     return 0;
 }
 
@@ -67,6 +67,7 @@ int missione_add_carico(Missione _missione, void* _carico);
 
 /*
  * Rimuove un carico dalla missione
+ * L'ultimo carico prende il posto di quello rimosso: l'ordine dei carichi non viene mantenuto
  * @param _missione Missione da cui rimuovere il carico
  * @param _carico Carico da rimuovere
  * @return 0 se rimosso con successo, -1 altrimenti
@@ -128,7 +129,8 @@ double missione_get_durata(Missione _missione);
 /*
  * Imposta una nota testuale sulla missione
  * @param _missione Missione da modificare
- * @param _nota Nota testuale da impostare
+ * @param _nota Nota testuale da impostare, oppure NULL per rimuoverla
+ *              (non viene copiata: deve restare valida finché resta associata alla missione)
  * @return 0 se impostata con successo, -1 altrimenti
  */
 int missione_set_nota(Missione _missione, const char* _nota);
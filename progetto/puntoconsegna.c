@@ -3,7 +3,7 @@
 
 struct PuntoConsegna {
     int id;                  
-    char* nome;             
+    const char* nome;        // Non posseduto: internato dal gestore
     int priorita;            
     int orario;             
     TipoPuntoConsegna tipo;  
@@ -21,11 +21,7 @@ PuntoConsegna punto_consegna_create(int _id, const char* _nome, int _priorita,
     if (punto == NULL) return NULL;
 
     punto->id = _id;
-    punto->nome = strdup(_nome);
-    if (punto->nome == NULL) {
-        free(punto);
-        return NULL;
-    }
+    punto->nome = _nome;
 
     punto->priorita = _priorita;
     punto->orario = _orario;
@@ -39,9 +35,6 @@ PuntoConsegna punto_consegna_create(int _id, const char* _nome, int _priorita,
 void punto_consegna_destroy(PuntoConsegna* _punto) {
     if (_punto == NULL || *_punto == NULL) return;
 
-    // Libera il nome
-    free((*_punto)->nome);
-
     // Libera la struttura
     free(*_punto);
     *_punto = NULL;
@@ -16,7 +16,7 @@ typedef enum {
 /*
  * Crea un nuovo punto di consegna
  * @param _id Identificativo del punto di consegna
- * @param _nome Nome del punto di consegna
+ * @param _nome Nome del punto di consegna (non viene copiato: deve restare valido per tutta la vita del punto)
  * @param _priorita Priorità del punto di consegna (1-5)
  * @param _orario Orario di consegna (formato HHMM)
  * @param _tipo Tipo del punto di consegna
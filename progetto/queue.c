@@ -3,101 +3,278 @@
  *
  * Implementazione della coda con priorità definita in queue.h.
  *
- * La coda con priorità è implementata utilizzando una lista concatenata ordinata
- * per priorità, dove gli elementi con priorità più alta sono in testa alla lista.
+ * La coda con priorità è implementata come heap d-ario (d = 4) su un array che cresce
+ * raddoppiando, senza allocazioni per elemento. A ogni inserimento viene assegnato un
+ * numero di sequenza crescente: a parità di priorità esce l'elemento inserito prima,
+ * come nella precedente lista ordinata.
+ *
+ * Ogni elemento occupa anche uno slot di una tabella che ne registra la posizione nello
+ * heap, aggiornata a ogni spostamento. Un handle è la coppia (slot, sequenza): lo slot
+ * trova l'elemento in tempo costante e la sequenza, mai riusata, distingue l'elemento
+ * originale da uno inserito in seguito nello stesso slot.
  */
 
 #include <stdlib.h>
 #include "queue.h"
 
-typedef struct _priority_queue_node {
+#define HEAP_ARITY 4
+#define INITIAL_CAPACITY 16
+
+typedef struct {
     void* element;
     int priority;
-    struct _priority_queue_node* next;
-} priority_queue_node;
+    unsigned long sequence;     // Ordine di inserimento, per mantenere FIFO a parità di priorità
+    int slot;                   // Slot della tabella delle posizioni
+} priority_queue_entry;
 
 struct _priority_queue {
-    priority_queue_node* head;
+    priority_queue_entry* heap;
+    int* positions;             // Posizione nello heap per slot; se negativa lo slot è libero
     int size;
+    int capacity;
+    int num_slots;              // Slot usati almeno una volta
+    int free_slot;              // Primo slot libero da riusare (-1 se nessuno)
+    unsigned long next_sequence;
 };
 
+// Funzione di utilità per collocare un elemento nello heap aggiornandone la posizione
+static void place(priority_queue _queue, int _index, priority_queue_entry _entry) {
+    _queue->heap[_index] = _entry;
+    _queue->positions[_entry.slot] = _index;
+}
+
+// Funzione di utilità per stabilire se _a deve uscire prima di _b
+static bool entry_before(const priority_queue_entry* _a, const priority_queue_entry* _b) {
+    if (_a->priority != _b->priority) return _a->priority > _b->priority;
+    return _a->sequence < _b->sequence;
+}
+
+// Funzione di utilità per far risalire l'elemento in posizione _index
+static void sift_up(priority_queue _queue, int _index) {
+    priority_queue_entry entry = _queue->heap[_index];
+    while (_index > 0) {
+        int parent = (_index - 1) / HEAP_ARITY;
+        if (!entry_before(&entry, &_queue->heap[parent])) break;
+        place(_queue, _index, _queue->heap[parent]);
+        _index = parent;
+    }
+    place(_queue, _index, entry);
+}
+
+// Funzione di utilità per far scendere l'elemento in posizione _index
+static void sift_down(priority_queue _queue, int _index) {
+    priority_queue_entry entry = _queue->heap[_index];
+    for (;;) {
+        int first = _index * HEAP_ARITY + 1;
+        if (first >= _queue->size) break;
+
+        // Sceglie il figlio che deve uscire per primo
+        int last = first + HEAP_ARITY;
+        if (last > _queue->size) last = _queue->size;
+        int best = first;
+        for (int child = first + 1; child < last; child++) {
+            if (entry_before(&_queue->heap[child], &_queue->heap[best])) best = child;
+        }
+
+        if (!entry_before(&_queue->heap[best], &entry)) break;
+        place(_queue, _index, _queue->heap[best]);
+        _index = best;
+    }
+    place(_queue, _index, entry);
+}
+
+// Funzione di utilità per togliere l'elemento in posizione _index, liberandone lo slot
+static void remove_at(priority_queue _queue, int _index) {
+    int slot = _queue->heap[_index].slot;
+    _queue->positions[slot] = -(_queue->free_slot + 2);
+    _queue->free_slot = slot;
+
+    // L'ultimo elemento prende il posto di quello rimosso e si riposiziona
+    _queue->size--;
+    if (_index < _queue->size) {
+        priority_queue_entry moved = _queue->heap[_queue->size];
+        place(_queue, _index, moved);
+        sift_up(_queue, _index);
+        sift_down(_queue, _queue->positions[moved.slot]);
+    }
+}
+
+// Funzione di utilità per garantire spazio per _needed elementi (gli slot usati non superano mai la capacità)
+static int reserve(priority_queue _queue, int _needed) {
+    if (_needed <= _queue->capacity) return QUEUE_SUCCESS;
+
+    // Crescita geometrica degli array
+    int new_capacity = (_queue->capacity == 0) ? INITIAL_CAPACITY : _queue->capacity;
+    while (new_capacity < _needed) new_capacity *= 2;
+
+    priority_queue_entry* heap = (priority_queue_entry*)realloc(_queue->heap, new_capacity * sizeof(priority_queue_entry));
+    if (heap == NULL) return QUEUE_ERROR_ALLOC;
+    _queue->heap = heap;
+
+    int* positions = (int*)realloc(_queue->positions, new_capacity * sizeof(int));
+    if (positions == NULL) return QUEUE_ERROR_ALLOC;
+    _queue->positions = positions;
+    _queue->capacity = new_capacity;
+    return QUEUE_SUCCESS;
+}
+
+// Funzione di utilità per riusare uno slot libero oppure prenderne uno nuovo
+static int take_slot(priority_queue _queue) {
+    int slot = _queue->free_slot;
+    if (slot >= 0) {
+        _queue->free_slot = -_queue->positions[slot] - 2;
+    } else {
+        slot = _queue->num_slots++;
+    }
+    return slot;
+}
+
+// Funzione di utilità per trovare la posizione nello heap di un handle ancora valido
+static int handle_position(priority_queue _queue, priority_queue_handle _handle) {
+    if (_handle.slot < 0 || _handle.slot >= _queue->num_slots) return -1;
+
+    int position = _queue->positions[_handle.slot];
+    if (position < 0 || _queue->heap[position].sequence != _handle.sequence) return -1;
+    return position;
+}
+
 priority_queue priority_queue_create() {
     priority_queue queue = (priority_queue)malloc(sizeof(struct _priority_queue));
     if (queue == NULL) return NULL;
 
-    queue->head = NULL;
+    queue->heap = NULL;
+    queue->positions = NULL;
     queue->size = 0;
+    queue->capacity = 0;
+    queue->num_slots = 0;
+    queue->free_slot = -1;
+    queue->next_sequence = 1;   // Un handle azzerato non è mai valido
     return queue;
 }
 
 void priority_queue_destroy(priority_queue* _queue, void (*_free_element)(void*)) {
     if (_queue == NULL || *_queue == NULL) return;
 
-    priority_queue_node* current = (*_queue)->head;
-    while (current != NULL) {
-        priority_queue_node* next = current->next;
-        
-        // Libera l'elemento se è fornita una funzione per farlo
-        if (_free_element != NULL && current->element != NULL) {
-            _free_element(current->element);
-        }
-        
-        free(current);
-        current = next;
-    }
-
+    priority_queue_clear(*_queue, _free_element);
+    free((*_queue)->heap);
+    free((*_queue)->positions);
     free(*_queue);
     *_queue = NULL;
 }
 
 int priority_queue_enqueue(priority_queue _queue, void* _element, int _priority) {
+    return priority_queue_enqueue_handle(_queue, _element, _priority, NULL);
+}
+
+int priority_queue_enqueue_handle(priority_queue _queue, void* _element, int _priority, priority_queue_handle* _handle_out) {
     if (_queue == NULL) return QUEUE_ERROR_NULL;
 
-    // Crea un nuovo nodo
-    priority_queue_node* new_node = (priority_queue_node*)malloc(sizeof(priority_queue_node));
-    if (new_node == NULL) return QUEUE_ERROR_ALLOC;
+    if (reserve(_queue, _queue->size + 1) != QUEUE_SUCCESS) return QUEUE_ERROR_ALLOC;
 
-    new_node->element = _element;
-    new_node->priority = _priority;
+    int slot = take_slot(_queue);
+    priority_queue_entry entry;
+    entry.element = _element;
+    entry.priority = _priority;
+    entry.sequence = _queue->next_sequence++;
+    entry.slot = slot;
 
-    // Caso speciale: coda vuota o il nuovo elemento ha priorità maggiore della testa
-    if (_queue->head == NULL || _priority > _queue->head->priority) {
-        new_node->next = _queue->head;
-        _queue->head = new_node;
-    } else {
-        // Trova la posizione corretta in base alla priorità
-        priority_queue_node* current = _queue->head;
-        while (current->next != NULL && current->next->priority >= _priority) {
-            current = current->next;
-        }
-        
-        new_node->next = current->next;
-        current->next = new_node;
+    if (_handle_out != NULL) {
+        _handle_out->slot = slot;
+        _handle_out->sequence = entry.sequence;
     }
 
     _queue->size++;
+    place(_queue, _queue->size - 1, entry);
+    sift_up(_queue, _queue->size - 1);
     return QUEUE_SUCCESS;
 }
 
 int priority_queue_dequeue(priority_queue _queue, void** _element_out) {
     if (_queue == NULL || _element_out == NULL) return QUEUE_ERROR_NULL;
-    if (_queue->head == NULL) return QUEUE_ERROR_EMPTY;
+    if (_queue->size == 0) return QUEUE_ERROR_EMPTY;
 
-    priority_queue_node* node_to_remove = _queue->head;
-    *_element_out = node_to_remove->element;
-    
-    _queue->head = node_to_remove->next;
-    free(node_to_remove);
+    *_element_out = _queue->heap[0].element;
+    remove_at(_queue, 0);
+    return QUEUE_SUCCESS;
+}
 
-    _queue->size--;
+int priority_queue_remove(priority_queue _queue, priority_queue_handle _handle, void** _element_out) {
+    if (_queue == NULL) return QUEUE_ERROR_NULL;
+
+    int position = handle_position(_queue, _handle);
+    if (position < 0) return QUEUE_ERROR_NOT_FOUND;
+
+    if (_element_out != NULL) *_element_out = _queue->heap[position].element;
+    remove_at(_queue, position);
     return QUEUE_SUCCESS;
+}
+
+int priority_queue_change_priority(priority_queue _queue, priority_queue_handle* _handle, int _priority) {
+    if (_queue == NULL || _handle == NULL) return QUEUE_ERROR_NULL;
+
+    int position = handle_position(_queue, *_handle);
+    if (position < 0) return QUEUE_ERROR_NOT_FOUND;
+
+    priority_queue_entry* entry = &_queue->heap[position];
+    if (entry->priority == _priority) return QUEUE_SUCCESS;
+
+    // L'elemento passa in fondo agli elementi con la nuova priorità, come un nuovo inserimento
+    entry->priority = _priority;
+    entry->sequence = _queue->next_sequence++;
+    _handle->sequence = entry->sequence;
+
+    sift_up(_queue, position);
+    sift_down(_queue, _queue->positions[_handle->slot]);
+    return QUEUE_SUCCESS;
+}
+
+int priority_queue_merge(priority_queue _dest, priority_queue _src, void (*_moved)(void*, priority_queue_handle, void*), void* _context) {
+    if (_dest == NULL || _src == NULL || _dest == _src) return QUEUE_ERROR_NULL;
+    if (reserve(_dest, _dest->size + _src->size) != QUEUE_SUCCESS) return QUEUE_ERROR_ALLOC;
+
+    int old_size = _dest->size;
+    for (int i = 0; i < _src->size; i++) {
+        priority_queue_entry entry = _src->heap[i];
+
+        // Le sequenze di _src vengono traslate dopo quelle di _dest, mantenendo l'ordine relativo
+        entry.sequence += _dest->next_sequence;
+        entry.slot = take_slot(_dest);
+        place(_dest, _dest->size++, entry);
+
+        // L'handle dipende solo da slot e sequenza, non dalla posizione finale nello heap
+        if (_moved != NULL) {
+            priority_queue_handle handle = { entry.slot, entry.sequence };
+            _moved(entry.element, handle, _context);
+        }
     }
+    _dest->next_sequence += _src->next_sequence;
+
+    if (_src->size > old_size) {
+        // Pochi elementi già presenti: conviene ricostruire lo heap dal basso in tempo lineare
+        for (int i = (_dest->size - 2) / HEAP_ARITY; i >= 0; i--) {
+            sift_down(_dest, i);
+        }
+    } else {
+        for (int i = old_size; i < _dest->size; i++) {
+            sift_up(_dest, i);
+        }
+    }
+
+    _src->size = 0;
+    _src->num_slots = 0;
+    _src->free_slot = -1;
+    return QUEUE_SUCCESS;
+}
+
+bool priority_queue_contains_handle(priority_queue _queue, priority_queue_handle _handle) {
+    return (_queue != NULL && handle_position(_queue, _handle) >= 0);
+}
 
 int priority_queue_peek(priority_queue _queue, void** _element_out) {
     if (_queue == NULL || _element_out == NULL) return QUEUE_ERROR_NULL;
-    if (_queue->head == NULL) return QUEUE_ERROR_EMPTY;
+    if (_queue->size == 0) return QUEUE_ERROR_EMPTY;
 
-    *_element_out = _queue->head->element;
+    *_element_out = _queue->heap[0].element;
     return QUEUE_SUCCESS;
 }
 
@@ -107,39 +284,33 @@ int priority_queue_size(priority_queue _queue) {
 }
 
 bool priority_queue_is_empty(priority_queue _queue) {
-    return (_queue == NULL || _queue->head == NULL);
+    return (_queue == NULL || _queue->size == 0);
 }
 
 int priority_queue_clear(priority_queue _queue, void (*_free_element)(void*)) {
     if (_queue == NULL) return QUEUE_ERROR_NULL;
 
-    priority_queue_node* current = _queue->head;
-    while (current != NULL) {
-        priority_queue_node* next = current->next;
-        
-        // Libera l'elemento se è fornita una funzione per farlo
-        if (_free_element != NULL && current->element != NULL) {
-            _free_element(current->element);
+    // Libera gli elementi se è fornita una funzione per farlo
+    for (int i = 0; i < _queue->size && _free_element != NULL; i++) {
+        if (_queue->heap[i].element != NULL) {
+            _free_element(_queue->heap[i].element);
         }
-        
-        free(current);
-        current = next;
     }
 
-    _queue->head = NULL;
+    // Le sequenze non ripartono da zero: gli handle precedenti restano non validi
     _queue->size = 0;
+    _queue->num_slots = 0;
+    _queue->free_slot = -1;
     return QUEUE_SUCCESS;
 }
 
 bool priority_queue_contains(priority_queue _queue, void* _element, int (*_compare)(const void*, const void*)) {
     if (_queue == NULL || _element == NULL || _compare == NULL) return false;
 
-    priority_queue_node* current = _queue->head;
-    while (current != NULL) {
-        if (_compare(current->element, _element) == 0) {
+    for (int i = 0; i < _queue->size; i++) {
+        if (_compare(_queue->heap[i].element, _element) == 0) {
             return true;
         }
-        current = current->next;
     }
     
     return false;
@@ -4,18 +4,32 @@
  * Interfaccia di un Tipo di Dato Astratto (ADT) per una coda con priorità.
  * La coda con priorità è una struttura dati che mantiene gli elementi ordinati
  * in base alla loro priorità. Gli elementi con priorità più alta vengono estratti
- * prima degli elementi con priorità più bassa.
+ * prima degli elementi con priorità più bassa; a parità di priorità vengono estratti
+ * nell'ordine di inserimento.
+ *
+ * L'inserimento con priority_queue_enqueue_handle restituisce un handle con cui, finché l'elemento resta in coda, è possibile
+ * rimuoverlo o cambiarne la priorità in O(log n) e verificarne la presenza in O(1).
  */
 
+#ifndef QUEUE_H
+#define QUEUE_H
+
 #include <stdbool.h>
 #include <stdlib.h>
 
 typedef struct _priority_queue* priority_queue;
 
+// Riferimento a un elemento in coda
+typedef struct {
+    int slot;
+    unsigned long sequence;
+} priority_queue_handle;
+
 #define QUEUE_SUCCESS 0
 #define QUEUE_ERROR_NULL -1
 #define QUEUE_ERROR_ALLOC -2
 #define QUEUE_ERROR_EMPTY -3
+#define QUEUE_ERROR_NOT_FOUND -4
 
 /*
  * Crea una nuova coda con priorità vuota.
@@ -42,6 +56,18 @@ void priority_queue_destroy(priority_queue* _queue, void (*_free_element)(void*)
  */
 int priority_queue_enqueue(priority_queue _queue, void* _element, int _priority);
 
+/*
+ * Inserisce un elemento come priority_queue_enqueue e ne restituisce l'handle.
+ * @param _queue Coda in cui inserire.
+ * @param _element Puntatore all'elemento da inserire.
+ * @param _priority Priorità dell'elemento (valori più alti indicano priorità maggiore).
+ * @param _handle_out Puntatore dove salvare l'handle dell'elemento (può essere NULL).
+ * @return QUEUE_SUCCESS se inserito,
+ *         QUEUE_ERROR_NULL se _queue è NULL,
+ *         QUEUE_ERROR_ALLOC se fallisce l'allocazione.
+ */
+int priority_queue_enqueue_handle(priority_queue _queue, void* _element, int _priority, priority_queue_handle* _handle_out);
+
 /*
  * Estrae l'elemento con la priorità più alta dalla coda.
  * @param _queue Coda da cui estrarre.
@@ -52,6 +78,53 @@ int priority_queue_enqueue(priority_queue _queue, void* _element, int _priority)
  */
 int priority_queue_dequeue(priority_queue _queue, void** _element_out);
 
+/*
+ * Rimuove l'elemento indicato dall'handle, ovunque si trovi nella coda.
+ * @param _queue Coda da cui rimuovere.
+ * @param _handle Handle restituito dall'inserimento.
+ * @param _element_out Puntatore dove salvare il puntatore all'elemento rimosso (può essere NULL).
+ * @return QUEUE_SUCCESS se rimosso,
+ *         QUEUE_ERROR_NULL se _queue è NULL,
+ *         QUEUE_ERROR_NOT_FOUND se l'elemento non è più in coda.
+ */
+int priority_queue_remove(priority_queue _queue, priority_queue_handle _handle, void** _element_out);
+
+/*
+ * Cambia la priorità dell'elemento indicato dall'handle. L'elemento viene collocato dopo
+ * quelli che hanno già la nuova priorità, come se fosse appena stato inserito.
+ * @param _queue Coda da modificare.
+ * @param _handle Handle dell'elemento; in caso di successo viene aggiornato.
+ * @param _priority Nuova priorità.
+ * @return QUEUE_SUCCESS se modificata,
+ *         QUEUE_ERROR_NULL se _queue o _handle sono NULL,
+ *         QUEUE_ERROR_NOT_FOUND se l'elemento non è più in coda.
+ */
+int priority_queue_change_priority(priority_queue _queue, priority_queue_handle* _handle, int _priority);
+
+/*
+ * Sposta tutti gli elementi di _src in _dest; al termine _src è vuota. A parità di priorità
+ * gli elementi di _dest precedono quelli di _src, che mantengono il loro ordine. Se _dest è
+ * piccola rispetto a _src lo heap viene ricostruito in tempo lineare, altrimenti gli elementi
+ * risalgono uno alla volta. Gli handle degli elementi spostati cambiano: se fornita, _moved
+ * viene chiamata per ogni elemento con il nuovo handle.
+ * @param _dest Coda di destinazione.
+ * @param _src Coda da svuotare (deve essere diversa da _dest).
+ * @param _moved Funzione chiamata per ogni elemento spostato (può essere NULL).
+ * @param _context Puntatore passato a _moved.
+ * @return QUEUE_SUCCESS se spostati,
+ *         QUEUE_ERROR_NULL se le code sono NULL o coincidono,
+ *         QUEUE_ERROR_ALLOC se fallisce l'allocazione (nessun elemento viene spostato).
+ */
+int priority_queue_merge(priority_queue _dest, priority_queue _src, void (*_moved)(void*, priority_queue_handle, void*), void* _context);
+
+/*
+ * Verifica se l'elemento indicato dall'handle è ancora in coda.
+ * @param _queue Coda da verificare.
+ * @param _handle Handle restituito dall'inserimento.
+ * @return true se l'elemento è in coda, false altrimenti o se _queue è NULL.
+ */
+bool priority_queue_contains_handle(priority_queue _queue, priority_queue_handle _handle);
+
 /*
  * Restituisce l'elemento con la priorità più alta senza rimuoverlo.
  * @param _queue Coda da cui leggere.
@@ -87,9 +160,13 @@ int priority_queue_clear(priority_queue _queue, void (*_free_element)(void*));
 
 /*
  * Cerca un elemento nella coda utilizzando la funzione di confronto fornita.
+ * Richiede una scansione lineare: se l'elemento è stato inserito dal chiamante,
+ * priority_queue_contains_handle è più efficiente.
  * @param _queue Coda in cui cercare.
  * @param _element Elemento da cercare.
  * @param _compare Funzione di confronto tra elementi.
  * @return true se l'elemento è presente, false altrimenti.
  */
 bool priority_queue_contains(priority_queue _queue, void* _element, int (*_compare)(const void*, const void*));
+
+#endif /* QUEUE_H */
@@ -0,0 +1,183 @@
+/*
+ * route_coalescer.c
+ *
+ * Implementazione dello strato di coalescenza definito in route_coalescer.h.
+ *
+ * Le ricerche in corso sono tenute in una lista protetta da un mutex e identificate
+ * dalla chiave (partenza, arrivo, versione della rete). Il primo richiedente esegue la
+ * ricerca fuori dal mutex, salva il percorso in un array immutabile e risveglia gli altri,
+ * che ne copiano il contenuto. L'ultimo a usare il risultato lo libera. Se il primo
+ * richiedente non riesce a salvare il risultato, gli altri ripetono la ricerca per conto
+ * proprio invece di scambiare l'errore per un percorso inesistente.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "route_coalescer.h"
+
+// Ricerca in corso (o appena conclusa) condivisa da tutti i richiedenti con la stessa chiave
+typedef struct _flight {
+    weighted_direct_graph_node_id src;
+    weighted_direct_graph_node_id dst;
+    unsigned long version;
+    bool done;          // Il risultato è disponibile
+    bool failed;        // Il risultato non è stato salvato per un errore di allocazione
+    int* nodes;         // Nodi del percorso (NULL se non esiste o se failed)
+    int length;
+    int refs;           // Richiedenti che devono ancora leggere il risultato
+    struct _flight* next;
+} flight;
+
+struct _route_coalescer {
+    versioned_graph network;
+    pthread_mutex_t lock;
+    pthread_cond_t done;    // Segnalata alla conclusione di ogni ricerca
+    flight* in_flight;      // Ricerche in corso
+    unsigned long shared;   // Richieste servite da una ricerca altrui
+};
+
+route_coalescer route_coalescer_create(versioned_graph _network) {
+    if (_network == NULL) return NULL;
+
+    route_coalescer coalescer = (route_coalescer)malloc(sizeof(struct _route_coalescer));
+    if (coalescer == NULL) return NULL;
+
+    if (pthread_mutex_init(&coalescer->lock, NULL) != 0) {
+        free(coalescer);
+        return NULL;
+    }
+    if (pthread_cond_init(&coalescer->done, NULL) != 0) {
+        pthread_mutex_destroy(&coalescer->lock);
+        free(coalescer);
+        return NULL;
+    }
+
+    coalescer->network = _network;
+    coalescer->in_flight = NULL;
+    coalescer->shared = 0;
+    return coalescer;
+}
+
+void route_coalescer_destroy(route_coalescer* _coalescer) {
+    if (_coalescer == NULL || *_coalescer == NULL) return;
+
+    pthread_cond_destroy(&(*_coalescer)->done);
+    pthread_mutex_destroy(&(*_coalescer)->lock);
+    free(*_coalescer);
+    *_coalescer = NULL;
+}
+
+// Funzione di utilità per copiare il risultato di una ricerca in una nuova lista
+static linked_list flight_result(const flight* _flight) {
+    if (_flight->nodes == NULL) return NULL;
+
+    linked_list path = linked_list_create();
+    if (path == NULL) return NULL;
+
+    for (int i = 0; i < _flight->length; i++) {
+        if (linked_list_append(path, _flight->nodes[i]) != LINKED_LIST_SUCCESS) {
+            linked_list_destroy(&path);
+            return NULL;
+        }
+    }
+    return path;
+}
+
+// Funzione di utilità per rilasciare un riferimento al risultato (da chiamare con il mutex acquisito)
+static void flight_release(flight* _flight) {
+    if (--_flight->refs > 0) return;
+    free(_flight->nodes);
+    free(_flight);
+}
+
+linked_list route_coalescer_shortest_path(route_coalescer _coalescer, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
+    if (_coalescer == NULL) return NULL;
+
+    // La versione fa parte della chiave: dopo una modifica della rete non si riusa una ricerca vecchia
+    graph_version version = versioned_graph_acquire(_coalescer->network);
+    unsigned long number = graph_version_get_number(version);
+
+    pthread_mutex_lock(&_coalescer->lock);
+    flight* current = _coalescer->in_flight;
+    while (current != NULL && (current->src != _src || current->dst != _dst || current->version != number)) {
+        current = current->next;
+    }
+
+    if (current != NULL) {
+        // Ricerca identica in corso: attende il risultato senza ricalcolarlo
+        graph_version_release(&version);
+        current->refs++;
+        _coalescer->shared++;
+        while (!current->done) {
+            pthread_cond_wait(&_coalescer->done, &_coalescer->lock);
+        }
+        pthread_mutex_unlock(&_coalescer->lock);
+
+        bool failed = current->failed;
+        linked_list path = failed ? NULL : flight_result(current);
+
+        pthread_mutex_lock(&_coalescer->lock);
+        flight_release(current);
+        pthread_mutex_unlock(&_coalescer->lock);
+
+        if (failed) {
+            version = versioned_graph_acquire(_coalescer->network);
+            path = weighted_direct_graph_shortest_path(graph_version_get_graph(version), _src, _dst);
+            graph_version_release(&version);
+        }
+        return path;
+    }
+
+    current = (flight*)calloc(1, sizeof(flight));
+    if (current == NULL) {
+        pthread_mutex_unlock(&_coalescer->lock);
+        graph_version_release(&version);
+        return NULL;
+    }
+    current->src = _src;
+    current->dst = _dst;
+    current->version = number;
+    current->refs = 1;
+    current->next = _coalescer->in_flight;
+    _coalescer->in_flight = current;
+    pthread_mutex_unlock(&_coalescer->lock);
+
+    // Esegue la ricerca fuori dal mutex, sulla versione fissata
+    linked_list path = weighted_direct_graph_shortest_path(graph_version_get_graph(version), _src, _dst);
+    graph_version_release(&version);
+
+    int length = (path != NULL) ? linked_list_size(path) : 0;
+    int* nodes = (path != NULL) ? (int*)malloc((length + 1) * sizeof(int)) : NULL;
+    for (int i = 0; nodes != NULL && i < length; i++) {
+        linked_list_get_at(path, i, &nodes[i]);
+    }
+
+    pthread_mutex_lock(&_coalescer->lock);
+    current->nodes = nodes;
+    current->length = length;
+    current->failed = (path != NULL && nodes == NULL);
+    current->done = true;
+
+    // La ricerca conclusa esce dalla lista: le richieste successive ne avviano una nuova
+    flight** link = &_coalescer->in_flight;
+    while (*link != current) {
+        link = &(*link)->next;
+    }
+    *link = current->next;
+
+    pthread_cond_broadcast(&_coalescer->done);
+    flight_release(current);
+    pthread_mutex_unlock(&_coalescer->lock);
+
+    // Se la copia per gli altri non è riuscita, il richiedente usa comunque la propria lista
+    return path;
+}
+
+unsigned long route_coalescer_shared_count(route_coalescer _coalescer) {
+    if (_coalescer == NULL) return 0;
+
+    pthread_mutex_lock(&_coalescer->lock);
+    unsigned long shared = _coalescer->shared;
+    pthread_mutex_unlock(&_coalescer->lock);
+    return shared;
+}
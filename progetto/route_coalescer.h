@@ -0,0 +1,53 @@
+/*
+ * route_coalescer.h
+ *
+ * Interfaccia di uno strato di coalescenza ("single flight") davanti al calcolo dei
+ * percorsi minimi su una rete versionata. Se più thread chiedono contemporaneamente lo
+ * stesso percorso (stessa partenza, stesso arrivo, stessa versione della rete), la ricerca
+ * viene eseguita una sola volta: gli altri attendono il risultato e ne ricevono una copia.
+ *
+ * Il risultato non viene conservato dopo la conclusione della ricerca: lo strato elimina
+ * le ricerche duplicate durante i picchi, non è una cache.
+ */
+
+#ifndef ROUTE_COALESCER_H
+#define ROUTE_COALESCER_H
+
+#include "versioned_graph.h"
+#include "linked_list.h"
+
+typedef struct _route_coalescer* route_coalescer;
+
+/*
+ * Crea uno strato di coalescenza per la rete indicata. La rete non viene acquisita:
+ * deve restare valida finché lo strato esiste.
+ * @param _network Rete versionata su cui calcolare i percorsi.
+ * @return Strato creato, oppure NULL se _network è NULL o fallisce l'allocazione.
+ */
+route_coalescer route_coalescer_create(versioned_graph _network);
+
+/*
+ * Distrugge lo strato. Non devono esserci ricerche in corso.
+ * @param _coalescer Puntatore allo strato; dopo la chiamata *_coalescer sarà NULL.
+ */
+void route_coalescer_destroy(route_coalescer* _coalescer);
+
+/*
+ * Calcola il percorso minimo da _src a _dst sulla versione corrente della rete, unendosi
+ * a una ricerca identica già in corso se presente.
+ * @param _coalescer Strato da usare.
+ * @param _src Nodo di partenza.
+ * @param _dst Nodo di arrivo.
+ * @return Lista dei nodi del percorso (di proprietà del chiamante), oppure NULL se il
+ *         percorso non esiste, i parametri non sono validi o fallisce l'allocazione.
+ */
+linked_list route_coalescer_shortest_path(route_coalescer _coalescer, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst);
+
+/*
+ * Restituisce il numero di richieste servite dal risultato di una ricerca già in corso.
+ * @param _coalescer Strato da interrogare.
+ * @return Numero di richieste unite, oppure 0 se _coalescer è NULL.
+ */
+unsigned long route_coalescer_shared_count(route_coalescer _coalescer);
+
+#endif /* ROUTE_COALESCER_H */
@@ -0,0 +1,112 @@
+/*
+ * string_pool.c
+ *
+ * Implementazione del pool di stringhe definito in string_pool.h.
+ *
+ * Le pagine formano una lista: le stringhe vengono copiate in coda all'ultima pagina e,
+ * quando non c'è più spazio, se ne alloca una nuova. Lo spazio rimasto libero in fondo
+ * alle pagine precedenti non viene riutilizzato. Una stringa più lunga di una pagina
+ * riceve una pagina dedicata della dimensione giusta.
+ */
+
+#include <string.h>
+#include "hash_index.h"
+#include "string_pool.h"
+
+#define PAGE_SIZE 4096              // Byte di stringhe per pagina
+
+typedef struct string_pool_page {
+    struct string_pool_page* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} string_pool_page;
+
+struct _string_pool {
+    string_pool_page* pages;        // Pagina corrente in testa
+    hash_index strings;             // Stringa internata -> se stessa
+};
+
+// Funzione di utilità per riservare _length byte contigui nell'arena
+static char* allocate(string_pool _pool, size_t _length) {
+    string_pool_page* page = _pool->pages;
+
+    if (page == NULL || page->capacity - page->used < _length) {
+        size_t capacity = (_length > PAGE_SIZE) ? _length : PAGE_SIZE;
+        page = (string_pool_page*)malloc(sizeof(string_pool_page) + capacity);
+        if (page == NULL) return NULL;
+
+        page->used = 0;
+        page->capacity = capacity;
+
+        // Una pagina dedicata a una stringa lunga non diventa la pagina corrente
+        if (capacity > PAGE_SIZE && _pool->pages != NULL) {
+            page->next = _pool->pages->next;
+            _pool->pages->next = page;
+        } else {
+            page->next = _pool->pages;
+            _pool->pages = page;
+        }
+    }
+
+    char* memory = page->data + page->used;
+    page->used += _length;
+    return memory;
+}
+
+string_pool string_pool_create(int _expected_size) {
+    string_pool pool = (string_pool)malloc(sizeof(struct _string_pool));
+    if (pool == NULL) return NULL;
+
+    pool->strings = hash_index_create(_expected_size);
+    if (pool->strings == NULL) {
+        free(pool);
+        return NULL;
+    }
+
+    pool->pages = NULL;
+    return pool;
+}
+
+void string_pool_destroy(string_pool* _pool) {
+    if (_pool == NULL || *_pool == NULL) return;
+
+    hash_index_destroy(&((*_pool)->strings));
+
+    string_pool_page* page = (*_pool)->pages;
+    while (page != NULL) {
+        string_pool_page* next = page->next;
+        free(page);
+        page = next;
+    }
+
+    free(*_pool);
+    *_pool = NULL;
+}
+
+const char* string_pool_intern(string_pool _pool, const char* _string) {
+    if (_pool == NULL || _string == NULL) return NULL;
+
+    const char* interned = hash_index_get(_pool->strings, _string);
+    if (interned != NULL) return interned;
+
+    size_t length = strlen(_string) + 1;
+    char* copy = allocate(_pool, length);
+    if (copy == NULL) return NULL;
+    memcpy(copy, _string, length);
+
+    // Se l'indice non può crescere la copia resta nell'arena inutilizzata fino alla distruzione
+    if (hash_index_put(_pool->strings, copy, copy) != HASH_INDEX_SUCCESS) return NULL;
+
+    return copy;
+}
+
+const char* string_pool_find(string_pool _pool, const char* _string) {
+    if (_pool == NULL || _string == NULL) return NULL;
+    return hash_index_get(_pool->strings, _string);
+}
+
+int string_pool_size(string_pool _pool) {
+    if (_pool == NULL) return STRING_POOL_ERROR_NULL;
+    return hash_index_size(_pool->strings);
+}
@@ -0,0 +1,67 @@
+/*
+ * string_pool.h
+ *
+ * Interfaccia di un Tipo di Dato Astratto (ADT) per un pool di stringhe internate.
+ *
+ * Ogni stringa distinta viene memorizzata una sola volta, copiata in pagine di memoria
+ * contigue (arena) che non vengono mai spostate né liberate prima della distruzione del
+ * pool: il puntatore restituito da string_pool_intern resta quindi valido e invariato
+ * per tutta la vita del pool. Internare due volte la stessa stringa restituisce lo
+ * stesso puntatore, per cui due stringhe internate nello stesso pool sono uguali se e
+ * solo se i loro puntatori coincidono.
+ *
+ * Le stringhe vengono allocate una pagina alla volta invece che una per stringa; la
+ * ricerca dei duplicati usa un indice hash (hash_index).
+ */
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <stdlib.h>
+
+typedef struct _string_pool* string_pool;
+
+#define STRING_POOL_SUCCESS 0
+#define STRING_POOL_ERROR_NULL -1
+
+/*
+ * Crea un nuovo pool vuoto.
+ * @param _expected_size Numero di stringhe distinte previsto, per evitare ridimensionamenti (può essere 0).
+ * @return Puntatore al pool creato, oppure NULL se fallisce l'allocazione.
+ */
+string_pool string_pool_create(int _expected_size);
+
+/*
+ * Distrugge il pool e tutte le stringhe internate.
+ * Dopo la chiamata nessun puntatore restituito dal pool è più valido.
+ * @param _pool Puntatore al puntatore del pool da distruggere.
+ *              Dopo la chiamata, *_pool sarà impostato a NULL.
+ */
+void string_pool_destroy(string_pool* _pool);
+
+/*
+ * Restituisce la copia internata di una stringa, creandola se non è ancora presente.
+ * @param _pool Pool in cui internare.
+ * @param _string Stringa da internare (non deve restare valida dopo la chiamata).
+ * @return Puntatore stabile alla copia internata,
+ *         oppure NULL se un parametro è NULL o fallisce l'allocazione.
+ */
+const char* string_pool_intern(string_pool _pool, const char* _string);
+
+/*
+ * Cerca la copia internata di una stringa senza inserirla.
+ * @param _pool Pool in cui cercare.
+ * @param _string Stringa da cercare.
+ * @return Puntatore alla copia internata, oppure NULL se la stringa non è mai stata
+ *         internata o un parametro è NULL.
+ */
+const char* string_pool_find(string_pool _pool, const char* _string);
+
+/*
+ * Restituisce il numero di stringhe distinte internate.
+ * @param _pool Pool da interrogare.
+ * @return Numero di stringhe, oppure STRING_POOL_ERROR_NULL se _pool è NULL.
+ */
+int string_pool_size(string_pool _pool);
+
+#endif /* STRING_POOL_H */
@@ -0,0 +1,163 @@
+/*
+ * typed_array.h
+ *
+ * Array dinamici specializzati per tipo, generati a tempo di compilazione.
+ *
+ * A differenza di dynamic_array, che memorizza gli elementi come blocchi di byte di
+ * dimensione nota solo a runtime e li copia con memcpy, DA_DEFINE(Tipo) genera una
+ * struttura Tipo_array con un puntatore Tipo* ai dati e funzioni inline dedicate:
+ * la dimensione dell'elemento è nota al compilatore e l'accesso diventa semplice
+ * aritmetica dei puntatori.
+ *
+ * La struttura generata non è opaca: può essere inclusa per valore in un'altra
+ * struttura. Oltre alle funzioni con controllo degli indici sono disponibili le macro
+ * DA_AT e DA_FOR_EACH, senza controlli, per i cicli in cui gli indici sono già validi.
+ * Gli array ordinati secondo una chiave intera possono essere interrogati con una
+ * ricerca binaria (lower_bound_key, find_key).
+ * I codici di ritorno sono quelli di dynamic_array.
+ *
+ * Esempio:
+ *     DA_DEFINE(Veicolo)
+ *     Veicolo_array veicoli;
+ *     Veicolo_array_init(&veicoli, 10);
+ *     DA_FOR_EACH(Veicolo, v, &veicoli) { ... *v ... }
+ */
+
+#ifndef TYPED_ARRAY_H
+#define TYPED_ARRAY_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dynamic_array.h"
+
+#define TYPED_ARRAY_GROWTH_FACTOR 2
+
+// Accesso senza controlli all'elemento in posizione _index
+#define DA_AT(_array, _index) ((_array)->data[_index])
+
+// Scorre gli elementi dell'array; _var è un puntatore _type* all'elemento corrente.
+// La fine viene ricalcolata a ogni passo, ma l'array non deve essere riallocato durante il ciclo.
+#define DA_FOR_EACH(_type, _var, _array) \
+    for (_type* _var = (_array)->data; _var < (_array)->data + (_array)->size; _var++)
+
+#define DA_DEFINE(_type) \
+    typedef struct { \
+        _type* data; \
+        int size; \
+        int capacity; \
+    } _type##_array; \
+    \
+    /* Inizializza un array vuoto con la capacità indicata (≥ 1) */ \
+    static inline int _type##_array_init(_type##_array* _array, int _initial_capacity) { \
+        if (_array == NULL) return DYN_ARRAY_ERROR_NULL; \
+        _array->size = 0; \
+        _array->capacity = 0; \
+        _array->data = NULL; \
+        if (_initial_capacity <= 0) return DYN_ARRAY_ERROR_INDEX; \
+        _array->data = (_type*)malloc(_initial_capacity * sizeof(_type)); \
+        if (_array->data == NULL) return DYN_ARRAY_ERROR_ALLOC; \
+        _array->capacity = _initial_capacity; \
+        return DYN_ARRAY_SUCCESS; \
+    } \
+    \
+    /* Libera il buffer dell'array (non gli elementi) */ \
+    static inline void _type##_array_release(_type##_array* _array) { \
+        if (_array == NULL) return; \
+        free(_array->data); \
+        _array->data = NULL; \
+        _array->size = 0; \
+        _array->capacity = 0; \
+    } \
+    \
+    /* Garantisce spazio per almeno _capacity elementi */ \
+    static inline int _type##_array_reserve(_type##_array* _array, int _capacity) { \
+        if (_array == NULL) return DYN_ARRAY_ERROR_NULL; \
+        if (_capacity <= _array->capacity) return DYN_ARRAY_SUCCESS; \
+        int new_capacity = (_array->capacity > 0) ? _array->capacity : 1; \
+        while (new_capacity < _capacity) new_capacity *= TYPED_ARRAY_GROWTH_FACTOR; \
+        _type* new_data = (_type*)realloc(_array->data, new_capacity * sizeof(_type)); \
+        if (new_data == NULL) return DYN_ARRAY_ERROR_ALLOC; \
+        _array->data = new_data; \
+        _array->capacity = new_capacity; \
+        return DYN_ARRAY_SUCCESS; \
+    } \
+    \
+    /* Aggiunge un elemento in coda */ \
+    static inline int _type##_array_append(_type##_array* _array, _type _element) { \
+        if (_array == NULL) return DYN_ARRAY_ERROR_NULL; \
+        if (_array->size == _array->capacity) { \
+            int result = _type##_array_reserve(_array, _array->size + 1); \
+            if (result != DYN_ARRAY_SUCCESS) return result; \
+        } \
+        _array->data[_array->size++] = _element; \
+        return DYN_ARRAY_SUCCESS; \
+    } \
+    \
+    /* Porta la dimensione a _size; le nuove posizioni valgono _fill */ \
+    static inline int _type##_array_resize(_type##_array* _array, int _size, _type _fill) { \
+        if (_array == NULL) return DYN_ARRAY_ERROR_NULL; \
+        if (_size < 0) return DYN_ARRAY_ERROR_INDEX; \
+        int result = _type##_array_reserve(_array, _size); \
+        if (result != DYN_ARRAY_SUCCESS) return result; \
+        for (int i = _array->size; i < _size; i++) _array->data[i] = _fill; \
+        _array->size = _size; \
+        return DYN_ARRAY_SUCCESS; \
+    } \
+    \
+    /* Inserisce un elemento in posizione _index (0..size) spostando i successivi */ \
+    static inline int _type##_array_insert_at(_type##_array* _array, int _index, _type _element) { \
+        if (_array == NULL) return DYN_ARRAY_ERROR_NULL; \
+        if (_index < 0 || _index > _array->size) return DYN_ARRAY_ERROR_INDEX; \
+        int result = _type##_array_reserve(_array, _array->size + 1); \
+        if (result != DYN_ARRAY_SUCCESS) return result; \
+        memmove(&_array->data[_index + 1], &_array->data[_index], (_array->size - _index) * sizeof(_type)); \
+        _array->data[_index] = _element; \
+        _array->size++; \
+        return DYN_ARRAY_SUCCESS; \
+    } \
+    \
+    /* Rimuove l'elemento in posizione _index spostando i successivi */ \
+    static inline int _type##_array_remove_at(_type##_array* _array, int _index) { \
+        if (_array == NULL) return DYN_ARRAY_ERROR_NULL; \
+        if (_index < 0 || _index >= _array->size) return DYN_ARRAY_ERROR_INDEX; \
+        memmove(&_array->data[_index], &_array->data[_index + 1], (_array->size - _index - 1) * sizeof(_type)); \
+        _array->size--; \
+        return DYN_ARRAY_SUCCESS; \
+    } \
+    \
+    /* Puntatore all'elemento in posizione _index, oppure NULL se fuori dai limiti */ \
+    static inline _type* _type##_array_get_at(_type##_array* _array, int _index) { \
+        if (_array == NULL || _index < 0 || _index >= _array->size) return NULL; \
+        return &_array->data[_index]; \
+    } \
+    \
+    /* Prima posizione con chiave non minore di _value (l'array deve essere ordinato per chiave) */ \
+    static inline int _type##_array_lower_bound_key(const _type##_array* _array, int (*_key)(_type), int _value) { \
+        if (_array == NULL || _key == NULL) return DYN_ARRAY_ERROR_NULL; \
+        int low = 0; \
+        int high = _array->size; \
+        while (low < high) { \
+            int mid = low + (high - low) / 2; \
+            if (_key(_array->data[mid]) < _value) low = mid + 1; \
+            else high = mid; \
+        } \
+        return low; \
+    } \
+    \
+    /* Indice dell'elemento con chiave _value, oppure -1 (l'array deve essere ordinato per chiave) */ \
+    static inline int _type##_array_find_key(const _type##_array* _array, int (*_key)(_type), int _value) { \
+        int index = _type##_array_lower_bound_key(_array, _key, _value); \
+        if (index < 0 || index == _array->size || _key(_array->data[index]) != _value) return -1; \
+        return index; \
+    } \
+    \
+    static inline int _type##_array_size(const _type##_array* _array) { \
+        return (_array != NULL) ? _array->size : DYN_ARRAY_ERROR_NULL; \
+    } \
+    \
+    static inline bool _type##_array_is_empty(const _type##_array* _array) { \
+        return (_array == NULL || _array->size == 0); \
+    }
+
+#endif /* TYPED_ARRAY_H */
@@ -3,7 +3,7 @@
 #include <string.h>
 
 struct Veicolo {
-    char* targa;              
+    const char* targa;        // Non posseduta: internata dal gestore
     int capacita;             
     StatoOperativoVeicolo stato; 
     dynamic_array carichi;     
@@ -15,18 +15,13 @@ Veicolo veicolo_create(const char* _targa, int _capacita) {
     Veicolo veicolo = (Veicolo)malloc(sizeof(struct Veicolo));
     if (veicolo == NULL) return NULL;
 
-    veicolo->targa = strdup(_targa);
-    if (veicolo->targa == NULL) {
-        free(veicolo);
-        return NULL;
-    }
+    veicolo->targa = _targa;
 
     veicolo->capacita = _capacita;
     veicolo->stato = STATO_DISPONIBILE;
 
     veicolo->carichi = dynamic_array_create(5, sizeof(void*));
     if (veicolo->carichi == NULL) {
-        free(veicolo->targa);
         free(veicolo);
         return NULL;
     }
@@ -37,9 +32,6 @@ Veicolo veicolo_create(const char* _targa, int _capacita) {
 void veicolo_destroy(Veicolo* _veicolo) {
     if (_veicolo == NULL || *_veicolo == NULL) return;
 
-    // Libera la targa
-    free((*_veicolo)->targa);
-
     // Libera l'array dinamico dei carichi
     // Nota: non liberiamo i carichi stessi, poiché potrebbero essere
     // referenziati altrove
@@ -100,7 +92,7 @@ int veicolo_remove_carico(Veicolo _veicolo, void* _carico) {
         void** carico_ptr = (void**)dynamic_array_get_at(_veicolo->carichi, i);
         if (carico_ptr != NULL && *carico_ptr == _carico) {
             // Rimuovi il carico dall'array
-            return dynamic_array_remove_at(_veicolo->carichi, i, NULL);
+            return dynamic_array_swap_remove(_veicolo->carichi, i, NULL);
         }
     }
     
@@ -15,7 +15,7 @@ typedef enum {
 
 /*
  * Crea un nuovo veicolo
- * @param _targa Targa del veicolo
+ * @param _targa Targa del veicolo (non viene copiata: deve restare valida per tutta la vita del veicolo)
  * @param _capacita Capacità massima del veicolo in kg
  * @return Puntatore al veicolo creato, oppure NULL in caso di errore
  */
@@ -66,6 +66,7 @@ int veicolo_add_carico(Veicolo _veicolo, void* _carico);
 
 /*
  * Rimuove un carico dal veicolo
+ * L'ultimo carico prende il posto di quello rimosso: l'ordine dei carichi non viene mantenuto
  * @param _veicolo Veicolo da cui rimuovere il carico
  * @param _carico Carico da rimuovere
  * @return 0 se rimosso con successo, -1 altrimenti
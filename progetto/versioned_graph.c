@@ -0,0 +1,219 @@
+/*
+ * versioned_graph.c
+ *
+ * Implementazione del contenitore di versioni definito in versioned_graph.h.
+ *
+ * La versione corrente è un puntatore atomico a una struttura con contatore di
+ * riferimenti: il contenitore ne possiede uno, ogni lettore che la fissa un altro.
+ * La difficoltà è che un lettore potrebbe leggere il puntatore e incrementarne il
+ * contatore quando la versione è già stata liberata. Per evitarlo i lettori si
+ * registrano in uno di due contatori di epoca durante quella breve finestra; dopo aver
+ * sostituito il puntatore lo scrittore cambia epoca e attende che il contatore
+ * dell'epoca precedente si azzeri (un periodo di grazia, come nell'RCU). Solo a quel
+ * punto rilascia il riferimento del contenitore alla versione superata. Un lettore
+ * considera valida la propria registrazione solo se, dopo averla fatta, l'epoca è
+ * ancora quella in cui si è registrato; altrimenti riprova.
+ *
+ * Gli scrittori sono serializzati da un indicatore di bozza aperta, protetto da un mutex
+ * che non è mai preso dai lettori. Il mutex è tenuto solo per aprire e chiudere la bozza,
+ * non per tutta la sua durata: così la bozza può essere chiusa da un altro thread.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "versioned_graph.h"
+
+struct _graph_version {
+    weighted_direct_graph graph;
+    unsigned long number;
+    atomic_int refs;
+};
+
+struct _versioned_graph {
+    _Atomic(struct _graph_version*) current;
+    atomic_uint epoch;              // Epoca corrente dei lettori
+    atomic_int pinning[2];          // Lettori nella finestra di acquisizione, per parità di epoca
+    pthread_mutex_t write_lock;     // Protegge writing
+    pthread_cond_t write_done;      // Segnalata quando la bozza viene chiusa
+    bool writing;                   // Una bozza è aperta o in preparazione
+    weighted_direct_graph draft;    // Bozza aperta (NULL se nessuna)
+    struct _graph_version* draft_version; // Versione preparata per la bozza
+};
+
+// Funzione di utilità per creare una versione con un solo riferimento
+static struct _graph_version* version_create(weighted_direct_graph _graph, unsigned long _number) {
+    struct _graph_version* version = (struct _graph_version*)malloc(sizeof(struct _graph_version));
+    if (version == NULL) return NULL;
+
+    version->graph = _graph;
+    version->number = _number;
+    atomic_init(&version->refs, 1);
+    return version;
+}
+
+// Funzione di utilità per rilasciare un riferimento, distruggendo la versione all'ultimo
+static void version_release(struct _graph_version* _version) {
+    if (atomic_fetch_sub(&_version->refs, 1) == 1) {
+        weighted_direct_graph_destroy(&_version->graph);
+        free(_version);
+    }
+}
+
+// Funzione di utilità per attendere che nessun lettore possa ancora leggere la versione sostituita
+static void wait_for_readers(versioned_graph _versioned) {
+    unsigned int old_epoch = atomic_fetch_add(&_versioned->epoch, 1);
+    while (atomic_load(&_versioned->pinning[old_epoch & 1]) > 0) {
+        sched_yield();
+    }
+}
+
+versioned_graph versioned_graph_create(weighted_direct_graph _initial) {
+    if (_initial == NULL) return NULL;
+
+    versioned_graph versioned = (versioned_graph)malloc(sizeof(struct _versioned_graph));
+    if (versioned == NULL) return NULL;
+
+    struct _graph_version* version = version_create(_initial, 1);
+    if (version == NULL || pthread_mutex_init(&versioned->write_lock, NULL) != 0) {
+        free(version);
+        free(versioned);
+        return NULL;
+    }
+    if (pthread_cond_init(&versioned->write_done, NULL) != 0) {
+        pthread_mutex_destroy(&versioned->write_lock);
+        free(version);
+        free(versioned);
+        return NULL;
+    }
+
+    atomic_init(&versioned->current, version);
+    atomic_init(&versioned->epoch, 0);
+    atomic_init(&versioned->pinning[0], 0);
+    atomic_init(&versioned->pinning[1], 0);
+    versioned->writing = false;
+    versioned->draft = NULL;
+    versioned->draft_version = NULL;
+    return versioned;
+}
+
+void versioned_graph_destroy(versioned_graph* _versioned) {
+    if (_versioned == NULL || *_versioned == NULL) return;
+
+    versioned_graph versioned = *_versioned;
+    if (versioned->draft != NULL) {
+        weighted_direct_graph_destroy(&versioned->draft);
+        free(versioned->draft_version);
+    }
+    version_release(atomic_load(&versioned->current));
+    pthread_cond_destroy(&versioned->write_done);
+    pthread_mutex_destroy(&versioned->write_lock);
+
+    free(versioned);
+    *_versioned = NULL;
+}
+
+graph_version versioned_graph_acquire(versioned_graph _versioned) {
+    if (_versioned == NULL) return NULL;
+
+    // Finché il lettore è registrato nell'epoca, lo scrittore non rilascia la versione letta.
+    // La registrazione vale solo se l'epoca non è cambiata nel frattempo: uno scrittore che
+    // l'avesse già superata non aspetterebbe questo contatore, e uno successivo aspetterebbe
+    // solo l'altro, liberando la versione appena letta prima dell'incremento dei riferimenti
+    unsigned int epoch;
+    for (;;) {
+        epoch = atomic_load(&_versioned->epoch);
+        atomic_fetch_add(&_versioned->pinning[epoch & 1], 1);
+        if (atomic_load(&_versioned->epoch) == epoch) break;
+        atomic_fetch_sub(&_versioned->pinning[epoch & 1], 1);
+    }
+
+    struct _graph_version* version = atomic_load(&_versioned->current);
+    atomic_fetch_add(&version->refs, 1);
+    atomic_fetch_sub(&_versioned->pinning[epoch & 1], 1);
+
+    return version;
+}
+
+void graph_version_release(graph_version* _version) {
+    if (_version == NULL || *_version == NULL) return;
+
+    version_release(*_version);
+    *_version = NULL;
+}
+
+weighted_direct_graph graph_version_get_graph(graph_version _version) {
+    if (_version == NULL) return NULL;
+    return _version->graph;
+}
+
+unsigned long graph_version_get_number(graph_version _version) {
+    if (_version == NULL) return 0;
+    return _version->number;
+}
+
+unsigned long versioned_graph_current_number(versioned_graph _versioned) {
+    if (_versioned == NULL) return 0;
+    return atomic_load(&_versioned->current)->number;
+}
+
+// Funzione di utilità per chiudere la bozza e svegliare uno scrittore in attesa
+static void end_write(versioned_graph _versioned) {
+    pthread_mutex_lock(&_versioned->write_lock);
+    _versioned->writing = false;
+    pthread_cond_signal(&_versioned->write_done);
+    pthread_mutex_unlock(&_versioned->write_lock);
+}
+
+weighted_direct_graph versioned_graph_begin_write(versioned_graph _versioned) {
+    if (_versioned == NULL) return NULL;
+
+    pthread_mutex_lock(&_versioned->write_lock);
+    while (_versioned->writing) {
+        pthread_cond_wait(&_versioned->write_done, &_versioned->write_lock);
+    }
+    _versioned->writing = true;
+    pthread_mutex_unlock(&_versioned->write_lock);
+
+    // Solo lo scrittore sostituisce la versione corrente, quindi qui può leggerla senza fissarla
+    struct _graph_version* current = atomic_load(&_versioned->current);
+    weighted_direct_graph draft = weighted_direct_graph_clone(current->graph);
+    struct _graph_version* version = version_create(draft, current->number + 1);
+    if (draft == NULL || version == NULL) {
+        weighted_direct_graph_destroy(&draft);
+        free(version);
+        end_write(_versioned);
+        return NULL;
+    }
+
+    _versioned->draft = draft;
+    _versioned->draft_version = version;
+    return draft;
+}
+
+int versioned_graph_publish(versioned_graph _versioned) {
+    if (_versioned == NULL) return VG_ERROR_NULL;
+    if (_versioned->draft == NULL) return VG_ERROR_NO_DRAFT;
+
+    struct _graph_version* old = atomic_exchange(&_versioned->current, _versioned->draft_version);
+    _versioned->draft = NULL;
+    _versioned->draft_version = NULL;
+
+    wait_for_readers(_versioned);
+    version_release(old);
+
+    end_write(_versioned);
+    return VG_SUCCESS;
+}
+
+void versioned_graph_abort(versioned_graph _versioned) {
+    if (_versioned == NULL || _versioned->draft == NULL) return;
+
+    weighted_direct_graph_destroy(&_versioned->draft);
+    free(_versioned->draft_version);
+    _versioned->draft_version = NULL;
+
+    end_write(_versioned);
+}
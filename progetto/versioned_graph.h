@@ -0,0 +1,109 @@
+/*
+ * versioned_graph.h
+ *
+ * Interfaccia di un contenitore di versioni di un grafo orientato pesato, pensato per
+ * una rete stradale letta da più thread e modificata raramente.
+ *
+ * I lettori fissano la versione corrente (versioned_graph_acquire) senza prendere lock e
+ * la usano finché non la rilasciano: una versione pubblicata non viene più modificata.
+ * Uno scrittore alla volta ottiene una bozza (clone della versione corrente), la modifica
+ * con le normali funzioni del grafo e la pubblica in modo atomico. Una versione superata
+ * viene distrutta solo quando l'ultimo lettore che la usa la rilascia.
+ *
+ * I nodi sono condivisi tra tutte le versioni (vedi weighted_direct_graph_clone), quindi
+ * i puntatori Node restano validi finché esiste almeno una versione.
+ */
+
+#ifndef VERSIONED_GRAPH_H
+#define VERSIONED_GRAPH_H
+
+#include "weighted_directed_graph.h"
+
+typedef struct _versioned_graph* versioned_graph;
+typedef struct _graph_version* graph_version;
+
+// Codici di ritorno
+#define VG_SUCCESS 0                 // Operazione completata correttamente
+#define VG_ERROR_NULL -1             // Puntatore NULL passato come parametro
+#define VG_ERROR_NO_DRAFT -2         // Nessuna bozza aperta da pubblicare
+
+/*
+ * Crea un contenitore di versioni a partire da un grafo, che diventa la versione 1.
+ * Il contenitore acquisisce il grafo: non va più modificato né distrutto dal chiamante.
+ * @param _initial Grafo iniziale.
+ * @return Contenitore creato, oppure NULL se _initial è NULL o fallisce l'allocazione.
+ */
+versioned_graph versioned_graph_create(weighted_direct_graph _initial);
+
+/*
+ * Distrugge il contenitore, scartando l'eventuale bozza aperta. Le versioni ancora
+ * fissate dai lettori restano valide fino al loro rilascio.
+ * @param _versioned Puntatore al contenitore; dopo la chiamata *_versioned sarà NULL.
+ */
+void versioned_graph_destroy(versioned_graph* _versioned);
+
+/*
+ * Fissa la versione corrente per la lettura, senza lock: la versione resta valida e
+ * immutabile fino a graph_version_release, anche se nel frattempo ne viene pubblicata
+ * una nuova.
+ * @param _versioned Contenitore da interrogare.
+ * @return Versione fissata, oppure NULL se _versioned è NULL.
+ */
+graph_version versioned_graph_acquire(versioned_graph _versioned);
+
+/*
+ * Rilascia una versione fissata con versioned_graph_acquire.
+ * @param _version Puntatore alla versione; dopo la chiamata *_version sarà NULL.
+ */
+void graph_version_release(graph_version* _version);
+
+/*
+ * Restituisce il grafo di una versione fissata. Il grafo va usato solo in lettura.
+ * @param _version Versione da interrogare.
+ * @return Grafo della versione, oppure NULL se _version è NULL.
+ */
+weighted_direct_graph graph_version_get_graph(graph_version _version);
+
+/*
+ * Restituisce il numero progressivo di una versione (1 per il grafo iniziale).
+ * @param _version Versione da interrogare.
+ * @return Numero della versione, oppure 0 se _version è NULL.
+ */
+unsigned long graph_version_get_number(graph_version _version);
+
+/*
+ * Restituisce il numero della versione corrente.
+ * @param _versioned Contenitore da interrogare.
+ * @return Numero della versione corrente, oppure 0 se _versioned è NULL.
+ */
+unsigned long versioned_graph_current_number(versioned_graph _versioned);
+
+/*
+ * Apre una bozza della prossima versione, clonando quella corrente. Gli scrittori sono
+ * serializzati: la chiamata attende che la bozza aperta in precedenza sia pubblicata o
+ * scartata. La bozza va chiusa con versioned_graph_publish o versioned_graph_abort,
+ * anche da un thread diverso da quello che l'ha aperta, purché le chiamate sulla stessa
+ * bozza non si sovrappongano.
+ * @param _versioned Contenitore su cui operare.
+ * @return Grafo modificabile della bozza, oppure NULL se _versioned è NULL o fallisce
+ *         la clonazione (in tal caso nessuna bozza resta aperta).
+ */
+weighted_direct_graph versioned_graph_begin_write(versioned_graph _versioned);
+
+/*
+ * Pubblica la bozza come nuova versione corrente. I lettori che avevano già fissato la
+ * versione precedente continuano a usarla; la precedente viene distrutta all'ultimo rilascio.
+ * @param _versioned Contenitore su cui operare.
+ * @return VG_SUCCESS se pubblicata,
+ *         VG_ERROR_NULL se _versioned è NULL,
+ *         VG_ERROR_NO_DRAFT se non c'è una bozza aperta.
+ */
+int versioned_graph_publish(versioned_graph _versioned);
+
+/*
+ * Scarta la bozza aperta; la versione corrente non cambia.
+ * @param _versioned Contenitore su cui operare.
+ */
+void versioned_graph_abort(versioned_graph _versioned);
+
+#endif /* VERSIONED_GRAPH_H */
@@ -5,6 +5,33 @@
  * rappresentato tramite matrice di adiacenza dei pesi. I nodi sono identificati da interi
  * e ogni arco ha un peso associato. Supporta operazioni di creazione, accesso, inserimento,
  * rimozione, visite (DFS, BFS) e calcolo di percorsi e pesi.
+ *
+ * In alternativa alla matrice, il grafo può essere convertito in una rappresentazione
+ * compressa di sola lettura (liste di adiacenza ordinate, codificate come differenze
+ * varint, con pesi a 16 bit quando possibile). Tutte le visite e i calcoli dei percorsi
+ * accedono agli archi tramite un cursore comune, indipendente dalla rappresentazione.
+ *
+ * Le catene di nodi di passaggio (grado due, non terminali) possono essere contratte in
+ * archi scorciatoia usati solo dal calcolo dei cammini minimi; i percorsi restituiti
+ * vengono riespansi nodo per nodo, quindi la contrazione è trasparente ai chiamanti.
+ *
+ * Ogni arco può avere più pesi (metriche, ad esempio tempo, distanza, costo). I pesi
+ * sono memorizzati per colonne, una matrice (o un array compresso) per metrica sulla
+ * stessa topologia: una ricerca legge soltanto la colonna della metrica scelta.
+ *
+ * L'assegnazione del traffico (Frank-Wolfe su funzioni di ritardo BPR) distribuisce un
+ * insieme di viaggi sulla rete tenendo conto della congestione: a ogni iterazione i tempi
+ * degli archi vengono ricalcolati dal flusso assegnato e ogni origine calcola un albero
+ * dei cammini minimi verso tutte le sue destinazioni.
+ *
+ * Le ricerche accettano una maschera opzionale (nodi e archi chiusi, per id esterni)
+ * applicata dal cursore degli archi: il grafo non viene modificato, quindi più scenari
+ * di chiusura possono essere valutati contemporaneamente sullo stesso grafo.
+ *
+ * Un grafo può essere clonato in tempo proporzionale al numero di nodi: le righe delle
+ * matrici sono condivise con un contatore di riferimenti e copiate solo alla prima
+ * scrittura (copy-on-write), mentre la tabella dei nodi è condivisa tra tutti i cloni.
+ * Così una versione pubblicata resta immutabile mentre il clone viene modificato.
  */
 
 #include <stdlib.h>
@@ -12,13 +39,21 @@
 #include "list_stack.h"
 #include "list_queue.h"
 #include <limits.h>
+#include <float.h>
+#include <stdint.h>
 #include <string.h>
+#include <stddef.h>
+#include <stdatomic.h>
 
-#define MAX_SIZE 100
 #define INITIAL_CAPACITY 10
 #define GROWTH_FACTOR 2
 #define NO_EDGE 0
 #define INFINITY_DISTANCE INT_MAX
+#define NODE_PAGE_SIZE 64
+#define BPR_ALPHA 0.15          // Parametri della funzione di ritardo BPR: t0 * (1 + alpha * (flusso / capacità)^4)
+#define ASSIGNMENT_GAP 1e-4     // Gap relativo sotto il quale l'assegnazione si considera in equilibrio
+#define LINE_SEARCH_STEPS 30    // Passi di bisezione della ricerca lineare di Frank-Wolfe
+#define FRONTIER_ARITY 4        // Figli per nodo dello heap della frontiera di Dijkstra
 
 struct _weighted_direct_graph_node {
     int id;            
@@ -26,24 +61,162 @@ struct _weighted_direct_graph_node {
     void* data;        
 };
 
+/*
+ * I nodi sono identificati verso l'esterno dall'id assegnato alla creazione,
+ * mentre la matrice di adiacenza è indicizzata da un indice interno che può
+ * essere permutato da weighted_direct_graph_reorder per migliorare la località
+ * delle visite. Le strutture dei nodi sono allocate in pagine di dimensione fissa,
+ * così i puntatori Node restano validi anche dopo espansioni e riordini.
+ */
+/*
+ * Rappresentazione compressa di sola lettura: per ogni riga (indice interno) le
+ * destinazioni sono ordinate e codificate come varint; la prima è espressa come
+ * scostamento zigzag dall'indice della riga, le successive come distanza dalla
+ * precedente meno uno. Dopo un riordino RCM quasi tutte le differenze stanno in un byte.
+ * I pesi sono memorizzati a parte, nello stesso ordine, a 16 bit se tutti lo consentono.
+ */
+struct _compressed_adjacency {
+    uint32_t* row_offsets;  // Inizio di ogni riga nello stream (size + 1 elementi)
+    uint32_t* edge_offsets; // Indice del primo peso di ogni riga (size + 1 elementi)
+    uint8_t* stream;        // Destinazioni codificate
+    uint16_t* weights16[WDG_MAX_METRICS]; // Pesi a 16 bit per metrica (NULL se non rappresentabili)
+    int* weights32[WDG_MAX_METRICS];      // Pesi a 32 bit per metrica (NULL se si usano i pesi a 16 bit)
+};
+
+// Arco scorciatoia che sostituisce una catena contratta _src -> via... -> _dst (indici interni)
+struct _shortcut {
+    int src;
+    int dst;
+    int weight[WDG_MAX_METRICS];
+    int via_start;      // Posizione del primo nodo intermedio in via
+    int via_len;        // Numero di nodi intermedi
+    int next;           // Prossima scorciatoia uscente da src (-1 se ultima)
+};
+
+/*
+ * Stato della contrazione delle catene di grado due. Le scorciatoie sono tenute
+ * separate dalla matrice (o dalle liste compresse), così le visite che non le
+ * usano continuano a vedere il grafo originale.
+ */
+struct _contraction {
+    bool* contracted;   // contracted[i] se il nodo interno i è stato rimosso dalla ricerca
+    int* first;         // Prima scorciatoia uscente da ogni nodo (-1 se nessuna)
+    struct _shortcut* shortcuts;
+    int num_shortcuts;
+    int* via;           // Nodi intermedi di tutte le scorciatoie, in ordine di percorrenza
+    int num_via;
+    int num_contracted;
+};
+
+/*
+ * Maschera di chiusure: un bitset dei nodi chiusi, un bitset dei nodi con almeno un arco
+ * uscente chiuso (per scartare subito le righe senza chiusure) e l'elenco ordinato delle
+ * chiavi (sorgente << 32 | destinazione) degli archi chiusi, interrogato per ricerca binaria.
+ */
+struct _weighted_direct_graph_mask {
+    uint64_t* closed_nodes;
+    uint64_t* closed_sources;
+    int num_words;
+    uint64_t* closed_edges;
+    int num_edges;
+    int edge_capacity;
+};
+
+/*
+ * Riga di una matrice dei pesi. Le righe sono condivise tra un grafo e i suoi cloni:
+ * chi deve scrivere in una riga con più riferimenti ne crea prima una copia privata.
+ */
+struct _matrix_row {
+    atomic_int refs;
+    int weights[];
+};
+
+/*
+ * Tabella dei nodi condivisa tra un grafo e i suoi cloni. Possiede le pagine e i dati
+ * dei nodi, che vengono liberati quando l'ultimo grafo che la usa viene distrutto.
+ * Gli id sono assegnati in un'unica sequenza: solo il grafo che ha tanti nodi quanti
+ * la tabella (la versione più recente) può aggiungerne di nuovi.
+ */
+struct _node_table {
+    struct _weighted_direct_graph_node** pages;
+    int num_pages;
+    atomic_int num_nodes;   // Nodi inizializzati nelle pagine
+    atomic_int refs;        // Grafi che condividono la tabella
+};
+
 struct _weighted_direct_graph {
-    int** adj_matrix;   // Matrice di adiacenza dei pesi
-    struct _weighted_direct_graph_node* nodes;        // Array di nodi
+    int** weight_matrix[WDG_MAX_METRICS]; // Matrici dei pesi per metrica (indici interni); la 0 è la principale
+    int num_metrics;    // Numero di metriche definite (almeno 1)
+    struct _weighted_direct_graph_node** node_pages; // Pagine di nodi visibili da questo grafo (indirizzi stabili)
+    int num_pages;      // Numero di pagine visibili
+    struct _node_table* nodes; // Tabella dei nodi condivisa con i cloni
+    int node_base;      // I nodi da node_base in poi non sono ancora condivisi con un clone
+    int* to_internal;   // Id esterno -> indice interno
+    int* to_external;   // Indice interno -> id esterno
+    int* row_first;     // Prima colonna non nulla di ogni riga
+    int* row_last;      // Ultima colonna non nulla di ogni riga (-1 se riga vuota)
+    struct _compressed_adjacency* compressed; // Rappresentazione compressa (NULL se si usa la matrice)
+    struct _contraction* contraction;         // Catene contratte (NULL se il grafo non è contratto)
+    _Atomic(queue) work_list;                 // Coda delle visite riusata tra una ricerca e l'altra (NULL se in uso)
     int size;           // Numero di nodi presenti
     int capacity;       // Capacità massima attuale
 };
 
+// Funzione di utilità per accedere al nodo con id esterno _id
+static struct _weighted_direct_graph_node* node_at(weighted_direct_graph _graph, int _id) {
+    return &_graph->node_pages[_id / NODE_PAGE_SIZE][_id % NODE_PAGE_SIZE];
+}
+
+// Funzione di utilità per verificare la validità di un id esterno
+static bool valid_id(weighted_direct_graph _graph, int _id) {
+    return _id >= 0 && _id < _graph->size;
+}
+
+// Funzione di utilità per ricalcolare gli estremi non nulli di una riga
+static void update_row_bounds(weighted_direct_graph _graph, int _row) {
+    _graph->row_first[_row] = _graph->size;
+    _graph->row_last[_row] = -1;
+    for (int j = 0; j < _graph->size; j++) {
+        if (_graph->weight_matrix[0][_row][j] > 0) {
+            if (_graph->row_first[_row] > j) _graph->row_first[_row] = j;
+            _graph->row_last[_row] = j;
+        }
+    }
+}
+
+// Funzione di utilità per risalire all'intestazione di una riga dai suoi pesi
+static struct _matrix_row* row_header(int* _row) {
+    return (struct _matrix_row*)((char*)_row - offsetof(struct _matrix_row, weights));
+}
+
+// Funzione di utilità per allocare una riga di pesi azzerata con un solo riferimento
+static int* row_create(int _size) {
+    struct _matrix_row* row = (struct _matrix_row*)calloc(1, sizeof(struct _matrix_row) + _size * sizeof(int));
+    if (row == NULL) return NULL;
+    atomic_init(&row->refs, 1);
+    return row->weights;
+}
+
+// Funzione di utilità per rilasciare una riga, liberandola all'ultimo riferimento
+static void row_release(int* _row) {
+    if (_row == NULL) return;
+    struct _matrix_row* row = row_header(_row);
+    if (atomic_fetch_sub(&row->refs, 1) == 1) {
+        free(row);
+    }
+}
+
 // Funzione di utilità per inizializzare la matrice di adiacenza
 static int** create_matrix(int size) {
     int** matrix = (int**)malloc(size * sizeof(int*));
     if (matrix == NULL) return NULL;
 
     for (int i = 0; i < size; i++) {
-        matrix[i] = (int*)calloc(size, sizeof(int));
+        matrix[i] = row_create(size);
         if (matrix[i] == NULL) {
             // Pulizia in caso di errore
             for (int j = 0; j < i; j++) {
-                free(matrix[j]);
+                row_release(matrix[j]);
             }
             free(matrix);
             return NULL;
@@ -52,144 +225,707 @@ static int** create_matrix(int size) {
     return matrix;
 }
 
-// Funzione di utilità per espandere la matrice di adiacenza
+// Funzione di utilità per liberare la matrice di adiacenza
+static void free_matrix(int** _matrix, int _size) {
+    if (_matrix == NULL) return;
+    for (int i = 0; i < _size; i++) {
+        row_release(_matrix[i]);
+    }
+    free(_matrix);
+}
+
+// Funzione di utilità per condividere le righe di una matrice con un clone
+static int** share_matrix(int** _matrix, int _size) {
+    int** matrix = (int**)malloc(_size * sizeof(int*));
+    if (matrix == NULL) return NULL;
+
+    for (int i = 0; i < _size; i++) {
+        matrix[i] = _matrix[i];
+        atomic_fetch_add(&row_header(matrix[i])->refs, 1);
+    }
+    return matrix;
+}
+
+/*
+ * Funzione di utilità che rende private (copia alla scrittura) le righe _row di tutte
+ * le metriche prima di modificarle. In caso di errore nessun peso è stato cambiato.
+ */
+static int unshare_row(weighted_direct_graph _graph, int _row) {
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        int* row = _graph->weight_matrix[m][_row];
+        if (atomic_load(&row_header(row)->refs) == 1) continue;
+
+        int* copy = row_create(_graph->capacity);
+        if (copy == NULL) return WDG_ERROR_MEMORY;
+        memcpy(copy, row, _graph->capacity * sizeof(int));
+        _graph->weight_matrix[m][_row] = copy;
+        row_release(row);
+    }
+    return WDG_SUCCESS;
+}
+
+// Funzione di utilità per espandere le matrici dei pesi e le mappe degli indici
 static int expand_matrix(weighted_direct_graph _graph, int new_capacity) {
-    int** new_matrix = create_matrix(new_capacity);
-    if (new_matrix == NULL) return WDG_ERROR_MEMORY;
+    int** new_matrices[WDG_MAX_METRICS] = { NULL };
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        new_matrices[m] = create_matrix(new_capacity);
+        if (new_matrices[m] == NULL) {
+            for (int k = 0; k < m; k++) {
+                free_matrix(new_matrices[k], new_capacity);
+            }
+            return WDG_ERROR_MEMORY;
+        }
+    }
 
-    // Copia i valori dalla vecchia matrice
-    for (int i = 0; i < _graph->size; i++) {
-        for (int j = 0; j < _graph->size; j++) {
-            new_matrix[i][j] = _graph->adj_matrix[i][j];
+    int* maps[4] = { _graph->to_internal, _graph->to_external, _graph->row_first, _graph->row_last };
+    for (int k = 0; k < 4; k++) {
+        int* new_map = (int*)realloc(maps[k], new_capacity * sizeof(int));
+        if (new_map == NULL) {
+            for (int m = 0; m < _graph->num_metrics; m++) {
+                free_matrix(new_matrices[m], new_capacity);
+            }
+            return WDG_ERROR_MEMORY;
+        }
+        maps[k] = new_map;
+    }
+    _graph->to_internal = maps[0];
+    _graph->to_external = maps[1];
+    _graph->row_first = maps[2];
+    _graph->row_last = maps[3];
+
+    // Copia i valori dalle vecchie matrici e le libera
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        for (int i = 0; i < _graph->size; i++) {
+            for (int j = 0; j < _graph->size; j++) {
+                new_matrices[m][i][j] = _graph->weight_matrix[m][i][j];
+            }
         }
+        free_matrix(_graph->weight_matrix[m], _graph->capacity);
+        _graph->weight_matrix[m] = new_matrices[m];
     }
+    return WDG_SUCCESS;
+}
 
-    // Libera la vecchia matrice
-    for (int i = 0; i < _graph->capacity; i++) {
-        free(_graph->adj_matrix[i]);
+// Funzione di utilità per garantire una pagina di nodi per l'id esterno _id
+static int ensure_node_page(weighted_direct_graph _graph, int _id) {
+    int page = _id / NODE_PAGE_SIZE;
+    if (page < _graph->num_pages) return WDG_SUCCESS;
+
+    struct _weighted_direct_graph_node** new_pages = (struct _weighted_direct_graph_node**)realloc(_graph->node_pages, (page + 1) * sizeof(struct _weighted_direct_graph_node*));
+    if (new_pages == NULL) return WDG_ERROR_MEMORY;
+    _graph->node_pages = new_pages;
+
+    // La pagina può essere già stata allocata nella tabella condivisa da un nodo annullato
+    struct _node_table* table = _graph->nodes;
+    if (page >= table->num_pages) {
+        struct _weighted_direct_graph_node** table_pages = (struct _weighted_direct_graph_node**)realloc(table->pages, (page + 1) * sizeof(struct _weighted_direct_graph_node*));
+        if (table_pages == NULL) return WDG_ERROR_MEMORY;
+        table->pages = table_pages;
+
+        table_pages[page] = (struct _weighted_direct_graph_node*)malloc(NODE_PAGE_SIZE * sizeof(struct _weighted_direct_graph_node));
+        if (table_pages[page] == NULL) return WDG_ERROR_MEMORY;
+
+        for (int i = 0; i < NODE_PAGE_SIZE; i++) {
+            table_pages[page][i].id = -1;
+            table_pages[page][i].value = 0;
+            table_pages[page][i].data = NULL;
+        }
+        table->num_pages = page + 1;
     }
-    free(_graph->adj_matrix);
 
-    _graph->adj_matrix = new_matrix;
+    new_pages[page] = table->pages[page];
+    _graph->num_pages = page + 1;
     return WDG_SUCCESS;
 }
 
-weighted_direct_graph weighted_direct_graph_create() {
-    weighted_direct_graph graph = (weighted_direct_graph)malloc(sizeof(struct _weighted_direct_graph));
-    if (graph == NULL) return NULL;
+// Funzione di utilità per rilasciare la tabella dei nodi, liberandola all'ultimo riferimento
+static void release_node_table(struct _node_table* _table) {
+    if (_table == NULL || atomic_fetch_sub(&_table->refs, 1) != 1) return;
+
+    int num_nodes = atomic_load(&_table->num_nodes);
+    for (int i = 0; i < num_nodes; i++) {
+        struct _weighted_direct_graph_node* node = &_table->pages[i / NODE_PAGE_SIZE][i % NODE_PAGE_SIZE];
+        if (node->data != NULL) {
+            free(node->data);
+        }
+    }
+    for (int p = 0; p < _table->num_pages; p++) {
+        free(_table->pages[p]);
+    }
+    free(_table->pages);
+    free(_table);
+}
+
+// Funzione di utilità che restituisce una copia di _bytes byte di _source (NULL in caso di errore)
+static void* copy_array(const void* _source, size_t _bytes) {
+    void* copy = malloc(_bytes > 0 ? _bytes : 1);
+    if (copy != NULL && _bytes > 0) {
+        memcpy(copy, _source, _bytes);
+    }
+    return copy;
+}
+
+// Funzione di utilità per scrivere un varint (7 bit per byte); restituisce i byte scritti
+static int varint_encode(uint32_t _value, uint8_t* _out) {
+    int n = 0;
+    while (_value >= 0x80) {
+        if (_out != NULL) _out[n] = (uint8_t)(_value | 0x80);
+        _value >>= 7;
+        n++;
+    }
+    if (_out != NULL) _out[n] = (uint8_t)_value;
+    return n + 1;
+}
+
+// Funzione di utilità per leggere un varint, avanzando il puntatore
+static uint32_t varint_decode(const uint8_t** _p) {
+    const uint8_t* p = *_p;
+    uint32_t value = *p++;
+    if (value >= 0x80) {
+        // Percorso lento: differenze su più byte
+        value &= 0x7F;
+        int shift = 7;
+        uint8_t byte;
+        do {
+            byte = *p++;
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+    }
+    *_p = p;
+    return value;
+}
+
+static uint32_t zigzag_encode(int _value) {
+    return ((uint32_t)_value << 1) ^ (uint32_t)(_value >> 31);
+}
+
+static int zigzag_decode(uint32_t _value) {
+    return (int)(_value >> 1) ^ -(int)(_value & 1);
+}
+
+static bool bit_test(const uint64_t* _bits, int _num_words, int _index) {
+    int word = _index / 64;
+    return word < _num_words && (_bits[word] >> (_index % 64)) & 1;
+}
+
+static uint64_t edge_key(int _src, int _dst) {
+    return ((uint64_t)(uint32_t)_src << 32) | (uint32_t)_dst;
+}
+
+// Funzione di utilità che restituisce la posizione della prima chiave >= _key
+static int mask_lower_bound(const struct _weighted_direct_graph_mask* _mask, uint64_t _key) {
+    int low = 0, high = _mask->num_edges;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (_mask->closed_edges[mid] < _key) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+static bool mask_node_closed(const struct _weighted_direct_graph_mask* _mask, int _node) {
+    return bit_test(_mask->closed_nodes, _mask->num_words, _node);
+}
+
+static bool mask_edge_closed(const struct _weighted_direct_graph_mask* _mask, int _src, int _dst) {
+    uint64_t key = edge_key(_src, _dst);
+    int pos = mask_lower_bound(_mask, key);
+    return pos < _mask->num_edges && _mask->closed_edges[pos] == key;
+}
+
+/*
+ * Cursore sugli archi uscenti di un nodo (indici interni), valido per entrambe
+ * le rappresentazioni. Tutte le visite e i calcoli dei percorsi scorrono gli archi
+ * esclusivamente tramite edge_cursor_open/edge_cursor_next. Aperto con
+ * edge_cursor_open_contracted salta i nodi contratti e restituisce in coda le scorciatoie;
+ * con edge_cursor_set_mask salta i nodi e gli archi chiusi dalla maschera.
+ */
+typedef struct {
+    const struct _compressed_adjacency* compressed;
+    const int* row;         // Riga della matrice (rappresentazione a matrice)
+    int next;               // Prossima colonna da esaminare
+    int last;               // Ultima colonna non nulla
+    const uint8_t* p;       // Posizione nello stream (rappresentazione compressa)
+    const uint8_t* end;     // Fine della riga nello stream
+    int target;             // Ultima destinazione decodificata
+    uint32_t edge;          // Indice del prossimo peso
+    int metric;             // Metrica dei pesi restituiti
+    const struct _weighted_direct_graph_mask* mask; // Chiusure da rispettare (NULL se nessuna)
+    const int* to_external; // Mappa indice interno -> id esterno (per la maschera)
+    int source;             // Id esterno del nodo di partenza degli archi
+    bool source_closed_edges; // Il nodo di partenza ha archi chiusi nella maschera
+    const struct _contraction* contraction; // Stato della contrazione (NULL per il grafo originale)
+    int shortcut;           // Prossima scorciatoia da restituire (-1 se finite)
+} edge_cursor;
+
+static void edge_cursor_open_metric(weighted_direct_graph _graph, int _node, int _metric, edge_cursor* _cursor) {
+    _cursor->compressed = _graph->compressed;
+    _cursor->metric = _metric;
+    _cursor->mask = NULL;
+    _cursor->contraction = NULL;
+    _cursor->shortcut = -1;
+    if (_graph->compressed == NULL) {
+        // Per l'invariante sui pesi, la riga della metrica descrive anche la topologia
+        _cursor->row = _graph->weight_matrix[_metric][_node];
+        _cursor->next = _graph->row_first[_node];
+        _cursor->last = _graph->row_last[_node];
+    } else {
+        const struct _compressed_adjacency* c = _graph->compressed;
+        _cursor->p = c->stream + c->row_offsets[_node];
+        _cursor->end = c->stream + c->row_offsets[_node + 1];
+        _cursor->target = -1;
+        _cursor->edge = c->edge_offsets[_node];
+        _cursor->next = _node;
+    }
+}
+
+static void edge_cursor_open(weighted_direct_graph _graph, int _node, edge_cursor* _cursor) {
+    edge_cursor_open_metric(_graph, _node, 0, _cursor);
+}
+
+static void edge_cursor_set_mask(weighted_direct_graph _graph, int _node, const struct _weighted_direct_graph_mask* _mask, edge_cursor* _cursor) {
+    if (_mask == NULL) return;
+    _cursor->mask = _mask;
+    _cursor->to_external = _graph->to_external;
+    _cursor->source = _graph->to_external[_node];
+    _cursor->source_closed_edges = bit_test(_mask->closed_sources, _mask->num_words, _cursor->source);
+}
+
+static void edge_cursor_open_contracted(weighted_direct_graph _graph, int _node, int _metric, edge_cursor* _cursor) {
+    edge_cursor_open_metric(_graph, _node, _metric, _cursor);
+    _cursor->contraction = _graph->contraction;
+    _cursor->shortcut = _graph->contraction->first[_node];
+}
+
+static bool edge_cursor_next_raw(edge_cursor* _cursor, int* _target_out, int* _weight_out) {
+    if (_cursor->compressed == NULL) {
+        while (_cursor->next <= _cursor->last) {
+            int column = _cursor->next++;
+            if (_cursor->row[column] > 0) {
+                *_target_out = column;
+                *_weight_out = _cursor->row[column];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (_cursor->p >= _cursor->end) return false;
+
+    uint32_t code = varint_decode(&_cursor->p);
+    if (_cursor->target < 0) {
+        _cursor->target = _cursor->next + zigzag_decode(code);
+    } else {
+        _cursor->target += (int)code + 1;
+    }
+
+    const struct _compressed_adjacency* c = _cursor->compressed;
+    *_target_out = _cursor->target;
+    int m = _cursor->metric;
+    *_weight_out = (c->weights16[m] != NULL) ? c->weights16[m][_cursor->edge] : c->weights32[m][_cursor->edge];
+    _cursor->edge++;
+    return true;
+}
+
+static bool edge_cursor_next(edge_cursor* _cursor, int* _target_out, int* _weight_out) {
+    const struct _contraction* contraction = _cursor->contraction;
+    const struct _weighted_direct_graph_mask* mask = _cursor->mask;
+    while (edge_cursor_next_raw(_cursor, _target_out, _weight_out)) {
+        if (contraction != NULL && contraction->contracted[*_target_out]) continue;
+        if (mask != NULL) {
+            int target = _cursor->to_external[*_target_out];
+            if (mask_node_closed(mask, target)) continue;
+            if (_cursor->source_closed_edges && mask_edge_closed(mask, _cursor->source, target)) continue;
+        }
+        return true;
+    }
+    if (contraction == NULL || _cursor->shortcut < 0) return false;
 
-    graph->adj_matrix = create_matrix(INITIAL_CAPACITY);
-    if (graph->adj_matrix == NULL) {
-        free(graph);
+    const struct _shortcut* shortcut = &contraction->shortcuts[_cursor->shortcut];
+    *_target_out = shortcut->dst;
+    *_weight_out = shortcut->weight[_cursor->metric];
+    _cursor->shortcut = shortcut->next;
+    return true;
+}
+
+// Funzione di utilità per leggere il peso dell'arco _src -> _dst (indici interni) nella metrica _metric, 0 se assente
+static int edge_weight_metric(weighted_direct_graph _graph, int _src, int _dst, int _metric) {
+    if (_graph->compressed == NULL) return _graph->weight_matrix[_metric][_src][_dst];
+
+    edge_cursor cursor;
+    int target, weight;
+    edge_cursor_open_metric(_graph, _src, _metric, &cursor);
+    while (edge_cursor_next(&cursor, &target, &weight)) {
+        if (target == _dst) return weight;
+        if (target > _dst) break;
+    }
+    return NO_EDGE;
+}
+
+static int edge_weight(weighted_direct_graph _graph, int _src, int _dst) {
+    return edge_weight_metric(_graph, _src, _dst, 0);
+}
+
+static void free_compressed(struct _compressed_adjacency* _compressed) {
+    if (_compressed == NULL) return;
+    free(_compressed->row_offsets);
+    free(_compressed->edge_offsets);
+    free(_compressed->stream);
+    for (int m = 0; m < WDG_MAX_METRICS; m++) {
+        free(_compressed->weights16[m]);
+        free(_compressed->weights32[m]);
+    }
+    free(_compressed);
+}
+
+static void free_contraction(struct _contraction* _contraction) {
+    if (_contraction == NULL) return;
+    free(_contraction->contracted);
+    free(_contraction->first);
+    free(_contraction->shortcuts);
+    free(_contraction->via);
+    free(_contraction);
+}
+
+// Funzione di utilità per annullare la contrazione prima di una modifica del grafo
+static void drop_contraction(weighted_direct_graph _graph) {
+    free_contraction(_graph->contraction);
+    _graph->contraction = NULL;
+}
+
+// Funzione di utilità per costruire la rappresentazione compressa dalla matrice
+static struct _compressed_adjacency* build_compressed(weighted_direct_graph _graph) {
+    int n = _graph->size;
+    struct _compressed_adjacency* c = (struct _compressed_adjacency*)calloc(1, sizeof(struct _compressed_adjacency));
+    if (c == NULL) return NULL;
+
+    c->row_offsets = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    c->edge_offsets = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    if (c->row_offsets == NULL || c->edge_offsets == NULL) {
+        free_compressed(c);
         return NULL;
     }
 
-    graph->nodes = (struct _weighted_direct_graph_node*)malloc(INITIAL_CAPACITY * sizeof(struct _weighted_direct_graph_node));
-    if (graph->nodes == NULL) {
-        for (int i = 0; i < INITIAL_CAPACITY; i++) {
-            free(graph->adj_matrix[i]);
+    // Primo passaggio: dimensione dello stream, numero di archi e ampiezza dei pesi
+    uint32_t bytes = 0, edges = 0;
+    bool fits16[WDG_MAX_METRICS];
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        fits16[m] = true;
+    }
+    for (int i = 0; i < n; i++) {
+        c->row_offsets[i] = bytes;
+        c->edge_offsets[i] = edges;
+        int prev = -1;
+        for (int j = _graph->row_first[i]; j <= _graph->row_last[i]; j++) {
+            if (_graph->weight_matrix[0][i][j] <= 0) continue;
+            bytes += varint_encode(prev < 0 ? zigzag_encode(j - i) : (uint32_t)(j - prev - 1), NULL);
+            for (int m = 0; m < _graph->num_metrics; m++) {
+                if (_graph->weight_matrix[m][i][j] > UINT16_MAX) fits16[m] = false;
+            }
+            prev = j;
+            edges++;
         }
-        free(graph->adj_matrix);
-        free(graph);
+    }
+    c->row_offsets[n] = bytes;
+    c->edge_offsets[n] = edges;
+
+    c->stream = (uint8_t*)malloc(bytes > 0 ? bytes : 1);
+    if (c->stream == NULL) {
+        free_compressed(c);
         return NULL;
     }
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        if (fits16[m]) {
+            c->weights16[m] = (uint16_t*)malloc((edges > 0 ? edges : 1) * sizeof(uint16_t));
+        } else {
+            c->weights32[m] = (int*)malloc((edges > 0 ? edges : 1) * sizeof(int));
+        }
+        if (c->weights16[m] == NULL && c->weights32[m] == NULL) {
+            free_compressed(c);
+            return NULL;
+        }
+    }
 
-    for (int i = 0; i < INITIAL_CAPACITY; i++) {
-        graph->nodes[i].id = -1;
-        graph->nodes[i].value = 0;
-        graph->nodes[i].data = NULL;
+    // Secondo passaggio: codifica delle destinazioni e copia dei pesi
+    uint8_t* out = c->stream;
+    uint32_t edge = 0;
+    for (int i = 0; i < n; i++) {
+        int prev = -1;
+        for (int j = _graph->row_first[i]; j <= _graph->row_last[i]; j++) {
+            if (_graph->weight_matrix[0][i][j] <= 0) continue;
+            out += varint_encode(prev < 0 ? zigzag_encode(j - i) : (uint32_t)(j - prev - 1), out);
+            for (int m = 0; m < _graph->num_metrics; m++) {
+                int w = _graph->weight_matrix[m][i][j];
+                if (fits16[m]) c->weights16[m][edge] = (uint16_t)w;
+                else c->weights32[m][edge] = w;
+            }
+            prev = j;
+            edge++;
+        }
     }
 
+    return c;
+}
+
+weighted_direct_graph weighted_direct_graph_create() {
+    weighted_direct_graph graph = (weighted_direct_graph)malloc(sizeof(struct _weighted_direct_graph));
+    if (graph == NULL) return NULL;
+
+    for (int m = 0; m < WDG_MAX_METRICS; m++) {
+        graph->weight_matrix[m] = NULL;
+    }
+    graph->weight_matrix[0] = create_matrix(INITIAL_CAPACITY);
+    graph->num_metrics = 1;
+    graph->node_pages = NULL;
+    graph->num_pages = 0;
+    graph->nodes = (struct _node_table*)calloc(1, sizeof(struct _node_table));
+    if (graph->nodes != NULL) {
+        atomic_init(&graph->nodes->num_nodes, 0);
+        atomic_init(&graph->nodes->refs, 1);
+    }
+    graph->node_base = 0;
+    graph->to_internal = (int*)malloc(INITIAL_CAPACITY * sizeof(int));
+    graph->to_external = (int*)malloc(INITIAL_CAPACITY * sizeof(int));
+    graph->row_first = (int*)malloc(INITIAL_CAPACITY * sizeof(int));
+    graph->row_last = (int*)malloc(INITIAL_CAPACITY * sizeof(int));
+    graph->compressed = NULL;
+    graph->contraction = NULL;
+    atomic_init(&graph->work_list, NULL);
     graph->size = 0;
     graph->capacity = INITIAL_CAPACITY;
+
+    if (graph->weight_matrix[0] == NULL || graph->nodes == NULL || graph->to_internal == NULL || graph->to_external == NULL ||
+        graph->row_first == NULL || graph->row_last == NULL) {
+        weighted_direct_graph_destroy(&graph);
+        return NULL;
+    }
+
     return graph;
 }
 
 void weighted_direct_graph_destroy(weighted_direct_graph* _graph) {
     if (_graph == NULL || *_graph == NULL) return;
 
-    // Libera i nodi
-    for (int i = 0; i < (*_graph)->size; i++) {
-        if ((*_graph)->nodes[i].data != NULL) {
-            free((*_graph)->nodes[i].data);
+    // I nodi aggiunti dopo l'ultimo clone appartengono solo a questo grafo: vengono
+    // restituiti alla tabella, così la versione precedente può tornare ad aggiungerne
+    struct _node_table* table = (*_graph)->nodes;
+    if (table != NULL && (*_graph)->size > (*_graph)->node_base && atomic_load(&table->num_nodes) == (*_graph)->size) {
+        for (int i = (*_graph)->node_base; i < (*_graph)->size; i++) {
+            struct _weighted_direct_graph_node* node = node_at(*_graph, i);
+            free(node->data);
+            node->id = -1;
+            node->value = 0;
+            node->data = NULL;
         }
+        atomic_store(&table->num_nodes, (*_graph)->node_base);
     }
-    free((*_graph)->nodes);
+    release_node_table(table);
+    free((*_graph)->node_pages);
 
-    // Libera la matrice di adiacenza
-    for (int i = 0; i < (*_graph)->capacity; i++) {
-        free((*_graph)->adj_matrix[i]);
+    // Libera la matrice di adiacenza e le mappe degli indici
+    for (int m = 0; m < (*_graph)->num_metrics; m++) {
+        free_matrix((*_graph)->weight_matrix[m], (*_graph)->capacity);
     }
-    free((*_graph)->adj_matrix);
+    free((*_graph)->to_internal);
+    free((*_graph)->to_external);
+    free((*_graph)->row_first);
+    free((*_graph)->row_last);
+    free_compressed((*_graph)->compressed);
+    free_contraction((*_graph)->contraction);
+    queue work_list = atomic_load(&(*_graph)->work_list);
+    queue_destroy(&work_list);
 
     free(*_graph);
     *_graph = NULL;
 }
 
+// Funzione di utilità per copiare la rappresentazione compressa (sola lettura, quindi condivisibile solo per copia)
+static struct _compressed_adjacency* copy_compressed(const struct _compressed_adjacency* _compressed, int _size) {
+    struct _compressed_adjacency* c = (struct _compressed_adjacency*)calloc(1, sizeof(struct _compressed_adjacency));
+    if (c == NULL) return NULL;
+
+    uint32_t edges = _compressed->edge_offsets[_size];
+    c->row_offsets = (uint32_t*)copy_array(_compressed->row_offsets, (_size + 1) * sizeof(uint32_t));
+    c->edge_offsets = (uint32_t*)copy_array(_compressed->edge_offsets, (_size + 1) * sizeof(uint32_t));
+    c->stream = (uint8_t*)copy_array(_compressed->stream, _compressed->row_offsets[_size]);
+    bool ok = c->row_offsets != NULL && c->edge_offsets != NULL && c->stream != NULL;
+    for (int m = 0; m < WDG_MAX_METRICS && ok; m++) {
+        if (_compressed->weights16[m] != NULL) {
+            c->weights16[m] = (uint16_t*)copy_array(_compressed->weights16[m], edges * sizeof(uint16_t));
+            ok = c->weights16[m] != NULL;
+        } else if (_compressed->weights32[m] != NULL) {
+            c->weights32[m] = (int*)copy_array(_compressed->weights32[m], edges * sizeof(int));
+            ok = c->weights32[m] != NULL;
+        }
+    }
+    if (!ok) {
+        free_compressed(c);
+        return NULL;
+    }
+    return c;
+}
+
+// Funzione di utilità per copiare la contrazione delle catene
+static struct _contraction* copy_contraction(const struct _contraction* _contraction, int _size) {
+    struct _contraction* c = (struct _contraction*)calloc(1, sizeof(struct _contraction));
+    if (c == NULL) return NULL;
+
+    c->contracted = (bool*)copy_array(_contraction->contracted, (_size + 1) * sizeof(bool));
+    c->first = (int*)copy_array(_contraction->first, (_size + 1) * sizeof(int));
+    c->shortcuts = (struct _shortcut*)copy_array(_contraction->shortcuts, _contraction->num_shortcuts * sizeof(struct _shortcut));
+    c->via = (int*)copy_array(_contraction->via, _contraction->num_via * sizeof(int));
+    c->num_shortcuts = _contraction->num_shortcuts;
+    c->num_via = _contraction->num_via;
+    c->num_contracted = _contraction->num_contracted;
+    if (c->contracted == NULL || c->first == NULL || c->shortcuts == NULL || c->via == NULL) {
+        free_contraction(c);
+        return NULL;
+    }
+    return c;
+}
+
+weighted_direct_graph weighted_direct_graph_clone(weighted_direct_graph _graph) {
+    if (_graph == NULL) return NULL;
+
+    weighted_direct_graph clone = (weighted_direct_graph)calloc(1, sizeof(struct _weighted_direct_graph));
+    if (clone == NULL) return NULL;
+
+    clone->num_metrics = _graph->num_metrics;
+    atomic_init(&clone->work_list, NULL);
+    clone->size = _graph->size;
+    clone->capacity = _graph->capacity;
+
+    // Tabella dei nodi condivisa: da qui in avanti i nodi esistenti appartengono a entrambi
+    clone->nodes = _graph->nodes;
+    atomic_fetch_add(&clone->nodes->refs, 1);
+    clone->node_base = _graph->size;
+    _graph->node_base = _graph->size;
+
+    clone->node_pages = (struct _weighted_direct_graph_node**)copy_array(_graph->node_pages, _graph->num_pages * sizeof(struct _weighted_direct_graph_node*));
+    clone->num_pages = _graph->num_pages;
+    clone->to_internal = (int*)copy_array(_graph->to_internal, _graph->capacity * sizeof(int));
+    clone->to_external = (int*)copy_array(_graph->to_external, _graph->capacity * sizeof(int));
+    clone->row_first = (int*)copy_array(_graph->row_first, _graph->capacity * sizeof(int));
+    clone->row_last = (int*)copy_array(_graph->row_last, _graph->capacity * sizeof(int));
+    bool ok = clone->node_pages != NULL && clone->to_internal != NULL && clone->to_external != NULL &&
+              clone->row_first != NULL && clone->row_last != NULL;
+
+    for (int m = 0; m < _graph->num_metrics && ok; m++) {
+        if (_graph->weight_matrix[m] == NULL) continue;
+        clone->weight_matrix[m] = share_matrix(_graph->weight_matrix[m], _graph->capacity);
+        ok = clone->weight_matrix[m] != NULL;
+    }
+    if (ok && _graph->compressed != NULL) {
+        clone->compressed = copy_compressed(_graph->compressed, _graph->size);
+        ok = clone->compressed != NULL;
+    }
+    if (ok && _graph->contraction != NULL) {
+        clone->contraction = copy_contraction(_graph->contraction, _graph->size);
+        ok = clone->contraction != NULL;
+    }
+
+    if (!ok) {
+        weighted_direct_graph_destroy(&clone);
+        return NULL;
+    }
+    return clone;
+}
+
+// Funzione di utilità per garantire spazio per almeno _required nodi con una sola espansione
+static int reserve_nodes(weighted_direct_graph _graph, int _required) {
+    if (_required <= _graph->capacity) return WDG_SUCCESS;
+
+    int new_capacity = _graph->capacity;
+    while (new_capacity < _required) {
+        new_capacity *= GROWTH_FACTOR;
+    }
+
+    // Espandi la matrice di adiacenza
+    if (expand_matrix(_graph, new_capacity) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+    _graph->capacity = new_capacity;
+    return WDG_SUCCESS;
+}
+
+// Funzione di utilità che indica se il grafo può assegnare nuovi id nella tabella condivisa
+static bool owns_next_id(weighted_direct_graph _graph) {
+    return atomic_load(&_graph->nodes->num_nodes) == _graph->size;
+}
+
+// Funzione di utilità per inizializzare il nodo successivo (l'indice interno coincide con l'id esterno)
+static weighted_direct_graph_node_id append_node(weighted_direct_graph _graph, int _value, void* _data) {
+    if (ensure_node_page(_graph, _graph->size) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+
+    struct _weighted_direct_graph_node* new_node = node_at(_graph, _graph->size);
+    new_node->id = _graph->size;
+    new_node->value = _value;
+    new_node->data = _data;
+
+    _graph->to_internal[_graph->size] = _graph->size;
+    _graph->to_external[_graph->size] = _graph->size;
+    _graph->row_first[_graph->size] = _graph->capacity;
+    _graph->row_last[_graph->size] = -1;
+    atomic_store(&_graph->nodes->num_nodes, _graph->size + 1);
+    return _graph->size++;
+}
+
 weighted_direct_graph_node_id weighted_direct_graph_add_node(weighted_direct_graph _graph, int _value, void* _data) {
     if (_graph == NULL) return WDG_ERROR_NULL;
+    if (_graph->compressed != NULL || !owns_next_id(_graph)) return WDG_ERROR_READ_ONLY;
+    drop_contraction(_graph);
 
     // Se necessario, espandi la capacità
-    if (_graph->size >= _graph->capacity) {
-        int new_capacity = _graph->capacity * GROWTH_FACTOR;
-        
-        // Espandi la matrice di adiacenza
-        int result = expand_matrix(_graph, new_capacity);
-        if (result != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+    if (reserve_nodes(_graph, _graph->size + 1) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
 
-        // Espandi l'array dei nodi
-        struct _weighted_direct_graph_node* new_nodes = (struct _weighted_direct_graph_node*)realloc(_graph->nodes, new_capacity * sizeof(struct _weighted_direct_graph_node));
-        if (new_nodes == NULL) return WDG_ERROR_MEMORY;
+    return append_node(_graph, _value, _data);
+}
 
-        _graph->nodes = new_nodes;
-        for (int i = _graph->capacity; i < new_capacity; i++) {
-            _graph->nodes[i].id = -1;
-            _graph->nodes[i].value = 0;
-            _graph->nodes[i].data = NULL;
-        }
+weighted_direct_graph_node_id weighted_direct_graph_add_nodes(weighted_direct_graph _graph, int _count) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    if (_count <= 0) return WDG_ERROR_INVALID_ID;
+    if (_graph->compressed != NULL || !owns_next_id(_graph)) return WDG_ERROR_READ_ONLY;
+    drop_contraction(_graph);
 
-        _graph->capacity = new_capacity;
-    }
+    if (reserve_nodes(_graph, _graph->size + _count) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
 
-    // Crea il nuovo nodo
-    struct _weighted_direct_graph_node new_node;
-    new_node.id = _graph->size;
-    new_node.value = _value;
-    new_node.data = _data;
-    
-    _graph->nodes[_graph->size] = new_node;
-    return _graph->size++;
+    weighted_direct_graph_node_id first = _graph->size;
+    for (int i = 0; i < _count; i++) {
+        if (append_node(_graph, 0, NULL) < 0) return WDG_ERROR_MEMORY;
+    }
+    return first;
 }
 
 int weighted_direct_graph_get_value(weighted_direct_graph _graph, weighted_direct_graph_node_id _node, int* _value_out) {
     if (_graph == NULL || _value_out == NULL) return WDG_ERROR_NULL;
-    if (_node < 0 || _node >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _node)) return WDG_ERROR_INVALID_ID;
 
-    *_value_out = _graph->nodes[_node].value;
+    *_value_out = node_at(_graph, _node)->value;
     return WDG_SUCCESS;
 }
 
 void* weighted_direct_graph_get_node_data(weighted_direct_graph _graph, weighted_direct_graph_node_id _node) {
-    if (_graph == NULL || _node < 0 || _node >= _graph->size) return NULL;
-    return _graph->nodes[_node].data;
+    if (_graph == NULL || !valid_id(_graph, _node)) return NULL;
+    return node_at(_graph, _node)->data;
 }
 
 int weighted_direct_graph_set_node_data(weighted_direct_graph _graph, weighted_direct_graph_node_id _node, void* _data, void (*_free_data)(void*)) {
     if (_graph == NULL) return WDG_ERROR_NULL;
-    if (_node < 0 || _node >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _node)) return WDG_ERROR_INVALID_ID;
+
+    struct _weighted_direct_graph_node* node = node_at(_graph, _node);
 
     // Libera i dati precedenti se necessario
-    if (_free_data != NULL && _graph->nodes[_node].data != NULL) {
-        _free_data(_graph->nodes[_node].data);
+    if (_free_data != NULL && node->data != NULL) {
+        _free_data(node->data);
     }
 
-    _graph->nodes[_node].data = _data;
+    node->data = _data;
     return WDG_SUCCESS;
 }
 
 struct _weighted_direct_graph_node* weighted_direct_graph_get_node(weighted_direct_graph _graph, weighted_direct_graph_node_id _node) {
-    if (_graph == NULL || _node < 0 || _node >= _graph->size) return NULL;
-    return &_graph->nodes[_node];
+    if (_graph == NULL || !valid_id(_graph, _node)) return NULL;
+    return node_at(_graph, _node);
 }
 
 weighted_direct_graph_node_id weighted_direct_graph_get_node_id(struct _weighted_direct_graph_node* _node) {
@@ -199,29 +935,97 @@ weighted_direct_graph_node_id weighted_direct_graph_get_node_id(struct _weighted
 
 int weighted_direct_graph_add_edge(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _weight) {
     if (_graph == NULL) return WDG_ERROR_NULL;
-    if (_src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
     if (_weight <= 0) return WDG_ERROR_INVALID_ID; // Il peso deve essere positivo
+    if (_graph->compressed != NULL) return WDG_ERROR_READ_ONLY;
 
-    _graph->adj_matrix[_src][_dst] = _weight;
+    int src = _graph->to_internal[_src];
+    int dst = _graph->to_internal[_dst];
+    if (unshare_row(_graph, src) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+    drop_contraction(_graph);
+
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        _graph->weight_matrix[m][src][dst] = _weight;
+    }
+    if (dst < _graph->row_first[src]) _graph->row_first[src] = dst;
+    if (dst > _graph->row_last[src]) _graph->row_last[src] = dst;
     return WDG_SUCCESS;
 }
 
 int weighted_direct_graph_get_edge_weight(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int* _weight_out) {
     if (_graph == NULL || _weight_out == NULL) return WDG_ERROR_NULL;
-    if (_src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
 
-    *_weight_out = _graph->adj_matrix[_src][_dst];
+    *_weight_out = edge_weight(_graph, _graph->to_internal[_src], _graph->to_internal[_dst]);
     return (*_weight_out > 0) ? 1 : 0;
 }
 
 int weighted_direct_graph_remove_edge(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
     if (_graph == NULL) return WDG_ERROR_NULL;
-    if (_src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
+    if (_graph->compressed != NULL) return WDG_ERROR_READ_ONLY;
+
+    int src = _graph->to_internal[_src];
+    int dst = _graph->to_internal[_dst];
+    if (unshare_row(_graph, src) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+    drop_contraction(_graph);
+
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        _graph->weight_matrix[m][src][dst] = NO_EDGE;
+    }
+    if (dst == _graph->row_first[src] || dst == _graph->row_last[src]) {
+        update_row_bounds(_graph, src);
+    }
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_add_metric(weighted_direct_graph _graph) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    if (_graph->compressed != NULL) return WDG_ERROR_READ_ONLY;
+    if (_graph->num_metrics >= WDG_MAX_METRICS) return WDG_ERROR_MEMORY;
+
+    // La nuova metrica parte come copia della principale, così l'invariante sui pesi vale subito
+    int** matrix = create_matrix(_graph->capacity);
+    if (matrix == NULL) return WDG_ERROR_MEMORY;
+    for (int i = 0; i < _graph->size; i++) {
+        memcpy(matrix[i], _graph->weight_matrix[0][i], _graph->size * sizeof(int));
+    }
+
+    drop_contraction(_graph);
+    _graph->weight_matrix[_graph->num_metrics] = matrix;
+    return _graph->num_metrics++;
+}
+
+int weighted_direct_graph_num_metrics(weighted_direct_graph _graph) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    return _graph->num_metrics;
+}
+
+int weighted_direct_graph_set_edge_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, int _weight) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
+    if (_metric < 0 || _metric >= _graph->num_metrics || _weight <= 0) return WDG_ERROR_INVALID_ID;
+    if (_graph->compressed != NULL) return WDG_ERROR_READ_ONLY;
 
-    _graph->adj_matrix[_src][_dst] = NO_EDGE;
+    int src = _graph->to_internal[_src];
+    int dst = _graph->to_internal[_dst];
+    if (_graph->weight_matrix[0][src][dst] <= 0) return WDG_ERROR_INVALID_ID; // Arco non esistente
+    if (unshare_row(_graph, src) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+
+    drop_contraction(_graph);
+    _graph->weight_matrix[_metric][src][dst] = _weight;
     return WDG_SUCCESS;
 }
 
+int weighted_direct_graph_get_edge_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, int* _weight_out) {
+    if (_graph == NULL || _weight_out == NULL) return WDG_ERROR_NULL;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
+    if (_metric < 0 || _metric >= _graph->num_metrics) return WDG_ERROR_INVALID_ID;
+
+    *_weight_out = edge_weight_metric(_graph, _graph->to_internal[_src], _graph->to_internal[_dst], _metric);
+    return (*_weight_out > 0) ? 1 : 0;
+}
+
 int weighted_direct_graph_size(weighted_direct_graph _graph) {
     if (_graph == NULL) return WDG_ERROR_NULL;
     return _graph->size;
@@ -229,40 +1033,49 @@ int weighted_direct_graph_size(weighted_direct_graph _graph) {
 
 int weighted_direct_graph_adjacent(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
     if (_graph == NULL) return WDG_ERROR_NULL;
-    if (_src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
 
-    return (_graph->adj_matrix[_src][_dst] > 0) ? 1 : 0;
+    return (edge_weight(_graph, _graph->to_internal[_src], _graph->to_internal[_dst]) > 0) ? 1 : 0;
 }
 
 linked_list weighted_direct_graph_neighbors(weighted_direct_graph _graph, weighted_direct_graph_node_id _node) {
-    if (_graph == NULL || _node < 0 || _node >= _graph->size) return NULL;
+    if (_graph == NULL || !valid_id(_graph, _node)) return NULL;
 
     linked_list neighbors = linked_list_create();
     if (neighbors == NULL) return NULL;
 
-    for (int i = 0; i < _graph->size; i++) {
-        if (_graph->adj_matrix[_node][i] > 0) {
-            linked_list_append(neighbors, i);
-        }
+    edge_cursor cursor;
+    int target, weight;
+    edge_cursor_open(_graph, _graph->to_internal[_node], &cursor);
+    while (edge_cursor_next(&cursor, &target, &weight)) {
+        linked_list_append(neighbors, _graph->to_external[target]);
     }
 
     return neighbors;
 }
 
-// Funzione di utilità per la visita DFS ricorsiva
-static void dfs_recursive(weighted_direct_graph _graph, weighted_direct_graph_node_id _node, bool* _visited, linked_list _result) {
+// Funzione di utilità per la visita DFS ricorsiva (indici interni)
+static void dfs_recursive(weighted_direct_graph _graph, int _node, bool* _visited, linked_list _result, const struct _weighted_direct_graph_mask* _mask) {
     _visited[_node] = true;
-    linked_list_append(_result, _node);
-
-    for (int i = 0; i < _graph->size; i++) {
-        if (_graph->adj_matrix[_node][i] > 0 && !_visited[i]) {
-            dfs_recursive(_graph, i, _visited, _result);
+    linked_list_append(_result, _graph->to_external[_node]);
+
+    edge_cursor cursor;
+    int target, weight;
+    edge_cursor_open(_graph, _node, &cursor);
+    edge_cursor_set_mask(_graph, _node, _mask, &cursor);
+    while (edge_cursor_next(&cursor, &target, &weight)) {
+        if (!_visited[target]) {
+            dfs_recursive(_graph, target, _visited, _result, _mask);
         }
     }
 }
 
 linked_list weighted_direct_graph_dfs(weighted_direct_graph _graph, weighted_direct_graph_node_id _start) {
-    if (_graph == NULL || _start < 0 || _start >= _graph->size) return NULL;
+    return weighted_direct_graph_dfs_masked(_graph, _start, NULL);
+}
+
+linked_list weighted_direct_graph_dfs_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _start, weighted_direct_graph_mask _mask) {
+    if (_graph == NULL || !valid_id(_graph, _start)) return NULL;
 
     bool* visited = (bool*)calloc(_graph->size, sizeof(bool));
     if (visited == NULL) return NULL;
@@ -273,13 +1086,42 @@ linked_list weighted_direct_graph_dfs(weighted_direct_graph _graph, weighted_dir
         return NULL;
     }
 
-    dfs_recursive(_graph, _start, visited, result);
+    if (_mask == NULL || !mask_node_closed(_mask, _start)) {
+        dfs_recursive(_graph, _graph->to_internal[_start], visited, result, _mask);
+    }
     free(visited);
     return result;
 }
 
+// Funzione di utilità per prendere la coda delle visite del grafo, vuota e con spazio per tutti i nodi.
+// Se un'altra ricerca la sta già usando ne viene creata una nuova, così le letture concorrenti
+// della stessa versione non condividono mai la coda
+static queue take_work_list(weighted_direct_graph _graph) {
+    queue work = atomic_exchange(&_graph->work_list, NULL);
+    if (work == NULL) return queue_create(_graph->size);
+
+    queue_clear(work);
+    if (queue_reserve(work, _graph->size) != QUEUE_SUCCESS) {
+        queue_destroy(&work);
+        return NULL;
+    }
+    return work;
+}
+
+// Funzione di utilità per restituire la coda al grafo; se nel frattempo ne è stata restituita un'altra viene distrutta
+static void give_back_work_list(weighted_direct_graph _graph, queue _work) {
+    queue expected = NULL;
+    if (!atomic_compare_exchange_strong(&_graph->work_list, &expected, _work)) {
+        queue_destroy(&_work);
+    }
+}
+
 linked_list weighted_direct_graph_bfs(weighted_direct_graph _graph, weighted_direct_graph_node_id _start) {
-    if (_graph == NULL || _start < 0 || _start >= _graph->size) return NULL;
+    return weighted_direct_graph_bfs_masked(_graph, _start, NULL);
+}
+
+linked_list weighted_direct_graph_bfs_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _start, weighted_direct_graph_mask _mask) {
+    if (_graph == NULL || !valid_id(_graph, _start)) return NULL;
 
     bool* visited = (bool*)calloc(_graph->size, sizeof(bool));
     if (visited == NULL) return NULL;
@@ -290,37 +1132,50 @@ linked_list weighted_direct_graph_bfs(weighted_direct_graph _graph, weighted_dir
         return NULL;
     }
 
-    queue queue = queue_create(MAX_SIZE);
+    // Ogni nodo entra in coda al più una volta: lo spazio riservato basta per tutta la visita
+    queue queue = take_work_list(_graph);
     if (queue == NULL) {
         free(visited);
         linked_list_destroy(&result);
         return NULL;
     }
 
-    visited[_start] = true;
-    queue_enqueue(queue, _start);
+    int start = _graph->to_internal[_start];
+    visited[start] = true;
+    if (_mask == NULL || !mask_node_closed(_mask, _start)) {
+        queue_enqueue(queue, start);
+    }
 
     while (!queue_is_empty(queue)) {
         int current;
         queue_dequeue(queue, &current);
-        linked_list_append(result, current);
-
-        for (int i = 0; i < _graph->size; i++) {
-            if (_graph->adj_matrix[current][i] > 0 && !visited[i]) {
-                visited[i] = true;
-                queue_enqueue(queue, i);
+        linked_list_append(result, _graph->to_external[current]);
+
+        edge_cursor cursor;
+        int target, weight;
+        edge_cursor_open(_graph, current, &cursor);
+        edge_cursor_set_mask(_graph, current, _mask, &cursor);
+        while (edge_cursor_next(&cursor, &target, &weight)) {
+            if (!visited[target]) {
+                visited[target] = true;
+                queue_enqueue(queue, target);
             }
         }
     }
 
-    queue_destroy(&queue);
+    give_back_work_list(_graph, queue);
     free(visited);
     return result;
 }
 
 int weighted_direct_graph_path_exists(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
+    return weighted_direct_graph_path_exists_masked(_graph, _src, _dst, NULL);
+}
+
+int weighted_direct_graph_path_exists_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, weighted_direct_graph_mask _mask) {
     if (_graph == NULL) return WDG_ERROR_NULL;
-    if (_src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
+    if (_mask != NULL && (mask_node_closed(_mask, _src) || mask_node_closed(_mask, _dst))) return 0;
 
     // Caso speciale: stesso nodo
     if (_src == _dst) return 1;
@@ -328,56 +1183,81 @@ int weighted_direct_graph_path_exists(weighted_direct_graph _graph, weighted_dir
     bool* visited = (bool*)calloc(_graph->size, sizeof(bool));
     if (visited == NULL) return 0;
 
-    queue queue = queue_create(MAX_SIZE);
+    // Ogni nodo entra in coda al più una volta: lo spazio riservato basta per tutta la visita
+    queue queue = take_work_list(_graph);
     if (queue == NULL) {
         free(visited);
         return 0;
     }
 
-    visited[_src] = true;
-    queue_enqueue(queue, _src);
+    int src = _graph->to_internal[_src];
+    int dst = _graph->to_internal[_dst];
+    visited[src] = true;
+    queue_enqueue(queue, src);
 
     while (!queue_is_empty(queue)) {
         int current;
         queue_dequeue(queue, &current);
 
-        for (int i = 0; i < _graph->size; i++) {
-            if (_graph->adj_matrix[current][i] > 0) {
-                if (i == _dst) {
-                    queue_destroy(&queue);
-                    free(visited);
-                    return 1;
-                }
+        edge_cursor cursor;
+        int target, weight;
+        edge_cursor_open(_graph, current, &cursor);
+        edge_cursor_set_mask(_graph, current, _mask, &cursor);
+        while (edge_cursor_next(&cursor, &target, &weight)) {
+            if (target == dst) {
+                give_back_work_list(_graph, queue);
+                free(visited);
+                return 1;
+            }
 
-                if (!visited[i]) {
-                    visited[i] = true;
-                    queue_enqueue(queue, i);
-                }
+            if (!visited[target]) {
+                visited[target] = true;
+                queue_enqueue(queue, target);
             }
         }
     }
 
-    queue_destroy(&queue);
+    give_back_work_list(_graph, queue);
     free(visited);
     return 0;
 }
 
-// Funzione di utilità per ricostruire il percorso dai predecessori
-static linked_list reconstruct_path(int* _predecessors, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
+// Funzione di utilità per ricostruire il percorso dai predecessori (indici interni),
+// restituendo la lista degli id esterni
+static linked_list reconstruct_path(weighted_direct_graph _graph, int* _predecessors, int _src, int _dst) {
     linked_list path = linked_list_create();
     if (path == NULL) return NULL;
 
     int current = _dst;
     while (current != -1) {
-        linked_list_prepend(path, current);
-        current = _predecessors[current];
+        linked_list_prepend(path, _graph->to_external[current]);
+        int previous = _predecessors[current];
+
+        // Un passo senza arco diretto è una scorciatoia: reinserisce i nodi della catena
+        if (previous != -1 && _graph->contraction != NULL && edge_weight(_graph, previous, current) <= 0) {
+            const struct _contraction* contraction = _graph->contraction;
+            for (int s = contraction->first[previous]; s != -1; s = contraction->shortcuts[s].next) {
+                const struct _shortcut* shortcut = &contraction->shortcuts[s];
+                if (shortcut->dst != current) continue;
+                for (int k = shortcut->via_len - 1; k >= 0; k--) {
+                    linked_list_prepend(path, _graph->to_external[contraction->via[shortcut->via_start + k]]);
+                }
+                break;
+            }
+        }
+        current = previous;
     }
 
     return path;
 }
 
 linked_list weighted_direct_graph_get_path(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
-    if (_graph == NULL || _src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return NULL;
+    return weighted_direct_graph_get_path_masked(_graph, _src, _dst, NULL);
+}
+
+linked_list weighted_direct_graph_get_path_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, weighted_direct_graph_mask _mask) {
+    if (_graph == NULL || !valid_id(_graph, _src) || !valid_id(_graph, _dst)) return NULL;
+    if (_mask != NULL && (mask_node_closed(_mask, _src) || mask_node_closed(_mask, _dst))) return NULL;
 
     // Caso speciale: stesso nodo
     if (_src == _dst) {
@@ -399,28 +1279,35 @@ linked_list weighted_direct_graph_get_path(weighted_direct_graph _graph, weighte
         predecessors[i] = -1;
     }
 
-    queue queue = queue_create(MAX_SIZE);
+    // Ogni nodo entra in coda al più una volta: lo spazio riservato basta per tutta la visita
+    queue queue = take_work_list(_graph);
     if (queue == NULL) {
         free(visited);
         free(predecessors);
         return NULL;
     }
 
-    visited[_src] = true;
-    queue_enqueue(queue, _src);
+    int src = _graph->to_internal[_src];
+    int dst = _graph->to_internal[_dst];
+    visited[src] = true;
+    queue_enqueue(queue, src);
 
     bool found = false;
     while (!queue_is_empty(queue) && !found) {
         int current;
         queue_dequeue(queue, &current);
 
-        for (int i = 0; i < _graph->size; i++) {
-            if (_graph->adj_matrix[current][i] > 0 && !visited[i]) {
-                visited[i] = true;
-                predecessors[i] = current;
-                queue_enqueue(queue, i);
-
-                if (i == _dst) {
+        edge_cursor cursor;
+        int target, weight;
+        edge_cursor_open(_graph, current, &cursor);
+        edge_cursor_set_mask(_graph, current, _mask, &cursor);
+        while (edge_cursor_next(&cursor, &target, &weight)) {
+            if (!visited[target]) {
+                visited[target] = true;
+                predecessors[target] = current;
+                queue_enqueue(queue, target);
+
+                if (target == dst) {
                     found = true;
                     break;
                 }
@@ -428,7 +1315,7 @@ linked_list weighted_direct_graph_get_path(weighted_direct_graph _graph, weighte
         }
     }
 
-    queue_destroy(&queue);
+    give_back_work_list(_graph, queue);
     free(visited);
 
     if (!found) {
@@ -436,7 +1323,7 @@ linked_list weighted_direct_graph_get_path(weighted_direct_graph _graph, weighte
         return NULL;
     }
 
-    linked_list path = reconstruct_path(predecessors, _src, _dst);
+    linked_list path = reconstruct_path(_graph, predecessors, src, dst);
     free(predecessors);
     return path;
 }
@@ -458,16 +1345,16 @@ int weighted_direct_graph_get_path_weight(weighted_direct_graph _graph, linked_l
     for (int i = 1; i < path_size; i++) {
         linked_list_get_at(_path, i, &curr_node);
         
-        if (prev_node < 0 || prev_node >= _graph->size || curr_node < 0 || curr_node >= _graph->size) {
+        if (!valid_id(_graph, prev_node) || !valid_id(_graph, curr_node)) {
             return WDG_ERROR_INVALID_ID;
         }
         
-        int edge_weight = _graph->adj_matrix[prev_node][curr_node];
-        if (edge_weight <= 0) {
+        int weight = edge_weight(_graph, _graph->to_internal[prev_node], _graph->to_internal[curr_node]);
+        if (weight <= 0) {
             return WDG_ERROR_INVALID_ID; // Arco non esistente
         }
         
-        total_weight += edge_weight;
+        total_weight += weight;
         prev_node = curr_node;
     }
 
@@ -475,8 +1362,168 @@ int weighted_direct_graph_get_path_weight(weighted_direct_graph _graph, linked_l
     return WDG_SUCCESS;
 }
 
+/*
+ * Frontiera delle ricerche di cammino minimo: heap d-ario di nodi interni ordinato per
+ * distanza crescente. Ogni nodo compare al più una volta e positions ne registra la
+ * posizione, così una distanza migliorata fa risalire il nodo invece di duplicarlo.
+ * Estrarre il minimo costa O(log n) invece di una scansione di tutti i nodi.
+ */
+typedef struct {
+    int* nodes;         // Nodi nello heap
+    double* keys;       // Distanza di ogni elemento dello heap
+    int* positions;     // Posizione nello heap di ogni nodo interno (-1 se assente)
+    int size;
+} frontier;
+
+// Funzione di utilità per liberare la frontiera (anche se la creazione è fallita)
+static void frontier_free(frontier* _frontier) {
+    free(_frontier->nodes);
+    free(_frontier->keys);
+    free(_frontier->positions);
+    _frontier->nodes = NULL;
+    _frontier->keys = NULL;
+    _frontier->positions = NULL;
+    _frontier->size = 0;
+}
+
+// Funzione di utilità per creare una frontiera vuota per _n nodi
+static int frontier_init(frontier* _frontier, int _n) {
+    _frontier->nodes = (int*)malloc(_n * sizeof(int));
+    _frontier->keys = (double*)malloc(_n * sizeof(double));
+    _frontier->positions = (int*)malloc(_n * sizeof(int));
+    _frontier->size = 0;
+    if (_frontier->nodes == NULL || _frontier->keys == NULL || _frontier->positions == NULL) {
+        frontier_free(_frontier);
+        return WDG_ERROR_MEMORY;
+    }
+
+    for (int i = 0; i < _n; i++) {
+        _frontier->positions[i] = -1;
+    }
+    return WDG_SUCCESS;
+}
+
+// Funzione di utilità per svuotare la frontiera in tempo proporzionale ai nodi rimasti
+static void frontier_clear(frontier* _frontier) {
+    for (int i = 0; i < _frontier->size; i++) {
+        _frontier->positions[_frontier->nodes[i]] = -1;
+    }
+    _frontier->size = 0;
+}
+
+// Funzione di utilità per collocare un nodo nello heap aggiornandone la posizione
+static void frontier_place(frontier* _frontier, int _index, int _node, double _key) {
+    _frontier->nodes[_index] = _node;
+    _frontier->keys[_index] = _key;
+    _frontier->positions[_node] = _index;
+}
+
+// Funzione di utilità per inserire _node con distanza _key o, se è già presente, abbassarne la distanza
+static void frontier_push(frontier* _frontier, int _node, double _key) {
+    int index = _frontier->positions[_node];
+    if (index < 0) index = _frontier->size++;
+
+    while (index > 0) {
+        int parent = (index - 1) / FRONTIER_ARITY;
+        if (_frontier->keys[parent] <= _key) break;
+        frontier_place(_frontier, index, _frontier->nodes[parent], _frontier->keys[parent]);
+        index = parent;
+    }
+    frontier_place(_frontier, index, _node, _key);
+}
+
+// Funzione di utilità per estrarre il nodo con la distanza minima (-1 se la frontiera è vuota)
+static int frontier_pop(frontier* _frontier) {
+    if (_frontier->size == 0) return -1;
+
+    int top = _frontier->nodes[0];
+    _frontier->positions[top] = -1;
+    _frontier->size--;
+    if (_frontier->size == 0) return top;
+
+    // L'ultimo elemento prende il posto della radice e scende
+    int node = _frontier->nodes[_frontier->size];
+    double key = _frontier->keys[_frontier->size];
+    int index = 0;
+    for (;;) {
+        int first = index * FRONTIER_ARITY + 1;
+        if (first >= _frontier->size) break;
+
+        int last = first + FRONTIER_ARITY;
+        if (last > _frontier->size) last = _frontier->size;
+        int best = first;
+        for (int child = first + 1; child < last; child++) {
+            if (_frontier->keys[child] < _frontier->keys[best]) best = child;
+        }
+
+        if (_frontier->keys[best] >= key) break;
+        frontier_place(_frontier, index, _frontier->nodes[best], _frontier->keys[best]);
+        index = best;
+    }
+    frontier_place(_frontier, index, node, key);
+    return top;
+}
+
+// Funzione di utilità che esegue Dijkstra sugli indici interni a partire da _src.
+// Riempie _distances e, se non NULL, _predecessors; si ferma appena _dst è definitivo.
+// Se il grafo è contratto ed entrambi gli estremi sono rimasti, la ricerca usa le scorciatoie.
+// I pesi sono letti dalla sola metrica _metric. Con una maschera le scorciatoie non vengono
+// usate, perché potrebbero attraversare nodi o archi chiusi.
+// Restituisce WDG_SUCCESS, oppure WDG_ERROR_MEMORY se non è possibile creare la frontiera.
+static int dijkstra(weighted_direct_graph _graph, int _src, int _dst, int _metric, const struct _weighted_direct_graph_mask* _mask,
+                    int* _distances, int* _predecessors, bool* _visited) {
+    bool use_shortcuts = _graph->contraction != NULL && _mask == NULL &&
+                         !_graph->contraction->contracted[_src] && !_graph->contraction->contracted[_dst];
+
+    frontier frontier;
+    if (frontier_init(&frontier, _graph->size) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+
+    // Inizializza distanze e predecessori
+    for (int i = 0; i < _graph->size; i++) {
+        _distances[i] = INFINITY_DISTANCE;
+        if (_predecessors != NULL) _predecessors[i] = -1;
+    }
+    _distances[_src] = 0;
+    frontier_push(&frontier, _src, 0);
+
+    // Estrae ogni volta il nodo non visitato con la distanza minima
+    int current;
+    while ((current = frontier_pop(&frontier)) != -1) {
+        if (current == _dst) break;
+
+        _visited[current] = true;
+
+        // Aggiorna le distanze dei nodi adiacenti
+        edge_cursor cursor;
+        int v, weight;
+        if (use_shortcuts) edge_cursor_open_contracted(_graph, current, _metric, &cursor);
+        else edge_cursor_open_metric(_graph, current, _metric, &cursor);
+        edge_cursor_set_mask(_graph, current, _mask, &cursor);
+        while (edge_cursor_next(&cursor, &v, &weight)) {
+            if (!_visited[v] && _distances[current] + weight < _distances[v]) {
+                _distances[v] = _distances[current] + weight;
+                if (_predecessors != NULL) _predecessors[v] = current;
+                frontier_push(&frontier, v, _distances[v]);
+            }
+        }
+    }
+
+    frontier_free(&frontier);
+    return WDG_SUCCESS;
+}
+
 linked_list weighted_direct_graph_shortest_path(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
-    if (_graph == NULL || _src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return NULL;
+    return weighted_direct_graph_shortest_path_by_metric(_graph, _src, _dst, 0);
+}
+
+linked_list weighted_direct_graph_shortest_path_by_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric) {
+    return weighted_direct_graph_shortest_path_masked(_graph, _src, _dst, _metric, NULL);
+}
+
+linked_list weighted_direct_graph_shortest_path_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, weighted_direct_graph_mask _mask) {
+    if (_graph == NULL || !valid_id(_graph, _src) || !valid_id(_graph, _dst)) return NULL;
+    if (_metric < 0 || _metric >= _graph->num_metrics) return NULL;
+    if (_mask != NULL && (mask_node_closed(_mask, _src) || mask_node_closed(_mask, _dst))) return NULL;
 
     // Caso speciale: stesso nodo
     if (_src == _dst) {
@@ -498,61 +1545,38 @@ linked_list weighted_direct_graph_shortest_path(weighted_direct_graph _graph, we
         return NULL;
     }
 
-    // Inizializza distanze e predecessori
-    for (int i = 0; i < _graph->size; i++) {
-        distances[i] = INFINITY_DISTANCE;
-        predecessors[i] = -1;
-    }
-    distances[_src] = 0;
-
-    // Algoritmo di Dijkstra
-    for (int count = 0; count < _graph->size - 1; count++) {
-        // Trova il nodo con la distanza minima tra quelli non visitati
-        int min_dist = INFINITY_DISTANCE;
-        int min_index = -1;
-        
-        for (int v = 0; v < _graph->size; v++) {
-            if (!visited[v] && distances[v] < min_dist) {
-                min_dist = distances[v];
-                min_index = v;
-            }
-        }
-        
-        // Se non ci sono più nodi raggiungibili
-        if (min_index == -1) break;
-        
-        visited[min_index] = true;
-        
-        // Aggiorna le distanze dei nodi adiacenti
-        for (int v = 0; v < _graph->size; v++) {
-            int edge_weight = _graph->adj_matrix[min_index][v];
-            if (!visited[v] && edge_weight > 0 && 
-                distances[min_index] != INFINITY_DISTANCE && 
-                distances[min_index] + edge_weight < distances[v]) {
-                distances[v] = distances[min_index] + edge_weight;
-                predecessors[v] = min_index;
-            }
-        }
-    }
+    int src = _graph->to_internal[_src];
+    int dst = _graph->to_internal[_dst];
+    int result = dijkstra(_graph, src, dst, _metric, _mask, distances, predecessors, visited);
     
     free(distances);
     free(visited);
     
-    // Se la destinazione non è raggiungibile
-    if (predecessors[_dst] == -1 && _src != _dst) {
+    // Se la ricerca non è riuscita o la destinazione non è raggiungibile
+    if (result != WDG_SUCCESS || predecessors[dst] == -1) {
         free(predecessors);
         return NULL;
     }
     
     // Ricostruisci il percorso
-    linked_list path = reconstruct_path(predecessors, _src, _dst);
+    linked_list path = reconstruct_path(_graph, predecessors, src, dst);
     free(predecessors);
     return path;
 }
 
 int weighted_direct_graph_shortest_path_weight(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int* _weight_out) {
+    return weighted_direct_graph_shortest_path_weight_by_metric(_graph, _src, _dst, 0, _weight_out);
+}
+
+int weighted_direct_graph_shortest_path_weight_by_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, int* _weight_out) {
+    return weighted_direct_graph_shortest_path_weight_masked(_graph, _src, _dst, _metric, NULL, _weight_out);
+}
+
+int weighted_direct_graph_shortest_path_weight_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, weighted_direct_graph_mask _mask, int* _weight_out) {
     if (_graph == NULL || _weight_out == NULL) return WDG_ERROR_NULL;
-    if (_src < 0 || _src >= _graph->size || _dst < 0 || _dst >= _graph->size) return WDG_ERROR_INVALID_ID;
+    if (!valid_id(_graph, _src) || !valid_id(_graph, _dst)) return WDG_ERROR_INVALID_ID;
+    if (_metric < 0 || _metric >= _graph->num_metrics) return WDG_ERROR_INVALID_ID;
+    if (_mask != NULL && (mask_node_closed(_mask, _src) || mask_node_closed(_mask, _dst))) return WDG_ERROR_INVALID_ID;
 
     // Caso speciale: stesso nodo
     if (_src == _dst) {
@@ -570,51 +1594,1058 @@ int weighted_direct_graph_shortest_path_weight(weighted_direct_graph _graph, wei
         return WDG_ERROR_MEMORY;
     }
 
-    // Inizializza distanze
-    for (int i = 0; i < _graph->size; i++) {
-        distances[i] = INFINITY_DISTANCE;
-    }
-    distances[_src] = 0;
-
-    // Algoritmo di Dijkstra
-    for (int count = 0; count < _graph->size - 1; count++) {
-        // Trova il nodo con la distanza minima tra quelli non visitati
-        int min_dist = INFINITY_DISTANCE;
-        int min_index = -1;
-        
-        for (int v = 0; v < _graph->size; v++) {
-            if (!visited[v] && distances[v] < min_dist) {
-                min_dist = distances[v];
-                min_index = v;
-            }
-        }
-        
-        // Se non ci sono più nodi raggiungibili
-        if (min_index == -1) break;
-        
-        visited[min_index] = true;
-        
-        // Aggiorna le distanze dei nodi adiacenti
-        for (int v = 0; v < _graph->size; v++) {
-            int edge_weight = _graph->adj_matrix[min_index][v];
-            if (!visited[v] && edge_weight > 0 && 
-                distances[min_index] != INFINITY_DISTANCE && 
-                distances[min_index] + edge_weight < distances[v]) {
-                distances[v] = distances[min_index] + edge_weight;
-            }
-        }
+    int dst = _graph->to_internal[_dst];
+    if (dijkstra(_graph, _graph->to_internal[_src], dst, _metric, _mask, distances, NULL, visited) != WDG_SUCCESS) {
+        free(distances);
+        free(visited);
+        return WDG_ERROR_MEMORY;
     }
     
     // Verifica se la destinazione è raggiungibile
-    if (distances[_dst] == INFINITY_DISTANCE) {
+    if (distances[dst] == INFINITY_DISTANCE) {
         free(distances);
         free(visited);
         return WDG_ERROR_INVALID_ID; // Destinazione non raggiungibile
     }
     
-    *_weight_out = distances[_dst];
+    *_weight_out = distances[dst];
     
     free(distances);
     free(visited);
     return WDG_SUCCESS;
 }
+
+// Funzione di utilità per un passo di ordinamento stabile per conteggio: riordina _perm
+// secondo _keys[_perm[i]] (valori in [0, _range)), usando _tmp e _buckets come appoggio
+static void counting_sort_pass(const int* _keys, int* _perm, int* _tmp, int _count, int* _buckets, int _range) {
+    memset(_buckets, 0, (_range + 1) * sizeof(int));
+    for (int i = 0; i < _count; i++) {
+        _buckets[_keys[_perm[i]] + 1]++;
+    }
+    for (int k = 0; k < _range; k++) {
+        _buckets[k + 1] += _buckets[k];
+    }
+    for (int i = 0; i < _count; i++) {
+        _tmp[_buckets[_keys[_perm[i]]]++] = _perm[i];
+    }
+    memcpy(_perm, _tmp, _count * sizeof(int));
+}
+
+/*
+ * Rete degli archi in forma compatta (righe consecutive per nodo interno) usata
+ * dall'assegnazione del traffico, che a ogni iterazione legge tutti gli archi con
+ * costi diversi dai pesi memorizzati.
+ */
+typedef struct {
+    int* offsets;       // Primo arco uscente da ogni nodo interno (size + 1 elementi)
+    int* sources;       // Origine di ogni arco
+    int* targets;       // Destinazione di ogni arco
+    double* free_time;  // Tempo a rete scarica (peso della metrica principale)
+    int num_edges;
+} traffic_network;
+
+// Percorso (sequenza di archi) di un gruppo di viaggi con la stessa origine e destinazione
+typedef struct {
+    double share;       // Frazione dei viaggi del gruppo assegnata al percorso
+    int start;          // Primo arco del percorso nel pool
+    int len;            // Numero di archi
+    int trips;          // Viaggi assegnati al termine dell'equilibrio
+    int next;           // Percorso successivo dello stesso gruppo (-1 se ultimo)
+} assigned_path;
+
+/*
+ * Percorsi prodotti dalle iterazioni di Frank-Wolfe. Ogni iterazione sposta una frazione
+ * lambda del flusso sul percorso appena calcolato: tenendo le quote per percorso, alla fine
+ * i viaggi di uno stesso gruppo possono essere ripartiti tra più percorsi.
+ */
+typedef struct {
+    assigned_path* paths;
+    int num_paths;
+    int path_capacity;
+    int* edges;
+    int num_edges;
+    int edge_capacity;
+    int* first;         // Primo percorso di ogni gruppo (-1 se nessuno)
+} path_store;
+
+// Funzione di utilità per costruire la rete compatta dagli archi del grafo (metrica principale)
+static int build_traffic_network(weighted_direct_graph _graph, traffic_network* _net) {
+    int n = _graph->size;
+    _net->num_edges = 0;
+    _net->sources = NULL;
+    _net->targets = NULL;
+    _net->free_time = NULL;
+    _net->offsets = (int*)malloc((n + 1) * sizeof(int));
+    if (_net->offsets == NULL) return WDG_ERROR_MEMORY;
+
+    for (int i = 0; i < n; i++) {
+        _net->offsets[i] = _net->num_edges;
+        edge_cursor cursor;
+        int target, weight;
+        edge_cursor_open(_graph, i, &cursor);
+        while (edge_cursor_next_raw(&cursor, &target, &weight)) {
+            _net->num_edges++;
+        }
+    }
+    _net->offsets[n] = _net->num_edges;
+
+    _net->sources = (int*)malloc((_net->num_edges + 1) * sizeof(int));
+    _net->targets = (int*)malloc((_net->num_edges + 1) * sizeof(int));
+    _net->free_time = (double*)malloc((_net->num_edges + 1) * sizeof(double));
+    if (_net->sources == NULL || _net->targets == NULL || _net->free_time == NULL) return WDG_ERROR_MEMORY;
+
+    for (int i = 0; i < n; i++) {
+        int e = _net->offsets[i];
+        edge_cursor cursor;
+        int target, weight;
+        edge_cursor_open(_graph, i, &cursor);
+        while (edge_cursor_next_raw(&cursor, &target, &weight)) {
+            _net->sources[e] = i;
+            _net->targets[e] = target;
+            _net->free_time[e] = weight;
+            e++;
+        }
+    }
+    return WDG_SUCCESS;
+}
+
+// Funzione di utilità per il tempo di percorrenza BPR di un arco con il flusso indicato
+static double bpr_time(double _free_time, double _flow, int _capacity) {
+    double ratio = _flow / _capacity;
+    ratio *= ratio;
+    return _free_time * (1.0 + BPR_ALPHA * ratio * ratio);
+}
+
+// Funzione di utilità: Dijkstra da _src su costi reali, con l'arco di arrivo di ogni nodo in _pred_edge
+static void traffic_dijkstra(const traffic_network* _net, int _n, int _src, const double* _cost,
+                             double* _dist, int* _pred_edge, bool* _visited, frontier* _frontier) {
+    for (int i = 0; i < _n; i++) {
+        _dist[i] = DBL_MAX;
+        _pred_edge[i] = -1;
+        _visited[i] = false;
+    }
+    _dist[_src] = 0.0;
+    frontier_clear(_frontier);
+    frontier_push(_frontier, _src, 0.0);
+
+    int u;
+    while ((u = frontier_pop(_frontier)) != -1) {
+        _visited[u] = true;
+        for (int e = _net->offsets[u]; e < _net->offsets[u + 1]; e++) {
+            int v = _net->targets[e];
+            if (!_visited[v] && _dist[u] + _cost[e] < _dist[v]) {
+                _dist[v] = _dist[u] + _cost[e];
+                _pred_edge[v] = e;
+                frontier_push(_frontier, v, _dist[v]);
+            }
+        }
+    }
+}
+
+/*
+ * Funzione di utilità che registra il percorso _edges per il gruppo _group e ne restituisce
+ * l'indice; un percorso già presente nel gruppo non viene duplicato. -1 in caso di errore.
+ */
+static int store_path(path_store* _store, int _group, const int* _edges, int _len) {
+    for (int p = _store->first[_group]; p != -1; p = _store->paths[p].next) {
+        if (_store->paths[p].len == _len && (_len == 0 || memcmp(&_store->edges[_store->paths[p].start], _edges, _len * sizeof(int)) == 0)) {
+            return p;
+        }
+    }
+
+    if (_store->num_paths == _store->path_capacity) {
+        int new_capacity = (_store->path_capacity == 0) ? INITIAL_CAPACITY : _store->path_capacity * GROWTH_FACTOR;
+        assigned_path* new_paths = (assigned_path*)realloc(_store->paths, new_capacity * sizeof(assigned_path));
+        if (new_paths == NULL) return -1;
+        _store->paths = new_paths;
+        _store->path_capacity = new_capacity;
+    }
+    while (_store->num_edges + _len > _store->edge_capacity) {
+        int new_capacity = (_store->edge_capacity == 0) ? INITIAL_CAPACITY : _store->edge_capacity * GROWTH_FACTOR;
+        int* new_edges = (int*)realloc(_store->edges, new_capacity * sizeof(int));
+        if (new_edges == NULL) return -1;
+        _store->edges = new_edges;
+        _store->edge_capacity = new_capacity;
+    }
+
+    assigned_path* path = &_store->paths[_store->num_paths];
+    path->share = 0.0;
+    path->start = _store->num_edges;
+    path->len = _len;
+    path->trips = 0;
+    path->next = _store->first[_group];
+    if (_len > 0) memcpy(&_store->edges[path->start], _edges, _len * sizeof(int));
+    _store->num_edges += _len;
+    _store->first[_group] = _store->num_paths;
+    return _store->num_paths++;
+}
+
+/*
+ * Funzione di utilità per l'assegnazione tutto-o-niente: ogni gruppo percorre il cammino
+ * minimo con i costi _cost. Un solo albero di Dijkstra per origine serve tutti i gruppi
+ * con quell'origine (i gruppi sono ordinati per origine). Il flusso risultante è scritto
+ * in _flow_out e il percorso scelto da ogni gruppo in _path_out (-1 se irraggiungibile).
+ */
+static int all_or_nothing(const traffic_network* _net, int _n, const double* _cost, int _num_groups,
+                          const int* _group_src, const int* _group_dst, const int* _group_demand,
+                          path_store* _store, double* _flow_out, int* _path_out,
+                          double* _dist, int* _pred_edge, bool* _visited, frontier* _frontier, int* _buffer) {
+    memset(_flow_out, 0, (_net->num_edges + 1) * sizeof(double));
+
+    for (int g = 0; g < _num_groups; g++) {
+        if (g == 0 || _group_src[g] != _group_src[g - 1]) {
+            traffic_dijkstra(_net, _n, _group_src[g], _cost, _dist, _pred_edge, _visited, _frontier);
+        }
+
+        _path_out[g] = -1;
+        if (_dist[_group_dst[g]] == DBL_MAX) continue;
+
+        // Risale gli archi dalla destinazione, poi li rimette in ordine di percorrenza
+        int len = 0;
+        for (int v = _group_dst[g]; v != _group_src[g]; v = _net->sources[_pred_edge[v]]) {
+            _buffer[len++] = _pred_edge[v];
+            _flow_out[_pred_edge[v]] += _group_demand[g];
+        }
+        for (int k = 0; k < len / 2; k++) {
+            int tmp = _buffer[k];
+            _buffer[k] = _buffer[len - 1 - k];
+            _buffer[len - 1 - k] = tmp;
+        }
+
+        _path_out[g] = store_path(_store, g, _buffer, len);
+        if (_path_out[g] < 0) return WDG_ERROR_MEMORY;
+    }
+    return WDG_SUCCESS;
+}
+
+// Funzione di utilità: derivata dell'obiettivo di Beckmann lungo la direzione _aon - _flow nel punto _lambda
+static double beckmann_slope(const traffic_network* _net, const double* _flow, const double* _aon, int _capacity, double _lambda) {
+    double slope = 0.0;
+    for (int e = 0; e < _net->num_edges; e++) {
+        double direction = _aon[e] - _flow[e];
+        if (direction != 0.0) {
+            slope += direction * bpr_time(_net->free_time[e], _flow[e] + _lambda * direction, _capacity);
+        }
+    }
+    return slope;
+}
+
+// Funzione di utilità che converte un percorso registrato in una lista di id esterni
+static linked_list assigned_path_to_list(weighted_direct_graph _graph, const traffic_network* _net,
+                                         const path_store* _store, int _path, int _src) {
+    linked_list list = linked_list_create();
+    if (list == NULL) return NULL;
+
+    bool ok = linked_list_append(list, _graph->to_external[_src]) == LINKED_LIST_SUCCESS;
+    const assigned_path* path = &_store->paths[_path];
+    for (int k = 0; k < path->len && ok; k++) {
+        ok = linked_list_append(list, _graph->to_external[_net->targets[_store->edges[path->start + k]]]) == LINKED_LIST_SUCCESS;
+    }
+    if (!ok) linked_list_destroy(&list);
+    return list;
+}
+
+int weighted_direct_graph_assign_traffic(weighted_direct_graph _graph, const weighted_direct_graph_node_id* _src,
+                                         const weighted_direct_graph_node_id* _dst, int _count, int _capacity,
+                                         int _max_iterations, linked_list* _paths_out) {
+    if (_graph == NULL || (_count > 0 && (_src == NULL || _dst == NULL || _paths_out == NULL))) return WDG_ERROR_NULL;
+    if (_count < 0 || _capacity <= 0 || _max_iterations < 1) return WDG_ERROR_INVALID_ID;
+    for (int i = 0; i < _count; i++) {
+        if (!valid_id(_graph, _src[i]) || !valid_id(_graph, _dst[i])) return WDG_ERROR_INVALID_ID;
+    }
+    for (int i = 0; i < _count; i++) {
+        _paths_out[i] = NULL;
+    }
+    if (_count == 0) return WDG_SUCCESS;
+
+    int n = _graph->size;
+    traffic_network net;
+    path_store store = { NULL, 0, 0, NULL, 0, 0, NULL };
+    int result = build_traffic_network(_graph, &net);
+
+    // Raggruppa i viaggi per (origine, destinazione) con due passate di ordinamento radix:
+    // l'origine come chiave principale fa sì che un solo albero serva tutte le sue destinazioni
+    int* src = (int*)malloc(_count * sizeof(int));
+    int* dst = (int*)malloc(_count * sizeof(int));
+    int* perm = (int*)malloc(_count * sizeof(int));
+    int* tmp = (int*)malloc(_count * sizeof(int));
+    int* buckets = (int*)malloc((n + 1) * sizeof(int));
+    int* group_src = (int*)malloc(_count * sizeof(int));
+    int* group_dst = (int*)malloc(_count * sizeof(int));
+    int* group_demand = (int*)malloc(_count * sizeof(int));
+    int* group_path = (int*)malloc(_count * sizeof(int));
+    store.first = (int*)malloc(_count * sizeof(int));
+    double* flow = (double*)malloc((net.num_edges + 1) * sizeof(double));
+    double* aon = (double*)malloc((net.num_edges + 1) * sizeof(double));
+    double* cost = (double*)malloc((net.num_edges + 1) * sizeof(double));
+    double* dist = (double*)malloc(n * sizeof(double));
+    int* pred_edge = (int*)malloc(n * sizeof(int));
+    bool* visited = (bool*)malloc(n * sizeof(bool));
+    int* buffer = (int*)malloc(n * sizeof(int));
+    frontier frontier;
+    if (frontier_init(&frontier, n) != WDG_SUCCESS) result = WDG_ERROR_MEMORY;
+    if (result != WDG_SUCCESS || src == NULL || dst == NULL || perm == NULL || tmp == NULL || buckets == NULL ||
+        group_src == NULL || group_dst == NULL || group_demand == NULL || group_path == NULL || store.first == NULL ||
+        flow == NULL || aon == NULL || cost == NULL || dist == NULL || pred_edge == NULL || visited == NULL || buffer == NULL) {
+        result = WDG_ERROR_MEMORY;
+    }
+
+    int num_groups = 0;
+    if (result == WDG_SUCCESS) {
+        for (int i = 0; i < _count; i++) {
+            src[i] = _graph->to_internal[_src[i]];
+            dst[i] = _graph->to_internal[_dst[i]];
+            perm[i] = i;
+        }
+        counting_sort_pass(dst, perm, tmp, _count, buckets, n);
+        counting_sort_pass(src, perm, tmp, _count, buckets, n);
+
+        for (int i = 0; i < _count; i++) {
+            int t = perm[i];
+            if (i == 0 || src[t] != group_src[num_groups - 1] || dst[t] != group_dst[num_groups - 1]) {
+                group_src[num_groups] = src[t];
+                group_dst[num_groups] = dst[t];
+                group_demand[num_groups] = 0;
+                store.first[num_groups] = -1;
+                num_groups++;
+            }
+            group_demand[num_groups - 1]++;
+        }
+
+        // Prima iterazione: tutto-o-niente a rete scarica
+        result = all_or_nothing(&net, n, net.free_time, num_groups, group_src, group_dst, group_demand,
+                                &store, flow, group_path, dist, pred_edge, visited, &frontier, buffer);
+        for (int g = 0; g < num_groups && result == WDG_SUCCESS; g++) {
+            if (group_path[g] >= 0) store.paths[group_path[g]].share = 1.0;
+        }
+    }
+
+    for (int iteration = 1; iteration < _max_iterations && result == WDG_SUCCESS; iteration++) {
+        for (int e = 0; e < net.num_edges; e++) {
+            cost[e] = bpr_time(net.free_time[e], flow[e], _capacity);
+        }
+        result = all_or_nothing(&net, n, cost, num_groups, group_src, group_dst, group_demand,
+                                &store, aon, group_path, dist, pred_edge, visited, &frontier, buffer);
+        if (result != WDG_SUCCESS) break;
+
+        // Gap relativo: quanto il tempo totale attuale supera quello dei cammini minimi
+        double total = 0.0, best = 0.0;
+        for (int e = 0; e < net.num_edges; e++) {
+            total += flow[e] * cost[e];
+            best += aon[e] * cost[e];
+        }
+        if (total <= 0.0 || (total - best) / total < ASSIGNMENT_GAP) break;
+
+        // Ricerca lineare per bisezione del passo che minimizza l'obiettivo di Beckmann
+        double lambda = 1.0;
+        if (beckmann_slope(&net, flow, aon, _capacity, 1.0) > 0.0) {
+            double low = 0.0, high = 1.0;
+            for (int step = 0; step < LINE_SEARCH_STEPS; step++) {
+                lambda = (low + high) / 2.0;
+                if (beckmann_slope(&net, flow, aon, _capacity, lambda) > 0.0) high = lambda;
+                else low = lambda;
+            }
+            lambda = (low + high) / 2.0;
+        }
+
+        for (int e = 0; e < net.num_edges; e++) {
+            flow[e] += lambda * (aon[e] - flow[e]);
+        }
+        for (int p = 0; p < store.num_paths; p++) {
+            store.paths[p].share *= 1.0 - lambda;
+        }
+        for (int g = 0; g < num_groups; g++) {
+            if (group_path[g] >= 0) store.paths[group_path[g]].share += lambda;
+        }
+    }
+
+    // Ripartisce i viaggi di ogni gruppo tra i suoi percorsi in proporzione alle quote
+    // (metodo dei resti più grandi), nell'ordine in cui i viaggi sono stati passati
+    for (int g = 0, i = 0; g < num_groups && result == WDG_SUCCESS; g++) {
+        int demand = group_demand[g];
+        int assigned = 0;
+        for (int p = store.first[g]; p != -1; p = store.paths[p].next) {
+            store.paths[p].trips = (int)(store.paths[p].share * demand);
+            assigned += store.paths[p].trips;
+        }
+        while (assigned < demand && store.first[g] != -1) {
+            int best_path = store.first[g];
+            double best_rest = -1.0;
+            for (int p = store.first[g]; p != -1; p = store.paths[p].next) {
+                double rest = store.paths[p].share * demand - store.paths[p].trips;
+                if (rest > best_rest) {
+                    best_rest = rest;
+                    best_path = p;
+                }
+            }
+            store.paths[best_path].trips++;
+            assigned++;
+        }
+
+        // Senza percorsi la destinazione è irraggiungibile e i viaggi restano NULL
+        int end = i + demand;
+        for (int p = store.first[g]; p != -1 && result == WDG_SUCCESS; p = store.paths[p].next) {
+            for (int k = 0; k < store.paths[p].trips && i < end && result == WDG_SUCCESS; k++) {
+                int t = perm[i++];
+                _paths_out[t] = assigned_path_to_list(_graph, &net, &store, p, group_src[g]);
+                if (_paths_out[t] == NULL) result = WDG_ERROR_MEMORY;
+            }
+        }
+        i = end;
+    }
+
+    if (result != WDG_SUCCESS) {
+        for (int i = 0; i < _count; i++) {
+            linked_list_destroy(&_paths_out[i]);
+        }
+    }
+
+    free(net.offsets);
+    free(net.sources);
+    free(net.targets);
+    free(net.free_time);
+    free(store.paths);
+    free(store.edges);
+    free(store.first);
+    free(src);
+    free(dst);
+    free(perm);
+    free(tmp);
+    free(buckets);
+    free(group_src);
+    free(group_dst);
+    free(group_demand);
+    free(group_path);
+    free(flow);
+    free(aon);
+    free(cost);
+    free(dist);
+    free(pred_edge);
+    free(visited);
+    free(buffer);
+    frontier_free(&frontier);
+    return result;
+}
+
+// Funzione di utilità per calcolare il grado non orientato di ogni nodo (indici interni)
+static int* undirected_degrees(weighted_direct_graph _graph) {
+    int* degrees = (int*)calloc(_graph->size, sizeof(int));
+    if (degrees == NULL) return NULL;
+
+    for (int i = 0; i < _graph->size; i++) {
+        for (int j = i + 1; j < _graph->size; j++) {
+            if (_graph->weight_matrix[0][i][j] > 0 || _graph->weight_matrix[0][j][i] > 0) {
+                degrees[i]++;
+                degrees[j]++;
+            }
+        }
+    }
+    return degrees;
+}
+
+// Funzione di utilità che calcola l'ordine di visita (BFS o Cuthill-McKee) sul grafo
+// reso non orientato. _order_out[k] è il vecchio indice interno della posizione k.
+static int compute_order(weighted_direct_graph _graph, weighted_direct_graph_order _order, int* _order_out) {
+    int n = _graph->size;
+    bool* placed = (bool*)calloc(n, sizeof(bool));
+    int* degrees = (_order == WDG_ORDER_RCM) ? undirected_degrees(_graph) : NULL;
+    if (placed == NULL || (_order == WDG_ORDER_RCM && degrees == NULL)) {
+        free(placed);
+        free(degrees);
+        return WDG_ERROR_MEMORY;
+    }
+
+    int head = 0, tail = 0;
+    while (tail < n) {
+        // Nuova componente: per RCM parte dal nodo di grado minimo, per BFS dal primo libero
+        int start = -1;
+        for (int v = 0; v < n; v++) {
+            if (!placed[v] && (start == -1 || (degrees != NULL && degrees[v] < degrees[start]))) {
+                start = v;
+            }
+        }
+        placed[start] = true;
+        _order_out[tail++] = start;
+
+        // La porzione [head, tail) di _order_out funge da coda della visita
+        while (head < tail) {
+            int current = _order_out[head++];
+            int first_new = tail;
+            for (int v = 0; v < n; v++) {
+                if (!placed[v] && (_graph->weight_matrix[0][current][v] > 0 || _graph->weight_matrix[0][v][current] > 0)) {
+                    placed[v] = true;
+                    _order_out[tail++] = v;
+                }
+            }
+
+            // Cuthill-McKee: i nuovi vicini sono accodati per grado crescente
+            if (degrees != NULL) {
+                for (int a = first_new + 1; a < tail; a++) {
+                    int key = _order_out[a];
+                    int b = a - 1;
+                    while (b >= first_new && degrees[_order_out[b]] > degrees[key]) {
+                        _order_out[b + 1] = _order_out[b];
+                        b--;
+                    }
+                    _order_out[b + 1] = key;
+                }
+            }
+        }
+    }
+
+    // Reverse Cuthill-McKee: l'ordine finale è quello inverso
+    if (_order == WDG_ORDER_RCM) {
+        for (int a = 0, b = n - 1; a < b; a++, b--) {
+            int tmp = _order_out[a];
+            _order_out[a] = _order_out[b];
+            _order_out[b] = tmp;
+        }
+    }
+
+    free(placed);
+    free(degrees);
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_reorder(weighted_direct_graph _graph, weighted_direct_graph_order _order) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    if (_order != WDG_ORDER_CREATION && _order != WDG_ORDER_BFS && _order != WDG_ORDER_RCM) return WDG_ERROR_INVALID_ID;
+    if (_graph->compressed != NULL) return WDG_ERROR_READ_ONLY;
+    drop_contraction(_graph);
+    if (_graph->size == 0) return WDG_SUCCESS;
+
+    int n = _graph->size;
+    int* order = (int*)malloc(n * sizeof(int));
+    if (order == NULL) return WDG_ERROR_MEMORY;
+
+    if (_order == WDG_ORDER_CREATION) {
+        for (int k = 0; k < n; k++) {
+            order[k] = _graph->to_internal[k];
+        }
+    } else if (compute_order(_graph, _order, order) != WDG_SUCCESS) {
+        free(order);
+        return WDG_ERROR_MEMORY;
+    }
+
+    // Costruisce le matrici permutate: la nuova riga k è la vecchia riga order[k]
+    int** new_matrices[WDG_MAX_METRICS] = { NULL };
+    int* new_external = (int*)malloc(_graph->capacity * sizeof(int));
+    bool allocated = new_external != NULL;
+    for (int m = 0; m < _graph->num_metrics && allocated; m++) {
+        new_matrices[m] = create_matrix(_graph->capacity);
+        allocated = new_matrices[m] != NULL;
+    }
+    if (!allocated) {
+        for (int m = 0; m < _graph->num_metrics; m++) {
+            free_matrix(new_matrices[m], _graph->capacity);
+        }
+        free(new_external);
+        free(order);
+        return WDG_ERROR_MEMORY;
+    }
+
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        for (int k = 0; k < n; k++) {
+            const int* old_row = _graph->weight_matrix[m][order[k]];
+            for (int l = 0; l < n; l++) {
+                new_matrices[m][k][l] = old_row[order[l]];
+            }
+        }
+        free_matrix(_graph->weight_matrix[m], _graph->capacity);
+        _graph->weight_matrix[m] = new_matrices[m];
+    }
+    for (int k = 0; k < n; k++) {
+        new_external[k] = _graph->to_external[order[k]];
+    }
+
+    free(_graph->to_external);
+    _graph->to_external = new_external;
+
+    for (int k = 0; k < n; k++) {
+        _graph->to_internal[new_external[k]] = k;
+        update_row_bounds(_graph, k);
+    }
+
+    free(order);
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_set_storage(weighted_direct_graph _graph, weighted_direct_graph_storage _storage) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    if (_storage != WDG_STORAGE_MATRIX && _storage != WDG_STORAGE_COMPRESSED) return WDG_ERROR_INVALID_ID;
+    if (_storage == weighted_direct_graph_get_storage(_graph)) return WDG_SUCCESS;
+
+    if (_storage == WDG_STORAGE_COMPRESSED) {
+        struct _compressed_adjacency* compressed = build_compressed(_graph);
+        if (compressed == NULL) return WDG_ERROR_MEMORY;
+
+        // Le matrici non servono più: il grafo resta di sola lettura fino alla decompressione
+        for (int m = 0; m < _graph->num_metrics; m++) {
+            free_matrix(_graph->weight_matrix[m], _graph->capacity);
+            _graph->weight_matrix[m] = NULL;
+        }
+        _graph->compressed = compressed;
+        return WDG_SUCCESS;
+    }
+
+    // Ricostruisce le matrici decodificando le righe compresse
+    int** matrices[WDG_MAX_METRICS] = { NULL };
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        matrices[m] = create_matrix(_graph->capacity);
+        if (matrices[m] == NULL) {
+            for (int k = 0; k < m; k++) {
+                free_matrix(matrices[k], _graph->capacity);
+            }
+            return WDG_ERROR_MEMORY;
+        }
+
+        for (int i = 0; i < _graph->size; i++) {
+            edge_cursor cursor;
+            int target, weight;
+            edge_cursor_open_metric(_graph, i, m, &cursor);
+            while (edge_cursor_next_raw(&cursor, &target, &weight)) {
+                matrices[m][i][target] = weight;
+            }
+        }
+    }
+
+    free_compressed(_graph->compressed);
+    _graph->compressed = NULL;
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        _graph->weight_matrix[m] = matrices[m];
+    }
+    for (int i = 0; i < _graph->size; i++) {
+        update_row_bounds(_graph, i);
+    }
+    return WDG_SUCCESS;
+}
+
+weighted_direct_graph_storage weighted_direct_graph_get_storage(weighted_direct_graph _graph) {
+    if (_graph == NULL || _graph->compressed == NULL) return WDG_STORAGE_MATRIX;
+    return WDG_STORAGE_COMPRESSED;
+}
+
+// Funzione di utilità che registra il vicino non orientato _neighbor di _node (al più tre distinti)
+static void add_chain_neighbor(int* _neighbors, int* _count, int _node, int _neighbor) {
+    if (_node == _neighbor) return; // I cappi non contano ai fini del grado
+    int* slots = &_neighbors[_node * 2];
+    for (int k = 0; k < _count[_node] && k < 2; k++) {
+        if (slots[k] == _neighbor) return;
+    }
+    if (_count[_node] < 2) slots[_count[_node]] = _neighbor;
+    if (_count[_node] < 3) _count[_node]++;
+}
+
+// Funzione di utilità che calcola il peso della catena _chain[0] -> ... -> _chain[_len - 1]
+// nella metrica _metric, restituendo 0 se un arco manca in quella direzione
+static int chain_weight(weighted_direct_graph _graph, const int* _chain, int _len, int _step, int _metric) {
+    int total = 0;
+    int start = (_step > 0) ? 0 : _len - 1;
+    for (int k = start; k + _step >= 0 && k + _step < _len; k += _step) {
+        int weight = edge_weight_metric(_graph, _chain[k], _chain[k + _step], _metric);
+        if (weight <= 0) return 0;
+        total += weight;
+    }
+    return total;
+}
+
+// Funzione di utilità che cerca la scorciatoia _src -> _dst già creata (-1 se assente)
+static int find_shortcut(const struct _contraction* _contraction, int _src, int _dst) {
+    for (int s = _contraction->first[_src]; s != -1; s = _contraction->shortcuts[s].next) {
+        if (_contraction->shortcuts[s].dst == _dst) return s;
+    }
+    return -1;
+}
+
+/*
+ * Funzione di utilità che verifica se la catena può essere percorsa da un estremo
+ * all'altro senza introdurre ambiguità: se esiste già un arco (o una scorciatoia)
+ * tra gli estremi deve essere non più pesante della catena in ogni metrica, altrimenti
+ * la catena resta nel grafo. Restituisce 1 se serve una scorciatoia (con i pesi in
+ * _weights_out), 0 se non serve, -1 se la catena non può essere contratta.
+ */
+static int chain_shortcut_weight(weighted_direct_graph _graph, const struct _contraction* _contraction,
+                                 const int* _chain, int _len, int _step, int* _weights_out) {
+    int src = (_step > 0) ? _chain[0] : _chain[_len - 1];
+    int dst = (_step > 0) ? _chain[_len - 1] : _chain[0];
+    if (src == dst) return 0;
+
+    // Tutte le metriche condividono la topologia: basta la principale per sapere se la catena è percorribile
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        _weights_out[m] = chain_weight(_graph, _chain, _len, _step, m);
+        if (_weights_out[m] == 0) return 0;
+    }
+
+    int existing[WDG_MAX_METRICS];
+    bool found = edge_weight(_graph, src, dst) > 0;
+    if (found) {
+        for (int m = 0; m < _graph->num_metrics; m++) {
+            existing[m] = edge_weight_metric(_graph, src, dst, m);
+        }
+    } else {
+        int s = find_shortcut(_contraction, src, dst);
+        found = s >= 0;
+        for (int m = 0; found && m < _graph->num_metrics; m++) {
+            existing[m] = _contraction->shortcuts[s].weight[m];
+        }
+    }
+    if (!found) return 1;
+
+    for (int m = 0; m < _graph->num_metrics; m++) {
+        if (existing[m] > _weights_out[m]) return -1;
+    }
+    return 0;
+}
+
+// Funzione di utilità che aggiunge la scorciatoia per la catena nella direzione _step
+static int add_chain_shortcut(struct _contraction* _contraction, const int* _chain, int _len, int _step,
+                              const int* _weights, int _num_metrics, int* _shortcut_capacity, int* _via_capacity) {
+    if (_contraction->num_shortcuts == *_shortcut_capacity) {
+        int new_capacity = (*_shortcut_capacity == 0) ? INITIAL_CAPACITY : *_shortcut_capacity * GROWTH_FACTOR;
+        struct _shortcut* new_shortcuts = (struct _shortcut*)realloc(_contraction->shortcuts, new_capacity * sizeof(struct _shortcut));
+        if (new_shortcuts == NULL) return WDG_ERROR_MEMORY;
+        _contraction->shortcuts = new_shortcuts;
+        *_shortcut_capacity = new_capacity;
+    }
+
+    int via_start = _contraction->num_via;
+    while (via_start + _len - 2 > *_via_capacity) {
+        int new_capacity = (*_via_capacity == 0) ? INITIAL_CAPACITY : *_via_capacity * GROWTH_FACTOR;
+        int* new_via = (int*)realloc(_contraction->via, new_capacity * sizeof(int));
+        if (new_via == NULL) return WDG_ERROR_MEMORY;
+        _contraction->via = new_via;
+        *_via_capacity = new_capacity;
+    }
+
+    int src = (_step > 0) ? _chain[0] : _chain[_len - 1];
+    struct _shortcut* shortcut = &_contraction->shortcuts[_contraction->num_shortcuts];
+    shortcut->src = src;
+    shortcut->dst = (_step > 0) ? _chain[_len - 1] : _chain[0];
+    for (int m = 0; m < _num_metrics; m++) {
+        shortcut->weight[m] = _weights[m];
+    }
+    shortcut->via_start = via_start;
+    shortcut->via_len = _len - 2;
+    shortcut->next = _contraction->first[src];
+    for (int k = 0; k < _len - 2; k++) {
+        _contraction->via[via_start + k] = (_step > 0) ? _chain[1 + k] : _chain[_len - 2 - k];
+    }
+    _contraction->first[src] = _contraction->num_shortcuts++;
+    _contraction->num_via += _len - 2;
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_contract_chains(weighted_direct_graph _graph,
+                                          bool (*_is_terminal)(weighted_direct_graph_node_id, void*),
+                                          void* _context) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    drop_contraction(_graph);
+
+    int n = _graph->size;
+    struct _contraction* contraction = (struct _contraction*)calloc(1, sizeof(struct _contraction));
+    int* neighbors = (int*)malloc((2 * n + 1) * sizeof(int));
+    int* count = (int*)calloc(n + 1, sizeof(int));
+    bool* candidate = (bool*)calloc(n + 1, sizeof(bool));
+    int* chain = (int*)malloc((n + 2) * sizeof(int));
+    if (contraction != NULL) {
+        contraction->contracted = (bool*)calloc(n + 1, sizeof(bool));
+        contraction->first = (int*)malloc((n + 1) * sizeof(int));
+    }
+    if (contraction == NULL || contraction->contracted == NULL || contraction->first == NULL ||
+        neighbors == NULL || count == NULL || candidate == NULL || chain == NULL) {
+        free_contraction(contraction);
+        free(neighbors);
+        free(count);
+        free(candidate);
+        free(chain);
+        return WDG_ERROR_MEMORY;
+    }
+
+    // Vicini non orientati di ogni nodo, sufficienti a riconoscere i nodi di grado due
+    for (int i = 0; i < n; i++) {
+        contraction->first[i] = -1;
+        edge_cursor cursor;
+        int target, weight;
+        edge_cursor_open(_graph, i, &cursor);
+        while (edge_cursor_next(&cursor, &target, &weight)) {
+            add_chain_neighbor(neighbors, count, i, target);
+            add_chain_neighbor(neighbors, count, target, i);
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        bool terminal = _is_terminal != NULL && _is_terminal(_graph->to_external[i], _context);
+        candidate[i] = count[i] == 2 && !terminal;
+    }
+
+    int shortcut_capacity = 0, via_capacity = 0;
+    int result = WDG_SUCCESS;
+    for (int v = 0; v < n && result == WDG_SUCCESS; v++) {
+        if (!candidate[v]) continue;
+
+        // Percorre la catena verso entrambi i lati fino agli estremi non contraibili;
+        // i nodi attraversati non vengono più considerati come punto di partenza
+        candidate[v] = false;
+        int len = 0;
+        int prev = v, current = neighbors[v * 2];
+        while (candidate[current]) {
+            candidate[current] = false;
+            chain[len++] = current;
+            int next = (neighbors[current * 2] == prev) ? neighbors[current * 2 + 1] : neighbors[current * 2];
+            prev = current;
+            current = next;
+        }
+
+        // Un anello di soli nodi di passaggio non ha estremi: resta nel grafo
+        if (current == v) continue;
+
+        // Il lato sinistro è stato raccolto allontanandosi da v: lo rovescia e antepone l'estremo
+        for (int a = 0, b = len - 1; a < b; a++, b--) {
+            int tmp = chain[a];
+            chain[a] = chain[b];
+            chain[b] = tmp;
+        }
+        memmove(&chain[1], &chain[0], len * sizeof(int));
+        chain[0] = current;
+        len++;
+        chain[len++] = v;
+
+        prev = v;
+        current = neighbors[v * 2 + 1];
+        while (candidate[current]) {
+            candidate[current] = false;
+            chain[len++] = current;
+            int next = (neighbors[current * 2] == prev) ? neighbors[current * 2 + 1] : neighbors[current * 2];
+            prev = current;
+            current = next;
+        }
+        chain[len++] = current;
+
+        int forward_weights[WDG_MAX_METRICS], backward_weights[WDG_MAX_METRICS];
+        int forward = chain_shortcut_weight(_graph, contraction, chain, len, 1, forward_weights);
+        int backward = chain_shortcut_weight(_graph, contraction, chain, len, -1, backward_weights);
+        if (forward < 0 || backward < 0) continue;
+
+        if (forward > 0) {
+            result = add_chain_shortcut(contraction, chain, len, 1, forward_weights, _graph->num_metrics,
+                                        &shortcut_capacity, &via_capacity);
+        }
+        if (backward > 0 && result == WDG_SUCCESS) {
+            result = add_chain_shortcut(contraction, chain, len, -1, backward_weights, _graph->num_metrics,
+                                        &shortcut_capacity, &via_capacity);
+        }
+
+        for (int k = 1; k < len - 1; k++) {
+            contraction->contracted[chain[k]] = true;
+            contraction->num_contracted++;
+        }
+    }
+
+    free(neighbors);
+    free(count);
+    free(candidate);
+    free(chain);
+
+    if (result != WDG_SUCCESS) {
+        free_contraction(contraction);
+        return result;
+    }
+    _graph->contraction = contraction;
+    return WDG_SUCCESS;
+}
+
+void weighted_direct_graph_clear_contraction(weighted_direct_graph _graph) {
+    if (_graph == NULL) return;
+    drop_contraction(_graph);
+}
+
+int weighted_direct_graph_contracted_count(weighted_direct_graph _graph) {
+    if (_graph == NULL) return WDG_ERROR_NULL;
+    return (_graph->contraction != NULL) ? _graph->contraction->num_contracted : 0;
+}
+
+int weighted_direct_graph_add_edges_bulk(weighted_direct_graph _graph, const weighted_direct_graph_node_id* _src,
+                                         const weighted_direct_graph_node_id* _dst, const int* _weights, int _count) {
+    if (_graph == NULL || (_count > 0 && (_src == NULL || _dst == NULL || _weights == NULL))) return WDG_ERROR_NULL;
+    if (_count < 0) return WDG_ERROR_INVALID_ID;
+    if (_graph->compressed != NULL) return WDG_ERROR_READ_ONLY;
+    if (_count == 0) return WDG_SUCCESS;
+
+    // Verifica tutti gli archi prima di modificare il grafo
+    for (int i = 0; i < _count; i++) {
+        if (!valid_id(_graph, _src[i]) || !valid_id(_graph, _dst[i]) || _weights[i] <= 0) return WDG_ERROR_INVALID_ID;
+    }
+
+    int n = _graph->size;
+    int* rows = (int*)malloc(_count * sizeof(int));
+    int* columns = (int*)malloc(_count * sizeof(int));
+    int* perm = (int*)malloc(_count * sizeof(int));
+    int* tmp = (int*)malloc(_count * sizeof(int));
+    int* buckets = (int*)malloc((n + 1) * sizeof(int));
+    if (rows == NULL || columns == NULL || perm == NULL || tmp == NULL || buckets == NULL) {
+        free(rows);
+        free(columns);
+        free(perm);
+        free(tmp);
+        free(buckets);
+        return WDG_ERROR_MEMORY;
+    }
+
+    for (int i = 0; i < _count; i++) {
+        rows[i] = _graph->to_internal[_src[i]];
+        columns[i] = _graph->to_internal[_dst[i]];
+        perm[i] = i;
+    }
+
+    // Ordinamento radix (destinazione, poi sorgente): essendo stabile, a parità di
+    // coppia l'ultimo arco in ingresso resta in fondo al gruppo e vince
+    counting_sort_pass(columns, perm, tmp, _count, buckets, n);
+    counting_sort_pass(rows, perm, tmp, _count, buckets, n);
+
+    // Rende private le righe da scrivere prima di modificarne una, così un errore
+    // di allocazione lascia il grafo invariato
+    for (int i = 0; i < _count; i++) {
+        if ((i > 0 && rows[perm[i]] == rows[perm[i - 1]]) || unshare_row(_graph, rows[perm[i]]) == WDG_SUCCESS) continue;
+        free(rows);
+        free(columns);
+        free(perm);
+        free(tmp);
+        free(buckets);
+        return WDG_ERROR_MEMORY;
+    }
+
+    drop_contraction(_graph);
+
+    // Scrittura riga per riga: gli estremi non nulli si aggiornano una volta per riga
+    int i = 0;
+    while (i < _count) {
+        int row = rows[perm[i]];
+        int first = columns[perm[i]];
+        int last = first;
+        for (; i < _count && rows[perm[i]] == row; i++) {
+            bool last_of_pair = (i + 1 == _count) || rows[perm[i + 1]] != row || columns[perm[i + 1]] != columns[perm[i]];
+            if (!last_of_pair) continue;
+            for (int m = 0; m < _graph->num_metrics; m++) {
+                _graph->weight_matrix[m][row][columns[perm[i]]] = _weights[perm[i]];
+            }
+            last = columns[perm[i]];
+        }
+        if (first < _graph->row_first[row]) _graph->row_first[row] = first;
+        if (last > _graph->row_last[row]) _graph->row_last[row] = last;
+    }
+
+    free(rows);
+    free(columns);
+    free(perm);
+    free(tmp);
+    free(buckets);
+    return WDG_SUCCESS;
+}
+
+weighted_direct_graph_mask weighted_direct_graph_mask_create() {
+    weighted_direct_graph_mask mask = (weighted_direct_graph_mask)calloc(1, sizeof(struct _weighted_direct_graph_mask));
+    return mask;
+}
+
+void weighted_direct_graph_mask_destroy(weighted_direct_graph_mask* _mask) {
+    if (_mask == NULL || *_mask == NULL) return;
+    free((*_mask)->closed_nodes);
+    free((*_mask)->closed_sources);
+    free((*_mask)->closed_edges);
+    free(*_mask);
+    *_mask = NULL;
+}
+
+// Funzione di utilità per garantire che i bitset coprano l'id _node
+static int mask_ensure_words(weighted_direct_graph_mask _mask, int _node) {
+    int required = _node / 64 + 1;
+    if (required <= _mask->num_words) return WDG_SUCCESS;
+
+    int new_words = (_mask->num_words == 0) ? 1 : _mask->num_words;
+    while (new_words < required) {
+        new_words *= GROWTH_FACTOR;
+    }
+
+    uint64_t* nodes = (uint64_t*)realloc(_mask->closed_nodes, new_words * sizeof(uint64_t));
+    if (nodes == NULL) return WDG_ERROR_MEMORY;
+    _mask->closed_nodes = nodes;
+    uint64_t* sources = (uint64_t*)realloc(_mask->closed_sources, new_words * sizeof(uint64_t));
+    if (sources == NULL) return WDG_ERROR_MEMORY;
+    _mask->closed_sources = sources;
+
+    memset(nodes + _mask->num_words, 0, (new_words - _mask->num_words) * sizeof(uint64_t));
+    memset(sources + _mask->num_words, 0, (new_words - _mask->num_words) * sizeof(uint64_t));
+    _mask->num_words = new_words;
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_mask_close_node(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _node) {
+    if (_mask == NULL) return WDG_ERROR_NULL;
+    if (_node < 0) return WDG_ERROR_INVALID_ID;
+    if (mask_ensure_words(_mask, _node) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+
+    _mask->closed_nodes[_node / 64] |= (uint64_t)1 << (_node % 64);
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_mask_open_node(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _node) {
+    if (_mask == NULL) return WDG_ERROR_NULL;
+    if (_node < 0) return WDG_ERROR_INVALID_ID;
+
+    if (_node / 64 < _mask->num_words) {
+        _mask->closed_nodes[_node / 64] &= ~((uint64_t)1 << (_node % 64));
+    }
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_mask_close_edge(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
+    if (_mask == NULL) return WDG_ERROR_NULL;
+    if (_src < 0 || _dst < 0) return WDG_ERROR_INVALID_ID;
+    if (mask_ensure_words(_mask, _src) != WDG_SUCCESS) return WDG_ERROR_MEMORY;
+
+    uint64_t key = edge_key(_src, _dst);
+    int pos = mask_lower_bound(_mask, key);
+    if (pos < _mask->num_edges && _mask->closed_edges[pos] == key) return WDG_SUCCESS;
+
+    if (_mask->num_edges == _mask->edge_capacity) {
+        int new_capacity = (_mask->edge_capacity == 0) ? INITIAL_CAPACITY : _mask->edge_capacity * GROWTH_FACTOR;
+        uint64_t* new_edges = (uint64_t*)realloc(_mask->closed_edges, new_capacity * sizeof(uint64_t));
+        if (new_edges == NULL) return WDG_ERROR_MEMORY;
+        _mask->closed_edges = new_edges;
+        _mask->edge_capacity = new_capacity;
+    }
+
+    memmove(&_mask->closed_edges[pos + 1], &_mask->closed_edges[pos], (_mask->num_edges - pos) * sizeof(uint64_t));
+    _mask->closed_edges[pos] = key;
+    _mask->num_edges++;
+    _mask->closed_sources[_src / 64] |= (uint64_t)1 << (_src % 64);
+    return WDG_SUCCESS;
+}
+
+int weighted_direct_graph_mask_open_edge(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst) {
+    if (_mask == NULL) return WDG_ERROR_NULL;
+    if (_src < 0 || _dst < 0) return WDG_ERROR_INVALID_ID;
+
+    uint64_t key = edge_key(_src, _dst);
+    int pos = mask_lower_bound(_mask, key);
+    if (pos >= _mask->num_edges || _mask->closed_edges[pos] != key) return WDG_SUCCESS;
+
+    memmove(&_mask->closed_edges[pos], &_mask->closed_edges[pos + 1], (_mask->num_edges - pos - 1) * sizeof(uint64_t));
+    _mask->num_edges--;
+
+    // Le chiavi con la stessa sorgente sono contigue: se non ne restano, la sorgente torna libera
+    bool same_before = pos > 0 && (_mask->closed_edges[pos - 1] >> 32) == (uint64_t)_src;
+    bool same_after = pos < _mask->num_edges && (_mask->closed_edges[pos] >> 32) == (uint64_t)_src;
+    if (!same_before && !same_after) {
+        _mask->closed_sources[_src / 64] &= ~((uint64_t)1 << (_src % 64));
+    }
+    return WDG_SUCCESS;
+}
+
+void weighted_direct_graph_mask_clear(weighted_direct_graph_mask _mask) {
+    if (_mask == NULL) return;
+    if (_mask->num_words > 0) {
+        memset(_mask->closed_nodes, 0, _mask->num_words * sizeof(uint64_t));
+        memset(_mask->closed_sources, 0, _mask->num_words * sizeof(uint64_t));
+    }
+    _mask->num_edges = 0;
+}
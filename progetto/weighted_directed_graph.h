@@ -5,8 +5,32 @@
  * dei pesi. I nodi sono identificati da interi (0, 1, ..., n-1). Il grafo consente
  * operazioni di inserimento nodi, gestione degli archi pesati, interrogazione dei vicini,
  * calcolo del percorso e delle visite (DFS, BFS).
+ *
+ * Gli identificativi restituiti da weighted_direct_graph_add_node restano stabili
+ * per tutta la vita del grafo, anche quando la disposizione interna dei nodi viene
+ * permutata da weighted_direct_graph_reorder per migliorare la località delle visite.
+ *
+ * Un grafo già costruito può essere convertito in una rappresentazione compressa di
+ * sola lettura (weighted_direct_graph_set_storage), che occupa memoria proporzionale
+ * al numero di archi e resta utilizzabile da tutte le visite e i calcoli dei percorsi.
+ *
+ * Ogni arco può portare fino a WDG_MAX_METRICS pesi (ad esempio tempo, distanza, costo).
+ * La metrica 0 è quella principale, usata da tutte le funzioni che non indicano una
+ * metrica; per ogni metrica il peso è positivo se e solo se l'arco esiste.
+ *
+ * Le chiusure temporanee (strade o nodi non percorribili) si esprimono con una maschera
+ * (weighted_direct_graph_mask) passata alle varianti _masked delle ricerche, senza
+ * modificare il grafo: più maschere possono essere usate in parallelo sullo stesso grafo.
+ *
+ * weighted_direct_graph_clone crea una copia indipendente in tempo lineare nel numero di
+ * nodi: le righe delle matrici vengono copiate solo quando uno dei due grafi le modifica.
+ * I nodi (id, valore, dati e puntatori Node) sono invece condivisi tra il grafo e i suoi
+ * cloni, ed è la base delle versioni pubblicate da versioned_graph.
  */
 
+#ifndef WEIGHTED_DIRECT_GRAPH_H
+#define WEIGHTED_DIRECT_GRAPH_H
+
 #include <stdlib.h>
 #include <stdbool.h>
 #include "linked_list.h"
@@ -14,12 +38,29 @@
 typedef struct _weighted_direct_graph* weighted_direct_graph;
 typedef int weighted_direct_graph_node_id;
 typedef struct _weighted_direct_graph_node* Node;
+typedef struct _weighted_direct_graph_mask* weighted_direct_graph_mask;
 
 // Codici di ritorno
 #define WDG_SUCCESS 0                // Operazione completata correttamente
 #define WDG_ERROR_NULL -1            // Puntatore NULL passato come parametro
 #define WDG_ERROR_INVALID_ID -2      // Identificatore di nodo fuori range
 #define WDG_ERROR_MEMORY -3          // Errore di allocazione o capacità superata
+#define WDG_ERROR_READ_ONLY -4       // Modifica richiesta su un grafo in rappresentazione compressa
+
+#define WDG_MAX_METRICS 4            // Numero massimo di pesi (metriche) per arco
+
+// Ordinamenti interni dei nodi supportati da weighted_direct_graph_reorder
+typedef enum {
+    WDG_ORDER_CREATION = 0,          // Ordine di creazione (disposizione iniziale)
+    WDG_ORDER_BFS = 1,               // Ordine di visita in ampiezza
+    WDG_ORDER_RCM = 2                // Reverse Cuthill-McKee (minimizza la banda della matrice)
+} weighted_direct_graph_order;
+
+// Rappresentazioni interne degli archi supportate da weighted_direct_graph_set_storage
+typedef enum {
+    WDG_STORAGE_MATRIX = 0,          // Matrice di adiacenza (modificabile)
+    WDG_STORAGE_COMPRESSED = 1       // Liste compresse con differenze varint (sola lettura)
+} weighted_direct_graph_storage;
 
 /*
  * Crea un nuovo grafo orientato pesato vuoto.
@@ -34,6 +75,20 @@ weighted_direct_graph weighted_direct_graph_create();
  */
 void weighted_direct_graph_destroy(weighted_direct_graph* _graph);
 
+/*
+ * Crea un clone del grafo. Archi, metriche, rappresentazione e contrazione sono copiati
+ * (le righe delle matrici sono condivise fino alla prima modifica), mentre i nodi sono
+ * condivisi: valore, dati e puntatori Node sono gli stessi nei due grafi, e i dati dei
+ * nodi vengono liberati solo alla distruzione dell'ultimo grafo che li condivide.
+ * Gli id dei nodi seguono un'unica sequenza: dopo la clonazione può aggiungere nodi solo
+ * il grafo che per primo ne aggiunge (l'altro riceve WDG_ERROR_READ_ONLY), finché il primo
+ * non viene distrutto. Clonare o modificare cloni dello stesso grafo da più thread
+ * richiede una sincronizzazione esterna; leggere un grafo mentre si modifica un suo clone no.
+ * @param _graph Grafo da clonare.
+ * @return Il clone, oppure NULL se _graph è NULL o fallisce l'allocazione della memoria.
+ */
+weighted_direct_graph weighted_direct_graph_clone(weighted_direct_graph _graph);
+
 /*
  * Aggiunge un nuovo nodo al grafo.
  * @param _graph Grafo su cui operare.
@@ -41,10 +96,24 @@ void weighted_direct_graph_destroy(weighted_direct_graph* _graph);
  * @param _data Dati aggiuntivi da associare al nodo (può essere NULL).
  * @return Identificativo del nodo appena creato (>= 0),
  *         oppure WDG_ERROR_NULL se _graph è NULL,
+ *         oppure WDG_ERROR_READ_ONLY se il grafo è compresso o un suo clone ha già aggiunto nodi,
  *         oppure WDG_ERROR_MEMORY se si raggiunge la capacità massima.
  */
 weighted_direct_graph_node_id weighted_direct_graph_add_node(weighted_direct_graph _graph, int _value, void* _data);
 
+/*
+ * Aggiunge _count nodi al grafo con un'unica espansione della capacità. I nodi hanno
+ * valore 0, nessun dato associato e identificativi consecutivi.
+ * @param _graph Grafo su cui operare.
+ * @param _count Numero di nodi da aggiungere (> 0).
+ * @return Identificativo del primo nodo creato (i successivi seguono in ordine),
+ *         oppure WDG_ERROR_NULL se _graph è NULL,
+ *         oppure WDG_ERROR_INVALID_ID se _count non è positivo,
+ *         oppure WDG_ERROR_READ_ONLY se il grafo è compresso o un suo clone ha già aggiunto nodi,
+ *         oppure WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+weighted_direct_graph_node_id weighted_direct_graph_add_nodes(weighted_direct_graph _graph, int _count);
+
 /*
  * Restituisce il valore associato a un nodo.
  * @param _graph Grafo da interrogare.
@@ -99,10 +168,31 @@ weighted_direct_graph_node_id weighted_direct_graph_get_node_id(Node _node);
  * @param _weight Peso dell'arco.
  * @return WDG_SUCCESS se inserito,
  *         WDG_ERROR_NULL se _graph è NULL,
- *         WDG_ERROR_INVALID_ID se _src o _dst non sono nodi validi.
+ *         WDG_ERROR_INVALID_ID se _src o _dst non sono nodi validi,
+ *         WDG_ERROR_READ_ONLY se il grafo è compresso,
+ *         WDG_ERROR_MEMORY se fallisce la copia di una riga condivisa con un clone.
  */
 int weighted_direct_graph_add_edge(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _weight);
 
+/*
+ * Aggiunge un insieme di archi in un'unica operazione. Gli archi vengono ordinati per
+ * (sorgente, destinazione) con un ordinamento radix e scritti riga per riga; se la stessa
+ * coppia compare più volte vale l'ultima occorrenza, come con chiamate successive a
+ * weighted_direct_graph_add_edge. Se un arco non è valido il grafo non viene modificato.
+ * @param _graph Grafo su cui operare.
+ * @param _src Nodi sorgente degli archi.
+ * @param _dst Nodi destinazione degli archi.
+ * @param _weights Pesi degli archi (positivi).
+ * @param _count Numero di archi.
+ * @return WDG_SUCCESS se tutti gli archi sono stati inseriti,
+ *         WDG_ERROR_NULL se _graph o uno degli array è NULL,
+ *         WDG_ERROR_INVALID_ID se un nodo non è valido o un peso non è positivo,
+ *         WDG_ERROR_READ_ONLY se il grafo è compresso,
+ *         WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_add_edges_bulk(weighted_direct_graph _graph, const weighted_direct_graph_node_id* _src,
+                                         const weighted_direct_graph_node_id* _dst, const int* _weights, int _count);
+
 /*
  * Restituisce il peso dell'arco da _src a _dst.
  * @param _graph Grafo da interrogare.
@@ -123,10 +213,59 @@ int weighted_direct_graph_get_edge_weight(weighted_direct_graph _graph, weighted
  * @param _dst Nodo destinazione.
  * @return WDG_SUCCESS se rimosso correttamente,
  *         WDG_ERROR_NULL se _graph è NULL,
- *         WDG_ERROR_INVALID_ID se _src o _dst non sono validi.
+ *         WDG_ERROR_INVALID_ID se _src o _dst non sono validi,
+ *         WDG_ERROR_READ_ONLY se il grafo è compresso,
+ *         WDG_ERROR_MEMORY se fallisce la copia di una riga condivisa con un clone.
  */
 int weighted_direct_graph_remove_edge(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst);
 
+/*
+ * Aggiunge una nuova metrica agli archi. I pesi iniziali della nuova metrica sono
+ * copiati da quelli della metrica principale; weighted_direct_graph_add_edge imposta
+ * lo stesso peso su tutte le metriche.
+ * @param _graph Grafo su cui operare.
+ * @return Identificativo della nuova metrica (>= 1),
+ *         oppure WDG_ERROR_NULL se _graph è NULL,
+ *         oppure WDG_ERROR_READ_ONLY se il grafo è compresso,
+ *         oppure WDG_ERROR_MEMORY se si è raggiunto WDG_MAX_METRICS o fallisce l'allocazione.
+ */
+int weighted_direct_graph_add_metric(weighted_direct_graph _graph);
+
+/*
+ * Restituisce il numero di metriche definite sugli archi.
+ * @param _graph Grafo da interrogare.
+ * @return Numero di metriche (almeno 1), oppure WDG_ERROR_NULL se _graph è NULL.
+ */
+int weighted_direct_graph_num_metrics(weighted_direct_graph _graph);
+
+/*
+ * Imposta il peso di un arco esistente in una sola metrica.
+ * @param _graph Grafo su cui operare.
+ * @param _src Nodo sorgente.
+ * @param _dst Nodo destinazione.
+ * @param _metric Metrica da modificare.
+ * @param _weight Nuovo peso (positivo).
+ * @return WDG_SUCCESS se il peso è stato impostato,
+ *         WDG_ERROR_NULL se _graph è NULL,
+ *         WDG_ERROR_INVALID_ID se i nodi, la metrica o il peso non sono validi o l'arco non esiste,
+ *         WDG_ERROR_READ_ONLY se il grafo è compresso,
+ *         WDG_ERROR_MEMORY se fallisce la copia di una riga condivisa con un clone.
+ */
+int weighted_direct_graph_set_edge_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, int _weight);
+
+/*
+ * Restituisce il peso di un arco in una metrica.
+ * @param _graph Grafo da interrogare.
+ * @param _src Nodo sorgente.
+ * @param _dst Nodo destinazione.
+ * @param _metric Metrica da leggere.
+ * @param _weight_out Puntatore dove salvare il peso (0 se l'arco non esiste).
+ * @return 1 se l'arco esiste, 0 se non esiste,
+ *         WDG_ERROR_NULL se _graph o _weight_out sono NULL,
+ *         WDG_ERROR_INVALID_ID se i nodi o la metrica non sono validi.
+ */
+int weighted_direct_graph_get_edge_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, int* _weight_out);
+
 /*
  * Restituisce il numero di nodi presenti nel grafo.
  * @param _graph Grafo da interrogare.
@@ -230,3 +369,195 @@ linked_list weighted_direct_graph_shortest_path(weighted_direct_graph _graph, we
  *         WDG_ERROR_INVALID_ID se _src o _dst sono invalidi.
  */
 int weighted_direct_graph_shortest_path_weight(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int* _weight_out);
+
+/*
+ * Calcola il percorso minimo tra due nodi secondo la metrica indicata.
+ * La ricerca legge soltanto i pesi della metrica scelta.
+ * @param _graph Grafo su cui operare.
+ * @param _src Nodo di partenza.
+ * @param _dst Nodo di arrivo.
+ * @param _metric Metrica da minimizzare.
+ * @return Lista dei nodi del percorso, oppure NULL se non esiste o i parametri non sono validi.
+ */
+linked_list weighted_direct_graph_shortest_path_by_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric);
+
+/*
+ * Calcola il peso del percorso minimo tra due nodi secondo la metrica indicata.
+ * @param _graph Grafo su cui operare.
+ * @param _src Nodo di partenza.
+ * @param _dst Nodo di arrivo.
+ * @param _metric Metrica da minimizzare.
+ * @param _weight_out Puntatore dove salvare il peso minimo.
+ * @return WDG_SUCCESS se il percorso esiste,
+ *         WDG_ERROR_NULL se _graph o _weight_out sono NULL,
+ *         WDG_ERROR_INVALID_ID se i parametri non sono validi o la destinazione non è raggiungibile,
+ *         WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_shortest_path_weight_by_metric(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, int* _weight_out);
+
+/*
+ * Assegna un insieme di viaggi alla rete tenendo conto della congestione (equilibrio
+ * dell'utente, algoritmo di Frank-Wolfe). Il tempo di un arco cresce con il numero di
+ * viaggi che lo percorrono secondo la funzione BPR t0 * (1 + 0.15 * (viaggi / _capacity)^4),
+ * dove t0 è il peso della metrica principale. A ogni iterazione i tempi vengono ricalcolati
+ * dal flusso corrente e ogni origine calcola un solo albero di cammini minimi per tutte le
+ * sue destinazioni. I viaggi con la stessa origine e destinazione possono essere ripartiti
+ * su più percorsi, in proporzione alle quote di equilibrio. La contrazione delle catene
+ * non viene usata.
+ * @param _graph Grafo su cui operare.
+ * @param _src Nodi di partenza dei viaggi.
+ * @param _dst Nodi di arrivo dei viaggi.
+ * @param _count Numero di viaggi.
+ * @param _capacity Viaggi che un arco assorbe prima di rallentare sensibilmente (> 0).
+ * @param _max_iterations Numero massimo di iterazioni (>= 1; con 1 ogni viaggio segue il cammino minimo a rete scarica).
+ * @param _paths_out Array di _count liste dove salvare il percorso di ogni viaggio
+ *        (NULL se la destinazione non è raggiungibile); le liste vanno distrutte dal chiamante.
+ * @return WDG_SUCCESS se l'assegnazione è avvenuta,
+ *         WDG_ERROR_NULL se _graph o uno degli array è NULL,
+ *         WDG_ERROR_INVALID_ID se un nodo o un parametro non è valido,
+ *         WDG_ERROR_MEMORY se fallisce l'allocazione della memoria (nessuna lista viene restituita).
+ */
+int weighted_direct_graph_assign_traffic(weighted_direct_graph _graph, const weighted_direct_graph_node_id* _src,
+                                         const weighted_direct_graph_node_id* _dst, int _count, int _capacity,
+                                         int _max_iterations, linked_list* _paths_out);
+
+/*
+ * Riordina la disposizione interna dei nodi in modo che nodi vicini nel grafo
+ * occupino righe e colonne vicine della matrice di adiacenza. Gli id esterni e i
+ * puntatori Node già distribuiti restano validi: cambia solo l'indicizzazione interna.
+ * @param _graph Grafo da riordinare.
+ * @param _order Ordinamento da applicare.
+ * @return WDG_SUCCESS se il riordino è avvenuto,
+ *         WDG_ERROR_NULL se _graph è NULL,
+ *         WDG_ERROR_INVALID_ID se _order non è valido,
+ *         WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_reorder(weighted_direct_graph _graph, weighted_direct_graph_order _order);
+
+/*
+ * Cambia la rappresentazione interna degli archi. Con WDG_STORAGE_COMPRESSED la matrice
+ * viene liberata e sostituita da liste di adiacenza compresse: il grafo diventa di sola
+ * lettura e ogni modifica (nodi, archi, riordino) restituisce WDG_ERROR_READ_ONLY finché
+ * non si torna a WDG_STORAGE_MATRIX. Conviene riordinare il grafo prima di comprimerlo,
+ * perché nodi vicini producono differenze più piccole.
+ * @param _graph Grafo da convertire.
+ * @param _storage Rappresentazione desiderata.
+ * @return WDG_SUCCESS se la conversione è avvenuta (o non era necessaria),
+ *         WDG_ERROR_NULL se _graph è NULL,
+ *         WDG_ERROR_INVALID_ID se _storage non è valido,
+ *         WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_set_storage(weighted_direct_graph _graph, weighted_direct_graph_storage _storage);
+
+/*
+ * Restituisce la rappresentazione interna corrente degli archi.
+ * @param _graph Grafo da interrogare.
+ * @return WDG_STORAGE_COMPRESSED se il grafo è compresso, WDG_STORAGE_MATRIX altrimenti
+ *         (anche se _graph è NULL).
+ */
+weighted_direct_graph_storage weighted_direct_graph_get_storage(weighted_direct_graph _graph);
+
+/*
+ * Contrae le catene di nodi di passaggio: ogni sequenza massimale di nodi non terminali
+ * con esattamente due vicini (considerando gli archi in entrambe le direzioni) viene
+ * sostituita, per il solo calcolo dei cammini minimi, da un arco scorciatoia tra i suoi
+ * estremi con peso pari alla somma dei pesi. I percorsi restituiti da
+ * weighted_direct_graph_shortest_path vengono riespansi, quindi contengono ancora tutti
+ * i nodi attraversati. Le visite (DFS, BFS, vicini, archi) continuano a vedere il grafo
+ * originale. Qualsiasi modifica del grafo annulla la contrazione.
+ * @param _graph Grafo da contrarre.
+ * @param _is_terminal Funzione che indica i nodi da non contrarre (origini e destinazioni
+ *        abituali); se NULL ogni nodo di grado due è contraibile.
+ * @param _context Puntatore passato invariato a _is_terminal.
+ * @return WDG_SUCCESS se la contrazione è avvenuta,
+ *         WDG_ERROR_NULL se _graph è NULL,
+ *         WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_contract_chains(weighted_direct_graph _graph,
+                                          bool (*_is_terminal)(weighted_direct_graph_node_id, void*),
+                                          void* _context);
+
+/*
+ * Annulla la contrazione delle catene, se presente.
+ * @param _graph Grafo da ripristinare.
+ */
+void weighted_direct_graph_clear_contraction(weighted_direct_graph _graph);
+
+/*
+ * Restituisce il numero di nodi esclusi dalla ricerca dei cammini minimi dalla contrazione.
+ * @param _graph Grafo da interrogare.
+ * @return Numero di nodi contratti (0 se il grafo non è contratto),
+ *         WDG_ERROR_NULL se _graph è NULL.
+ */
+int weighted_direct_graph_contracted_count(weighted_direct_graph _graph);
+
+/*
+ * Crea una maschera di chiusure vuota (nessun nodo o arco chiuso).
+ * @return Maschera creata, oppure NULL in caso di errore di allocazione.
+ */
+weighted_direct_graph_mask weighted_direct_graph_mask_create();
+
+/*
+ * Distrugge una maschera e libera la memoria.
+ * @param _mask Puntatore alla maschera; dopo la chiamata *_mask sarà NULL.
+ */
+void weighted_direct_graph_mask_destroy(weighted_direct_graph_mask* _mask);
+
+/*
+ * Chiude un nodo: le ricerche con questa maschera non lo attraversano e non lo
+ * accettano come partenza o arrivo.
+ * @param _mask Maschera su cui operare.
+ * @param _node Id del nodo da chiudere.
+ * @return WDG_SUCCESS, WDG_ERROR_NULL se _mask è NULL, WDG_ERROR_INVALID_ID se _node
+ *         è negativo, WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_mask_close_node(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _node);
+
+/*
+ * Riapre un nodo chiuso in precedenza.
+ * @param _mask Maschera su cui operare.
+ * @param _node Id del nodo da riaprire.
+ * @return WDG_SUCCESS, WDG_ERROR_NULL se _mask è NULL, WDG_ERROR_INVALID_ID se _node è negativo.
+ */
+int weighted_direct_graph_mask_open_node(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _node);
+
+/*
+ * Chiude l'arco _src -> _dst: le ricerche con questa maschera non lo percorrono.
+ * @param _mask Maschera su cui operare.
+ * @param _src Nodo sorgente.
+ * @param _dst Nodo destinazione.
+ * @return WDG_SUCCESS, WDG_ERROR_NULL se _mask è NULL, WDG_ERROR_INVALID_ID se un id
+ *         è negativo, WDG_ERROR_MEMORY se fallisce l'allocazione della memoria.
+ */
+int weighted_direct_graph_mask_close_edge(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst);
+
+/*
+ * Riapre l'arco _src -> _dst chiuso in precedenza.
+ * @param _mask Maschera su cui operare.
+ * @param _src Nodo sorgente.
+ * @param _dst Nodo destinazione.
+ * @return WDG_SUCCESS, WDG_ERROR_NULL se _mask è NULL, WDG_ERROR_INVALID_ID se un id è negativo.
+ */
+int weighted_direct_graph_mask_open_edge(weighted_direct_graph_mask _mask, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst);
+
+/*
+ * Riapre tutti i nodi e gli archi della maschera.
+ * @param _mask Maschera da svuotare.
+ */
+void weighted_direct_graph_mask_clear(weighted_direct_graph_mask _mask);
+
+/*
+ * Varianti delle visite e delle ricerche che rispettano una maschera di chiusure.
+ * Con _mask NULL si comportano come le funzioni corrispondenti senza maschera.
+ * Se il nodo di partenza (o di arrivo) è chiuso, le visite restituiscono una lista
+ * vuota e le ricerche si comportano come se il percorso non esistesse.
+ * Le ricerche con maschera non usano le scorciatoie della contrazione delle catene.
+ */
+linked_list weighted_direct_graph_dfs_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _start, weighted_direct_graph_mask _mask);
+linked_list weighted_direct_graph_bfs_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _start, weighted_direct_graph_mask _mask);
+int weighted_direct_graph_path_exists_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, weighted_direct_graph_mask _mask);
+linked_list weighted_direct_graph_get_path_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, weighted_direct_graph_mask _mask);
+linked_list weighted_direct_graph_shortest_path_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, weighted_direct_graph_mask _mask);
+int weighted_direct_graph_shortest_path_weight_masked(weighted_direct_graph _graph, weighted_direct_graph_node_id _src, weighted_direct_graph_node_id _dst, int _metric, weighted_direct_graph_mask _mask, int* _weight_out);
+
+#endif /* WEIGHTED_DIRECT_GRAPH_H */
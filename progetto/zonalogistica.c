@@ -3,7 +3,7 @@
 
 struct ZonaLogistica {
     int id;                 
-    char* nome;            
+    const char* nome;       // Non posseduto: internato dal gestore
     dynamic_array punti_consegna; 
 };
 
@@ -14,15 +14,10 @@ ZonaLogistica zona_logistica_create(int _id, const char* _nome) {
     if (zona == NULL) return NULL;
 
     zona->id = _id;
-    zona->nome = strdup(_nome);
-    if (zona->nome == NULL) {
-        free(zona);
-        return NULL;
-    }
+    zona->nome = _nome;
 
     zona->punti_consegna = dynamic_array_create(5, sizeof(void*));
     if (zona->punti_consegna == NULL) {
-        free(zona->nome);
         free(zona);
         return NULL;
     }
@@ -33,9 +28,6 @@ ZonaLogistica zona_logistica_create(int _id, const char* _nome) {
 void zona_logistica_destroy(ZonaLogistica* _zona) {
     if (_zona == NULL || *_zona == NULL) return;
 
-    // Libera il nome
-    free((*_zona)->nome);
-
     // Libera l'array dinamico dei punti di consegna
     // Nota: non liberiamo i punti di consegna stessi, poiché potrebbero essere
     // referenziati altrove (ad es. dal grafo)
@@ -51,7 +43,7 @@ int zona_logistica_get_id(ZonaLogistica _zona) {
     return _zona->id;
 }
 
-char* zona_logistica_get_nome(ZonaLogistica _zona) {
+const char* zona_logistica_get_nome(ZonaLogistica _zona) {
     if (_zona == NULL) return NULL;
     return _zona->nome;
 }
@@ -71,6 +63,19 @@ int zona_logistica_add_punto_consegna(ZonaLogistica _zona, void* _punto) {
     return dynamic_array_append(_zona->punti_consegna, &_punto);
 }
 
+int zona_logistica_add_punti_consegna(ZonaLogistica _zona, void** _punti, int _num_punti) {
+    if (_zona == NULL || _punti == NULL || _num_punti < 0) return -1;
+    
+    return dynamic_array_append_n(_zona->punti_consegna, _punti, _num_punti) == DYN_ARRAY_SUCCESS ? 0 : -1;
+}
+
+int zona_logistica_reserve_punti_consegna(ZonaLogistica _zona, int _num_punti) {
+    if (_zona == NULL || _num_punti < 0) return -1;
+    
+    int capacita = dynamic_array_size(_zona->punti_consegna) + _num_punti;
+    return dynamic_array_reserve(_zona->punti_consegna, capacita) == DYN_ARRAY_SUCCESS ? 0 : -1;
+}
+
 void* zona_logistica_get_punto_consegna(ZonaLogistica _zona, int _index) {
     if (_zona == NULL || _index < 0 || _index >= dynamic_array_size(_zona->punti_consegna)) {
         return NULL;
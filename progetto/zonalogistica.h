@@ -11,7 +11,7 @@ typedef struct ZonaLogistica* ZonaLogistica;
 /*
  * Crea una nuova zona logistica
  * @param _id Identificativo della zona logistica
- * @param _nome Nome della zona logistica
+ * @param _nome Nome della zona logistica (non viene copiato: deve restare valido per tutta la vita della zona)
  * @return Puntatore alla zona logistica creata, oppure NULL in caso di errore
  */
 ZonaLogistica zona_logistica_create(int _id, const char* _nome);
@@ -34,7 +34,7 @@ int zona_logistica_get_id(ZonaLogistica _zona);
  * @param _zona Zona logistica da cui leggere
  * @return Nome della zona logistica, oppure NULL se _zona è NULL
  */
-char* zona_logistica_get_nome(ZonaLogistica _zona);
+const char* zona_logistica_get_nome(ZonaLogistica _zona);
 
 /*
  * Aggiunge un punto di consegna alla zona logistica
@@ -44,6 +44,24 @@ char* zona_logistica_get_nome(ZonaLogistica _zona);
  */
 int zona_logistica_add_punto_consegna(ZonaLogistica _zona, void* _punto);
 
+/*
+ * Aggiunge in blocco punti di consegna appena creati, con un'unica copia e senza il
+ * controllo dei duplicati di zona_logistica_add_punto_consegna
+ * @param _zona Zona logistica in cui aggiungere
+ * @param _punti Array dei punti di consegna da aggiungere
+ * @param _num_punti Numero di punti da aggiungere
+ * @return 0 se aggiunti con successo, -1 altrimenti (nessun punto viene aggiunto)
+ */
+int zona_logistica_add_punti_consegna(ZonaLogistica _zona, void** _punti, int _num_punti);
+
+/*
+ * Riserva spazio per altri punti di consegna, così che i successivi inserimenti non falliscano
+ * @param _zona Zona logistica da espandere
+ * @param _num_punti Numero di punti che verranno aggiunti
+ * @return 0 se lo spazio è stato riservato, -1 altrimenti
+ */
+int zona_logistica_reserve_punti_consegna(ZonaLogistica _zona, int _num_punti);
+
 /*
  * Restituisce un punto di consegna dato il suo indice
  * @param _zona Zona logistica da cui leggere